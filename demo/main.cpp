@@ -1,6 +1,7 @@
 #include "../src/meshoptimizer.h"
 
 #include <assert.h>
+#include <float.h>
 #include <math.h>
 #include <stdio.h>
 #include <string.h>
@@ -464,6 +465,34 @@ void simplify(const Mesh& mesh, float threshold = 0.2f)
 	       (end - start) * 1000);
 }
 
+void simplifyAttr(const Mesh& mesh, float threshold = 0.2f)
+{
+	Mesh lod;
+
+	double start = timestamp();
+
+	size_t target_index_count = size_t(mesh.indices.size() * threshold);
+	float target_error = 1e-2f;
+	float result_error = 0;
+
+	// normals and texture coordinates are stored after positions in Vertex
+	const float attr_weights[5] = {0.01f, 0.01f, 0.01f, 0.01f, 0.01f};
+
+	lod.indices.resize(mesh.indices.size()); // note: simplify needs space for index_count elements in the destination array, not target_index_count
+	lod.indices.resize(meshopt_simplifyWithAttributes(&lod.indices[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), &mesh.vertices[0].nx, sizeof(Vertex), attr_weights, 5, NULL, target_index_count, target_error, &result_error));
+
+	lod.vertices.resize(lod.indices.size() < mesh.vertices.size() ? lod.indices.size() : mesh.vertices.size()); // note: this is just to reduce the cost of resize()
+	lod.vertices.resize(meshopt_optimizeVertexFetch(&lod.vertices[0], &lod.indices[0], lod.indices.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex)));
+
+	double end = timestamp();
+
+	printf("%-9s: %d triangles => %d triangles (%.2f%% deviation) in %.2f msec\n",
+	       "SimplifyA",
+	       int(mesh.indices.size() / 3), int(lod.indices.size() / 3),
+	       result_error * 100,
+	       (end - start) * 1000);
+}
+
 void simplifySloppy(const Mesh& mesh, float threshold = 0.2f)
 {
 	Mesh lod;
@@ -838,6 +867,9 @@ void meshlets(const Mesh& mesh, bool scan)
 	else
 		meshlets.resize(meshopt_buildMeshlets(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), max_vertices, max_triangles, cone_weight));
 
+	for (size_t i = 0; i < meshlets.size(); ++i)
+		meshopt_optimizeMeshlet(&meshlet_vertices[meshlets[i].vertex_offset], &meshlet_triangles[meshlets[i].triangle_offset], meshlets[i].triangle_count, meshlets[i].vertex_count);
+
 	if (meshlets.size())
 	{
 		const meshopt_Meshlet& last = meshlets.back();
@@ -948,6 +980,87 @@ void meshlets(const Mesh& mesh, bool scan)
 	       (endc - startc) * 1000);
 }
 
+static float boxSurfaceArea(const float box[6])
+{
+	float sx = box[3] - box[0], sy = box[4] - box[1], sz = box[5] - box[2];
+
+	return sx * sy + sy * sz + sz * sx;
+}
+
+void meshletsSpatial(const Mesh& mesh, bool spatial)
+{
+	const size_t max_vertices = 128;
+	const size_t min_triangles = 64;
+	const size_t max_triangles = 256;
+
+	// note: the bound for spatial clusters is larger than meshopt_buildMeshletsBound, so the same buffers work for both builders
+	double start = timestamp();
+	size_t max_meshlets = meshopt_buildMeshletsSpatialBound(mesh.indices.size(), max_vertices, min_triangles);
+	std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+	std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
+	std::vector<unsigned char> meshlet_triangles(max_meshlets * max_triangles * 3);
+	std::vector<float> meshlet_aabbs(max_meshlets * 6);
+
+	if (spatial)
+		meshlets.resize(meshopt_buildMeshletsSpatial(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &meshlet_aabbs[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), max_vertices, min_triangles, max_triangles));
+	else
+		meshlets.resize(meshopt_buildMeshlets(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), max_vertices, max_triangles, 0.f));
+
+	double end = timestamp();
+
+	float mesh_box[6] = {FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+	for (size_t i = 0; i < mesh.vertices.size(); ++i)
+	{
+		const float* p = &mesh.vertices[i].px;
+
+		for (int k = 0; k < 3; ++k)
+		{
+			mesh_box[k] = mesh_box[k] < p[k] ? mesh_box[k] : p[k];
+			mesh_box[k + 3] = mesh_box[k + 3] > p[k] ? mesh_box[k + 3] : p[k];
+		}
+	}
+
+	// with a two-level BVH, a ray that hits the mesh box hits a cluster box with probability proportional to its surface area
+	// expected triangle tests assume that triangles within a cluster are tested exhaustively, which is an upper bound for a cluster BVH
+	double cluster_hits = 0;
+	double triangle_tests = 0;
+	double avg_triangles = 0;
+
+	for (size_t i = 0; i < meshlets.size(); ++i)
+	{
+		const meshopt_Meshlet& m = meshlets[i];
+
+		float box[6] = {FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+		for (size_t j = 0; j < m.vertex_count; ++j)
+		{
+			const float* p = &mesh.vertices[meshlet_vertices[m.vertex_offset + j]].px;
+
+			for (int k = 0; k < 3; ++k)
+			{
+				box[k] = box[k] < p[k] ? box[k] : p[k];
+				box[k + 3] = box[k + 3] > p[k] ? box[k + 3] : p[k];
+			}
+		}
+
+		if (spatial)
+			assert(memcmp(box, &meshlet_aabbs[i * 6], sizeof(box)) == 0);
+
+		double probability = boxSurfaceArea(box) / boxSurfaceArea(mesh_box);
+
+		cluster_hits += probability;
+		triangle_tests += probability * m.triangle_count;
+		avg_triangles += m.triangle_count;
+	}
+
+	avg_triangles /= double(meshlets.size());
+
+	printf("Clusters%c: %d clusters (avg triangles %.1f); expected per ray: %.2f cluster hits, %.1f triangle tests in %.2f msec\n",
+	       spatial ? 'R' : ' ',
+	       int(meshlets.size()), avg_triangles, cluster_hits, triangle_tests, (end - start) * 1000);
+}
+
 void spatialSort(const Mesh& mesh)
 {
 	typedef PackedVertexOct PV;
@@ -1180,6 +1293,9 @@ void process(const char* path)
 	meshlets(copy, false);
 	meshlets(copy, true);
 
+	meshletsSpatial(copy, false);
+	meshletsSpatial(copy, true);
+
 	shadow(copy);
 	tessellationAdjacency(copy);
 
@@ -1196,6 +1312,7 @@ void process(const char* path)
 	encodeVertex<PackedVertexOct>(copy, "O");
 
 	simplify(mesh);
+	simplifyAttr(mesh);
 	simplifySloppy(mesh);
 	simplifyComplete(mesh);
 	simplifyPoints(mesh);
@@ -1,9 +1,11 @@
 #include "../src/meshoptimizer.h"
 
 #include <assert.h>
+#include <float.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
 #include <vector>
 
 // This file uses assert() to verify algorithm correctness
@@ -178,12 +180,18 @@ static void decodeIndexRejectInvalidVersion()
 	std::vector<unsigned char> buffer(meshopt_encodeIndexBufferBound(index_count, vertex_count));
 	buffer.resize(meshopt_encodeIndexBuffer(&buffer[0], buffer.size(), kIndexBuffer, index_count));
 
-	// check that decoder doesn't accept invalid version
-	std::vector<unsigned char> brokenbuffer(buffer);
-	brokenbuffer[0] |= 0x0f;
-
+	// check that decoders don't accept unknown versions; only 0, 1 and 2 are valid
 	unsigned int decoded[index_count];
-	assert(meshopt_decodeIndexBuffer(decoded, index_count, &brokenbuffer[0], brokenbuffer.size()) < 0);
+
+	for (int version = 3; version < 16; ++version)
+	{
+		std::vector<unsigned char> brokenbuffer(buffer);
+		brokenbuffer[0] = (unsigned char)(0xe0 | version);
+
+		assert(meshopt_decodeIndexBuffer(decoded, index_count, &brokenbuffer[0], brokenbuffer.size()) == -1);
+		assert(meshopt_decodeIndexBufferParallel(decoded, index_count, 4, &brokenbuffer[0], brokenbuffer.size(), NULL, NULL) == -1);
+		assert(meshopt_decodeIndexBufferRange(decoded, 0, index_count, index_count, 4, &brokenbuffer[0], brokenbuffer.size()) == -1);
+	}
 }
 
 static void decodeIndexMalformedVByte()
@@ -212,6 +220,211 @@ static void roundtripIndexTricky()
 	assert(memcmp(decoded, kIndexBufferTricky, sizeof(kIndexBufferTricky)) == 0);
 }
 
+static void roundtripIndexLarge()
+{
+	std::vector<unsigned int> indices;
+
+	// grid, which mostly hits edge and vertex fifos
+	for (unsigned int y = 0; y < 20; ++y)
+		for (unsigned int x = 0; x < 20; ++x)
+		{
+			unsigned int v = y * 21 + x;
+			unsigned int tri[6] = {v, v + 21, v + 1, v + 1, v + 21, v + 22};
+
+			indices.insert(indices.end(), tri, tri + 6);
+		}
+
+	// strip with backwards references, which hits last+-1 encoding
+	for (unsigned int i = 0; i < 300; ++i)
+	{
+		unsigned int tri[3] = {i + 2000, 4000 - i, i + 2001};
+
+		indices.insert(indices.end(), tri, tri + 3);
+	}
+
+	// reset followed by large indices, which need multi-byte varints
+	unsigned int reset[6] = {0, 1, 2, 100000, 3, 70000000};
+	indices.insert(indices.end(), reset, reset + 6);
+
+	// pseudo-random triangles
+	for (unsigned int i = 0; i < 100; ++i)
+	{
+		unsigned int v = (i * 7919) % 1000;
+		unsigned int tri[3] = {v, v + 1 + i % 7, v + 10 + i % 13};
+
+		indices.insert(indices.end(), tri, tri + 3);
+	}
+
+	for (int version = 0; version <= 2; ++version)
+	{
+		meshopt_encodeIndexVersion(version);
+
+		std::vector<unsigned char> buffer(meshopt_encodeIndexBufferBound(indices.size(), 70000001));
+		buffer.resize(meshopt_encodeIndexBuffer(&buffer[0], buffer.size(), &indices[0], indices.size()));
+
+		std::vector<unsigned int> decoded(indices.size() + 1, 0xcdcdcdcd);
+		assert(meshopt_decodeIndexBuffer(&decoded[0], indices.size(), &buffer[0], buffer.size()) == 0);
+		assert(decoded[indices.size()] == 0xcdcdcdcd);
+
+		// encoder is allowed to rotate triangles
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			const unsigned int* a = &indices[i];
+			const unsigned int* b = &decoded[i];
+
+			assert((a[0] == b[0] && a[1] == b[1] && a[2] == b[2]) || (a[0] == b[1] && a[1] == b[2] && a[2] == b[0]) || (a[0] == b[2] && a[1] == b[0] && a[2] == b[1]));
+			(void)a;
+			(void)b;
+		}
+
+		std::vector<unsigned short> decoded16(indices.size() + 1, 0xcdcd);
+		assert(meshopt_decodeIndexBuffer(&decoded16[0], indices.size(), &buffer[0], buffer.size()) == 0);
+		assert(decoded16[indices.size()] == 0xcdcd);
+
+		for (size_t i = 0; i < indices.size(); ++i)
+			assert(decoded16[i] == (unsigned short)(decoded[i]));
+	}
+
+	meshopt_encodeIndexVersion(0);
+}
+
+static void dispatchReverse(void* context, meshopt_JobCallback job, void* job_data, size_t job_count)
+{
+	// run jobs in reverse order to make sure the results don't depend on the order of execution
+	for (size_t i = job_count; i > 0; --i)
+		job(job_data, i - 1);
+
+	if (context)
+		++*static_cast<int*>(context);
+}
+
+static void encodeIndexV2()
+{
+	// 80000 triangles, which is enough for 5 chunks and 2 jobs
+	std::vector<unsigned int> indices;
+
+	for (unsigned int y = 0; y < 200; ++y)
+		for (unsigned int x = 0; x < 200; ++x)
+		{
+			unsigned int v = y * 201 + x;
+			unsigned int tri[6] = {v, v + 201, v + 1, v + 1, v + 201, v + 202};
+
+			indices.insert(indices.end(), tri, tri + 6);
+		}
+
+	size_t index_count = indices.size();
+
+	meshopt_encodeIndexVersion(2);
+
+	std::vector<unsigned char> buffer(meshopt_encodeIndexBufferBound(index_count, 201 * 201));
+	buffer.resize(meshopt_encodeIndexBuffer(&buffer[0], buffer.size(), &indices[0], index_count));
+	assert(buffer[0] == 0xe2);
+
+	// parallel encoding must produce identical results
+	int dispatches = 0;
+
+	std::vector<unsigned char> bufferp(meshopt_encodeIndexBufferBound(index_count, 201 * 201));
+	bufferp.resize(meshopt_encodeIndexBufferParallel(&bufferp[0], bufferp.size(), &indices[0], index_count, dispatchReverse, &dispatches));
+	assert(bufferp == buffer);
+	assert(dispatches == 1);
+
+	// buffers that don't fit the worst case layout are encoded serially
+	dispatches = 0;
+
+	std::vector<unsigned char> buffert(buffer.size());
+	buffert.resize(meshopt_encodeIndexBufferParallel(&buffert[0], buffert.size(), &indices[0], index_count, dispatchReverse, &dispatches));
+	assert(buffert == buffer);
+	assert(dispatches == 0);
+
+	meshopt_encodeIndexVersion(0);
+
+	std::vector<unsigned int> decoded(index_count);
+	assert(meshopt_decodeIndexBuffer(&decoded[0], index_count, &buffer[0], buffer.size()) == 0);
+
+	// encoder is allowed to rotate triangles
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		const unsigned int* a = &indices[i];
+		const unsigned int* b = &decoded[i];
+
+		assert((a[0] == b[0] && a[1] == b[1] && a[2] == b[2]) || (a[0] == b[1] && a[1] == b[2] && a[2] == b[0]) || (a[0] == b[2] && a[1] == b[0] && a[2] == b[1]));
+		(void)a;
+		(void)b;
+	}
+
+	dispatches = 0;
+
+	std::vector<unsigned int> decodedp(index_count);
+	assert(meshopt_decodeIndexBufferParallel(&decodedp[0], index_count, 4, &buffer[0], buffer.size(), dispatchReverse, &dispatches) == 0);
+	assert(decodedp == decoded);
+	assert(dispatches == 1);
+
+	std::vector<unsigned short> decoded16(index_count);
+	assert(meshopt_decodeIndexBufferParallel(&decoded16[0], index_count, 2, &buffer[0], buffer.size(), NULL, NULL) == 0);
+
+	for (size_t i = 0; i < index_count; ++i)
+		assert(decoded16[i] == (unsigned short)(decoded[i]));
+
+	// check that the decoder rejects truncated streams and broken chunk tables
+	assert(meshopt_decodeIndexBuffer(&decoded[0], index_count, &buffer[0], buffer.size() - 1) < 0);
+	assert(meshopt_decodeIndexBufferParallel(&decoded[0], index_count, 4, &buffer[0], buffer.size() - 1, dispatchReverse, NULL) < 0);
+
+	std::vector<unsigned char> brokenbuffer(buffer);
+	brokenbuffer[brokenbuffer.size() - 16 - 8 * 3]++;
+
+	assert(meshopt_decodeIndexBuffer(&decoded[0], index_count, &brokenbuffer[0], brokenbuffer.size()) < 0);
+	assert(meshopt_decodeIndexBufferParallel(&decoded[0], index_count, 4, &brokenbuffer[0], brokenbuffer.size(), dispatchReverse, NULL) < 0);
+}
+
+static void decodeIndexRange()
+{
+	const size_t triangle_count = 40000;
+
+	std::vector<unsigned int> indices(triangle_count * 3);
+
+	for (size_t i = 0; i < triangle_count; ++i)
+	{
+		indices[i * 3 + 0] = unsigned(i);
+		indices[i * 3 + 1] = unsigned(i + 1);
+		indices[i * 3 + 2] = unsigned(i * 7919 % 5000 + 40002);
+	}
+
+	for (int version = 0; version <= 2; ++version)
+	{
+		meshopt_encodeIndexVersion(version);
+
+		std::vector<unsigned char> buffer(meshopt_encodeIndexBufferBound(indices.size(), 45002));
+		buffer.resize(meshopt_encodeIndexBuffer(&buffer[0], buffer.size(), &indices[0], indices.size()));
+
+		std::vector<unsigned int> full(indices.size());
+		assert(meshopt_decodeIndexBuffer(&full[0], indices.size(), &buffer[0], buffer.size()) == 0);
+
+		// ranges that start and end inside chunks, span multiple chunks or cover entire chunks
+		const size_t ranges[][2] = {{0, 1}, {0, 16384}, {16383, 2}, {100, 30000}, {16384, 16384}, {39999, 1}, {0, 40000}};
+
+		for (size_t i = 0; i < sizeof(ranges) / sizeof(ranges[0]); ++i)
+		{
+			size_t first = ranges[i][0] * 3, count = ranges[i][1] * 3;
+
+			std::vector<unsigned int> decoded(count + 1, 0xcdcdcdcd);
+			assert(meshopt_decodeIndexBufferRange(&decoded[0], first, count, indices.size(), 4, &buffer[0], buffer.size()) == 0);
+			assert(memcmp(&decoded[0], &full[first], count * 4) == 0);
+
+			// decoder should not write outside of the range
+			assert(decoded[count] == 0xcdcdcdcd);
+
+			std::vector<unsigned short> decoded16(count + 1, 0xcdcd);
+			assert(meshopt_decodeIndexBufferRange(&decoded16[0], first, count, indices.size(), 2, &buffer[0], buffer.size()) == 0);
+			assert(decoded16[count] == 0xcdcd);
+
+			for (size_t j = 0; j < count; ++j)
+				assert(decoded16[j] == (unsigned short)(full[first + j]));
+		}
+	}
+
+	meshopt_encodeIndexVersion(0);
+}
+
 static void encodeIndexEmpty()
 {
 	std::vector<unsigned char> buffer(meshopt_encodeIndexBufferBound(0, 0));
@@ -357,6 +570,18 @@ static void decodeVertexV0()
 	assert(memcmp(decoded, kVertexBuffer, sizeof(kVertexBuffer)) == 0);
 }
 
+static void encodeVertexV0()
+{
+	const size_t vertex_count = sizeof(kVertexBuffer) / sizeof(kVertexBuffer[0]);
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), kVertexBuffer, vertex_count, sizeof(PV)));
+
+	// encoder output is expected to be stable across versions and SIMD implementations
+	assert(buffer.size() == sizeof(kVertexDataV0));
+	assert(memcmp(&buffer[0], kVertexDataV0, sizeof(kVertexDataV0)) == 0);
+}
+
 static void encodeVertexMemorySafe()
 {
 	const size_t vertex_count = sizeof(kVertexBuffer) / sizeof(kVertexBuffer[0]);
@@ -503,6 +728,308 @@ static void decodeVertexLarge()
 	assert(memcmp(decoded, data, sizeof(data)) == 0);
 }
 
+static void decodeVertexParallel()
+{
+	const size_t vertex_count = 20000;
+
+	std::vector<unsigned int> data(vertex_count * 4);
+
+	// mix smooth and noisy streams to get blocks with different sizes
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		data[i * 4 + 0] = unsigned(i);
+		data[i * 4 + 1] = unsigned(i * 7919) ^ unsigned(i >> 3);
+		data[i * 4 + 2] = (i % 100 == 0) ? 0xdeadbeef : unsigned(i / 16);
+		data[i * 4 + 3] = unsigned(i * i);
+	}
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, 16));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &data[0], vertex_count, 16));
+
+	std::vector<unsigned int> decoded(vertex_count * 4);
+	assert(meshopt_decodeVertexBufferParallel(&decoded[0], vertex_count, 16, &buffer[0], buffer.size(), NULL, NULL) == 0);
+	assert(decoded == data);
+
+	int dispatches = 0;
+
+	std::vector<unsigned int> decodedr(vertex_count * 4);
+	assert(meshopt_decodeVertexBufferParallel(&decodedr[0], vertex_count, 16, &buffer[0], buffer.size(), dispatchReverse, &dispatches) == 0);
+	assert(decodedr == data);
+	assert(dispatches == 2);
+
+	// check that the decoder rejects truncated and extended streams
+	assert(meshopt_decodeVertexBufferParallel(&decoded[0], vertex_count, 16, &buffer[0], buffer.size() - 40, NULL, NULL) < 0);
+
+	buffer.push_back(0);
+	assert(meshopt_decodeVertexBufferParallel(&decoded[0], vertex_count, 16, &buffer[0], buffer.size(), NULL, NULL) < 0);
+
+	// version 1 uses block offset table instead of a scan
+	meshopt_encodeVertexVersion(1);
+
+	buffer.resize(meshopt_encodeVertexBufferBound(vertex_count, 16));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &data[0], vertex_count, 16));
+
+	meshopt_encodeVertexVersion(0);
+
+	assert(meshopt_decodeVertexBufferParallel(&decodedr[0], vertex_count, 16, &buffer[0], buffer.size(), dispatchReverse, &dispatches) == 0);
+	assert(decodedr == data);
+	assert(dispatches == 3);
+
+	buffer.push_back(0);
+	assert(meshopt_decodeVertexBufferParallel(&decoded[0], vertex_count, 16, &buffer[0], buffer.size(), NULL, NULL) < 0);
+}
+
+static void decodeVertexV1()
+{
+	const size_t vertex_count = 3000;
+
+	std::vector<unsigned int> data(vertex_count * 2);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		data[i * 2 + 0] = unsigned(i * 3);
+		data[i * 2 + 1] = unsigned(i * 7919) ^ unsigned(i >> 3);
+	}
+
+	meshopt_encodeVertexVersion(1);
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, 8));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &data[0], vertex_count, 8));
+
+	meshopt_encodeVertexVersion(0);
+
+	assert(buffer[0] == 0xa1);
+
+	std::vector<unsigned int> decoded(vertex_count * 2);
+	assert(meshopt_decodeVertexBuffer(&decoded[0], vertex_count, 8, &buffer[0], buffer.size()) == 0);
+	assert(decoded == data);
+
+	// check that decoder validates block offsets
+	std::vector<unsigned char> brokenbuffer(buffer);
+	brokenbuffer[brokenbuffer.size() - 32 - 4]++;
+
+	assert(meshopt_decodeVertexBuffer(&decoded[0], vertex_count, 8, &brokenbuffer[0], brokenbuffer.size()) < 0);
+}
+
+static void decodeVertexV1MemorySafe()
+{
+	const size_t vertex_count = sizeof(kVertexBuffer) / sizeof(kVertexBuffer[0]);
+
+	meshopt_encodeVertexVersion(1);
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), kVertexBuffer, vertex_count, sizeof(PV)));
+
+	meshopt_encodeVertexVersion(0);
+
+	// check that decode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	PV decoded[vertex_count];
+
+	for (size_t i = 0; i <= buffer.size(); ++i)
+	{
+		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+		int result = meshopt_decodeVertexBuffer(decoded, vertex_count, sizeof(PV), i == 0 ? 0 : &shortbuffer[0], i);
+		int resultr = meshopt_decodeVertexBufferRange(decoded, 1, vertex_count - 1, vertex_count, sizeof(PV), i == 0 ? 0 : &shortbuffer[0], i);
+		(void)result;
+		(void)resultr;
+
+		if (i == buffer.size())
+			assert(result == 0 && resultr == 0);
+		else
+			assert(result < 0);
+	}
+}
+
+static void decodeVertexRange()
+{
+	const size_t vertex_count = 3000;
+
+	std::vector<unsigned int> data(vertex_count * 4);
+
+	for (size_t i = 0; i < vertex_count * 4; ++i)
+		data[i] = unsigned(i * 7919) ^ unsigned(i >> 5);
+
+	for (int version = 0; version <= 1; ++version)
+	{
+		meshopt_encodeVertexVersion(version);
+
+		std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, 16));
+		buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &data[0], vertex_count, 16));
+
+		// ranges that start and end inside blocks, span multiple blocks or cover entire blocks
+		const size_t ranges[][2] = {{0, 1}, {0, 256}, {10, 500}, {255, 2}, {512, 1024}, {2999, 1}, {1000, 2000}, {0, 3000}};
+
+		for (size_t i = 0; i < sizeof(ranges) / sizeof(ranges[0]); ++i)
+		{
+			size_t first = ranges[i][0], count = ranges[i][1];
+
+			std::vector<unsigned int> decoded(count * 4 + 4, 0xcdcdcdcd);
+			assert(meshopt_decodeVertexBufferRange(&decoded[0], first, count, vertex_count, 16, &buffer[0], buffer.size()) == 0);
+			assert(memcmp(&decoded[0], &data[first * 4], count * 16) == 0);
+
+			// decoder should not write outside of the range
+			assert(decoded[count * 4] == 0xcdcdcdcd);
+		}
+	}
+
+	meshopt_encodeVertexVersion(0);
+}
+
+static void decodeVertexStreaming()
+{
+	const size_t vertex_count = 3000;
+
+	std::vector<unsigned int> data(vertex_count * 4);
+
+	for (size_t i = 0; i < vertex_count * 4; ++i)
+		data[i] = unsigned(i * 7919) ^ unsigned(i >> 5);
+
+	for (int version = 0; version <= 1; ++version)
+	{
+		meshopt_encodeVertexVersion(version);
+
+		std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, 16));
+		buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &data[0], vertex_count, 16));
+
+		const size_t chunks[] = {1, 7, 1000, buffer.size()};
+
+		for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i)
+		{
+			std::vector<unsigned int> decoded(vertex_count * 4);
+
+			meshopt_VertexDecoder* decoder = meshopt_createVertexDecoder(&decoded[0], vertex_count, 16);
+
+			for (size_t offset = 0; offset < buffer.size(); offset += chunks[i])
+			{
+				size_t size = offset + chunks[i] < buffer.size() ? chunks[i] : buffer.size() - offset;
+
+				assert(meshopt_feedVertexDecoder(decoder, &buffer[offset], size) == 0);
+
+				// version 1 blocks are final as soon as they are decoded; version 0 needs the first vertex from the end of the stream
+				size_t ready = meshopt_getVertexDecoderReady(decoder);
+				assert(version == 0 ? ready == 0 : ready <= vertex_count);
+				assert(ready == 0 || memcmp(&decoded[0], &data[0], ready * 16) == 0);
+			}
+
+			// the offset table and the tail arrive after the last block
+			assert(meshopt_getVertexDecoderReady(decoder) == (version == 0 ? 0 : vertex_count));
+
+			assert(meshopt_finishVertexDecoder(decoder) == 0);
+			assert(meshopt_getVertexDecoderReady(decoder) == vertex_count);
+			assert(decoded == data);
+
+			meshopt_destroyVertexDecoder(decoder);
+		}
+
+		std::vector<unsigned int> decoded(vertex_count * 4);
+		meshopt_VertexDecoder* decoder;
+
+		// truncated stream
+		decoder = meshopt_createVertexDecoder(&decoded[0], vertex_count, 16);
+		assert(meshopt_feedVertexDecoder(decoder, &buffer[0], buffer.size() - 1) == 0);
+		assert(meshopt_finishVertexDecoder(decoder) == -2);
+		meshopt_destroyVertexDecoder(decoder);
+
+		// extra bytes after the stream
+		std::vector<unsigned char> largebuffer(buffer);
+		largebuffer.push_back(0);
+
+		decoder = meshopt_createVertexDecoder(&decoded[0], vertex_count, 16);
+		assert(meshopt_feedVertexDecoder(decoder, &largebuffer[0], largebuffer.size()) == 0);
+		assert(meshopt_finishVertexDecoder(decoder) == -3);
+		meshopt_destroyVertexDecoder(decoder);
+
+		// invalid header
+		std::vector<unsigned char> brokenbuffer(buffer);
+		brokenbuffer[0] = 0;
+
+		decoder = meshopt_createVertexDecoder(&decoded[0], vertex_count, 16);
+		assert(meshopt_feedVertexDecoder(decoder, &brokenbuffer[0], brokenbuffer.size()) == -1);
+		assert(meshopt_finishVertexDecoder(decoder) == -1);
+		meshopt_destroyVertexDecoder(decoder);
+	}
+
+	meshopt_encodeVertexVersion(0);
+}
+
+static void decodeVertexStreamingLargeBlock()
+{
+	// the encoder never produces this, but the decoder accepts blocks where every group uses 4-bit mode with 16 exceptions, which is the largest possible block
+	const size_t vertex_count = 32;
+	const size_t vertex_size = 256;
+
+	std::vector<unsigned char> buffer;
+	buffer.push_back(0xa1);
+	buffer.insert(buffer.end(), vertex_size, 0);
+
+	for (size_t k = 0; k < vertex_size; ++k)
+	{
+		buffer.push_back(0x0a);
+
+		for (int group = 0; group < 2; ++group)
+		{
+			buffer.insert(buffer.end(), 8, 0xff);
+
+			for (int i = 0; i < 16; ++i)
+				buffer.push_back((unsigned char)(k + group * 16 + i));
+		}
+	}
+
+	// offset table with a single block that starts after the header and the first vertex, followed by the tail
+	unsigned char table[4] = {(1 + vertex_size) & 0xff, (1 + vertex_size) >> 8, 0, 0};
+	buffer.insert(buffer.end(), table, table + 4);
+	buffer.insert(buffer.end(), vertex_size, 0);
+
+	std::vector<unsigned char> expected(vertex_count * vertex_size);
+	assert(meshopt_decodeVertexBuffer(&expected[0], vertex_count, vertex_size, &buffer[0], buffer.size()) == 0);
+
+	const size_t chunks[] = {1, 1000, buffer.size()};
+
+	for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i)
+	{
+		std::vector<unsigned char> decoded(vertex_count * vertex_size);
+
+		meshopt_VertexDecoder* decoder = meshopt_createVertexDecoder(&decoded[0], vertex_count, vertex_size);
+
+		for (size_t offset = 0; offset < buffer.size(); offset += chunks[i])
+		{
+			size_t size = offset + chunks[i] < buffer.size() ? chunks[i] : buffer.size() - offset;
+
+			assert(meshopt_feedVertexDecoder(decoder, &buffer[offset], size) == 0);
+		}
+
+		assert(meshopt_finishVertexDecoder(decoder) == 0);
+		assert(decoded == expected);
+
+		meshopt_destroyVertexDecoder(decoder);
+	}
+}
+
+static void decodeVertexRejectInvalidVersion()
+{
+	const size_t vertex_count = sizeof(kVertexBuffer) / sizeof(kVertexBuffer[0]);
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), kVertexBuffer, vertex_count, sizeof(PV)));
+
+	// check that decoders don't accept unknown versions; only 0 and 1 are valid
+	PV decoded[vertex_count];
+
+	for (int version = 2; version < 16; ++version)
+	{
+		std::vector<unsigned char> brokenbuffer(buffer);
+		brokenbuffer[0] = (unsigned char)(0xa0 | version);
+
+		assert(meshopt_decodeVertexBuffer(decoded, vertex_count, sizeof(PV), &brokenbuffer[0], brokenbuffer.size()) == -1);
+		assert(meshopt_decodeVertexBufferParallel(decoded, vertex_count, sizeof(PV), &brokenbuffer[0], brokenbuffer.size(), NULL, NULL) == -1);
+		assert(meshopt_decodeVertexBufferRange(decoded, 0, vertex_count, vertex_count, sizeof(PV), &brokenbuffer[0], brokenbuffer.size()) == -1);
+
+		meshopt_VertexDecoder* decoder = meshopt_createVertexDecoder(decoded, vertex_count, sizeof(PV));
+		assert(meshopt_feedVertexDecoder(decoder, &brokenbuffer[0], brokenbuffer.size()) == -1);
+		meshopt_destroyVertexDecoder(decoder);
+	}
+}
+
 static void encodeVertexEmpty()
 {
 	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(0, 16));
@@ -627,29 +1154,499 @@ static void decodeFilterExp()
 	assert(memcmp(tail, expected, sizeof(tail)) == 0);
 }
 
-static void clusterBoundsDegenerate()
+static void decodeVertexFiltered()
 {
-	const float vbd[] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
-	const unsigned int ibd[] = {0, 0, 0};
-	const unsigned int ib1[] = {0, 1, 2};
+	const size_t vertex_count = 1001;
 
-	// all of the bounds below are degenerate as they use 0 triangles, one topology-degenerate triangle and one position-degenerate triangle respectively
-	meshopt_Bounds bounds0 = meshopt_computeClusterBounds(0, 0, 0, 0, 12);
-	meshopt_Bounds boundsd = meshopt_computeClusterBounds(ibd, 3, vbd, 3, 12);
-	meshopt_Bounds bounds1 = meshopt_computeClusterBounds(ib1, 3, vbd, 3, 12);
+	std::vector<unsigned short> data(vertex_count * 4);
 
-	assert(bounds0.center[0] == 0 && bounds0.center[1] == 0 && bounds0.center[2] == 0 && bounds0.radius == 0);
-	assert(boundsd.center[0] == 0 && boundsd.center[1] == 0 && boundsd.center[2] == 0 && boundsd.radius == 0);
-	assert(bounds1.center[0] == 0 && bounds1.center[1] == 0 && bounds1.center[2] == 0 && bounds1.radius == 0);
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		// filters are deterministic so any input works for comparing fused and separate filtering
+		data[i * 4 + 0] = (unsigned short)(i * 37);
+		data[i * 4 + 1] = (unsigned short)(i * 91);
+		data[i * 4 + 2] = (unsigned short)(i % 2 ? 2047 : 4095);
+		data[i * 4 + 3] = (unsigned short)(i);
+	}
 
-	const float vb1[] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
-	const unsigned int ib2[] = {0, 1, 2, 0, 2, 1};
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, 8));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &data[0], vertex_count, 8));
 
-	// these bounds have a degenerate cone since the cluster has two triangles with opposite normals
-	meshopt_Bounds bounds2 = meshopt_computeClusterBounds(ib2, 6, vb1, 3, 12);
+	meshopt_FilterCallback filters[] = {meshopt_decodeFilterOct, meshopt_decodeFilterQuat, meshopt_decodeFilterExp};
 
-	assert(bounds2.cone_apex[0] == 0 && bounds2.cone_apex[1] == 0 && bounds2.cone_apex[2] == 0);
-	assert(bounds2.cone_axis[0] == 0 && bounds2.cone_axis[1] == 0 && bounds2.cone_axis[2] == 0);
+	for (size_t i = 0; i < sizeof(filters) / sizeof(filters[0]); ++i)
+	{
+		std::vector<unsigned short> expected(vertex_count * 4);
+		assert(meshopt_decodeVertexBuffer(&expected[0], vertex_count, 8, &buffer[0], buffer.size()) == 0);
+		filters[i](&expected[0], vertex_count, 8);
+
+		std::vector<unsigned short> decoded(vertex_count * 4);
+		assert(meshopt_decodeVertexBufferFiltered(&decoded[0], vertex_count, 8, &buffer[0], buffer.size(), filters[i]) == 0);
+		assert(decoded == expected);
+	}
+
+	std::vector<unsigned short> decoded(vertex_count * 4);
+	assert(meshopt_decodeVertexBufferFiltered(&decoded[0], vertex_count, 8, &buffer[0], buffer.size(), NULL) == 0);
+	assert(decoded == data);
+
+	assert(meshopt_decodeVertexBufferFiltered(&decoded[0], vertex_count, 8, &buffer[0], buffer.size() - 1, meshopt_decodeFilterExp) < 0);
+}
+
+static std::pair<unsigned int, std::pair<unsigned int, unsigned int> > rotateTriangle(unsigned int a, unsigned int b, unsigned int c)
+{
+	// rotate the triangle so that the smallest index is first, which preserves the winding order
+	if (b < a && b < c)
+		return std::make_pair(b, std::make_pair(c, a));
+	else if (c < a && c < b)
+		return std::make_pair(c, std::make_pair(a, b));
+	else
+		return std::make_pair(a, std::make_pair(b, c));
+}
+
+// (N+1)x(N+1) vertex grid with two triangles per cell; z follows a pseudo-random pattern scaled by height so that the surface isn't flat
+static void createGrid(std::vector<float>& vb, std::vector<unsigned int>& ib, int N, float height)
+{
+	vb.resize((N + 1) * (N + 1) * 3);
+	ib.clear();
+
+	for (int y = 0; y <= N; ++y)
+		for (int x = 0; x <= N; ++x)
+		{
+			vb[(y * (N + 1) + x) * 3 + 0] = float(x);
+			vb[(y * (N + 1) + x) * 3 + 1] = float(y);
+			vb[(y * (N + 1) + x) * 3 + 2] = float((x * 7 + y * 13) % 5) * height;
+		}
+
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			unsigned int v = y * (N + 1) + x;
+			unsigned int quad[6] = {v, v + 1, v + N + 1, v + N + 1, v + 1, v + N + 2};
+
+			ib.insert(ib.end(), quad, quad + 6);
+		}
+}
+
+static void buildMeshletsParallel()
+{
+	// 200x200 grid, which is enough for several partitions
+	const int N = 200;
+
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	createGrid(vb, ib, N, 0.5f);
+
+	// the second configuration uses an unindexed stream with limits that don't divide the partition size evenly, which stresses the output bounds
+	std::vector<unsigned int> ibu(ib.size());
+	for (size_t i = 0; i < ibu.size(); ++i)
+		ibu[i] = unsigned(i);
+
+	std::vector<float> vbu(ibu.size() * 3);
+	for (size_t i = 0; i < ib.size(); ++i)
+		memcpy(&vbu[i * 3], &vb[ib[i] * 3], 3 * sizeof(float));
+
+	// the third configuration uses two full partitions of tiny meshlets, each of which ends with a partially filled meshlet, so the result exceeds meshopt_buildMeshletsBound
+	std::vector<unsigned int> ibs(ibu.begin(), ibu.begin() + 32768 * 3);
+
+	const std::vector<unsigned int>* indices[3] = {&ib, &ibu, &ibs};
+	const std::vector<float>* vertices[3] = {&vb, &vbu, &vbu};
+	size_t max_vertices[3] = {64, 63, 11};
+	size_t max_triangles[3] = {124, 12, 4};
+
+	for (int k = 0; k < 3; ++k)
+	{
+		const std::vector<unsigned int>& kib = *indices[k];
+		const std::vector<float>& kvb = *vertices[k];
+
+		size_t max_meshlets = meshopt_buildMeshletsBound(kib.size(), max_vertices[k], max_triangles[k]);
+
+		std::vector<meshopt_Meshlet> expected(max_meshlets);
+		std::vector<unsigned int> expected_vertices(max_meshlets * max_vertices[k]);
+		std::vector<unsigned char> expected_triangles(max_meshlets * max_triangles[k] * 3);
+		expected.resize(meshopt_buildMeshlets(&expected[0], &expected_vertices[0], &expected_triangles[0], &kib[0], kib.size(), &kvb[0], kvb.size() / 3, 12, max_vertices[k], max_triangles[k], 0.f));
+
+		// every partition may end with a partially filled meshlet
+		size_t max_parallel = meshopt_buildMeshletsParallelBound(kib.size(), max_vertices[k], max_triangles[k]);
+		size_t partition_size = 16384 / max_triangles[k] * max_triangles[k];
+		size_t partitions = (kib.size() / 3 + partition_size - 1) / partition_size;
+		assert(max_parallel >= max_meshlets && max_parallel <= max_meshlets + partitions);
+
+		std::vector<meshopt_Meshlet> meshlets(max_parallel);
+		std::vector<unsigned int> meshlet_vertices(max_parallel * max_vertices[k]);
+		std::vector<unsigned char> meshlet_triangles(max_parallel * max_triangles[k] * 3);
+		int dispatches = 0;
+		meshlets.resize(meshopt_buildMeshletsParallel(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &kib[0], kib.size(), &kvb[0], kvb.size() / 3, 12, max_vertices[k], max_triangles[k], 0.f, dispatchReverse, &dispatches));
+
+		assert(dispatches > 0);
+
+		// meshlets can't cross partition boundaries, which only adds a few meshlets
+		assert(meshlets.size() >= expected.size() && meshlets.size() <= expected.size() * 21 / 20);
+		assert(k != 2 || meshlets.size() > max_meshlets);
+
+		// every triangle must be emitted exactly once, and meshlet data must be packed back to back
+		std::vector<std::pair<unsigned int, std::pair<unsigned int, unsigned int> > > triangles, source;
+		size_t vertex_offset = 0, triangle_offset = 0;
+
+		for (size_t i = 0; i < meshlets.size(); ++i)
+		{
+			const meshopt_Meshlet& m = meshlets[i];
+			assert(m.vertex_offset == vertex_offset && m.triangle_offset == triangle_offset);
+			assert(m.vertex_count <= max_vertices[k] && m.triangle_count > 0 && m.triangle_count <= max_triangles[k]);
+
+			for (size_t j = 0; j < m.triangle_count * 3; j += 3)
+			{
+				const unsigned char* tri = &meshlet_triangles[m.triangle_offset + j];
+				assert(tri[0] < m.vertex_count && tri[1] < m.vertex_count && tri[2] < m.vertex_count);
+
+				unsigned int a = meshlet_vertices[m.vertex_offset + tri[0]], b = meshlet_vertices[m.vertex_offset + tri[1]], c = meshlet_vertices[m.vertex_offset + tri[2]];
+				triangles.push_back(rotateTriangle(a, b, c));
+			}
+
+			vertex_offset += m.vertex_count;
+			triangle_offset += (m.triangle_count * 3 + 3) & ~3;
+		}
+
+		for (size_t i = 0; i < kib.size(); i += 3)
+			source.push_back(rotateTriangle(kib[i + 0], kib[i + 1], kib[i + 2]));
+
+		std::sort(triangles.begin(), triangles.end());
+		std::sort(source.begin(), source.end());
+
+		assert(triangles == source);
+
+		// NULL dispatch runs all jobs serially
+		std::vector<meshopt_Meshlet> serial(max_parallel);
+		std::vector<unsigned int> serial_vertices(max_parallel * max_vertices[k]);
+		std::vector<unsigned char> serial_triangles(max_parallel * max_triangles[k] * 3);
+		serial.resize(meshopt_buildMeshletsParallel(&serial[0], &serial_vertices[0], &serial_triangles[0], &kib[0], kib.size(), &kvb[0], kvb.size() / 3, 12, max_vertices[k], max_triangles[k], 0.f, NULL, NULL));
+
+		assert(serial.size() == meshlets.size());
+		assert(memcmp(&serial[0], &meshlets[0], meshlets.size() * sizeof(meshopt_Meshlet)) == 0);
+		assert(serial_vertices == meshlet_vertices && serial_triangles == meshlet_triangles);
+	}
+}
+
+static void buildMeshletsSpatial()
+{
+	// 40x40 grid with every triangle repeated twice, which makes it possible to have clusters with more than 512 triangles
+	const int N = 40;
+
+	std::vector<float> vb;
+	std::vector<unsigned int> grid, ib;
+	createGrid(vb, grid, N, 0.5f);
+
+	for (size_t i = 0; i < grid.size(); i += 6)
+	{
+		ib.insert(ib.end(), &grid[i], &grid[i] + 6);
+		ib.insert(ib.end(), &grid[i], &grid[i] + 6);
+	}
+
+	// the second configuration uses a small vertex limit which forces clusters below min_triangles
+	size_t max_vertices[2] = {255, 8};
+	size_t min_triangles[2] = {256, 4};
+	size_t max_triangles[2] = {1024, 8};
+	size_t large = 0;
+
+	for (int k = 0; k < 2; ++k)
+	{
+		size_t max_meshlets = meshopt_buildMeshletsSpatialBound(ib.size(), max_vertices[k], min_triangles[k]);
+
+		std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+		std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices[k]);
+		std::vector<unsigned char> meshlet_triangles(max_meshlets * max_triangles[k] * 3);
+		std::vector<float> meshlet_aabbs(max_meshlets * 6);
+		meshlets.resize(meshopt_buildMeshletsSpatial(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &meshlet_aabbs[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, max_vertices[k], min_triangles[k], max_triangles[k]));
+
+		std::vector<std::pair<unsigned int, std::pair<unsigned int, unsigned int> > > triangles, source;
+
+		for (size_t i = 0; i < meshlets.size(); ++i)
+		{
+			const meshopt_Meshlet& m = meshlets[i];
+			assert(m.vertex_count <= max_vertices[k] && m.triangle_count > 0 && m.triangle_count <= max_triangles[k]);
+
+			large += m.triangle_count > 512;
+
+			for (size_t j = 0; j < m.triangle_count * 3; j += 3)
+			{
+				const unsigned char* tri = &meshlet_triangles[m.triangle_offset + j];
+				assert(tri[0] < m.vertex_count && tri[1] < m.vertex_count && tri[2] < m.vertex_count);
+
+				unsigned int a = meshlet_vertices[m.vertex_offset + tri[0]], b = meshlet_vertices[m.vertex_offset + tri[1]], c = meshlet_vertices[m.vertex_offset + tri[2]];
+				triangles.push_back(rotateTriangle(a, b, c));
+			}
+
+			// the bounding box must be tight around meshlet vertices
+			const float* box = &meshlet_aabbs[i * 6];
+			float tight[6] = {FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+			for (size_t j = 0; j < m.vertex_count; ++j)
+				for (int l = 0; l < 3; ++l)
+				{
+					float p = vb[meshlet_vertices[m.vertex_offset + j] * 3 + l];
+
+					tight[l] = std::min(tight[l], p);
+					tight[l + 3] = std::max(tight[l + 3], p);
+				}
+
+			assert(memcmp(box, tight, sizeof(tight)) == 0);
+		}
+
+		// batched bounds accept meshlets with more than 512 triangles; the bounding spheres must contain all meshlet vertices
+		std::vector<meshopt_Bounds> bounds(meshlets.size());
+		meshopt_computeMeshletBoundsBatch(&bounds[0], &meshlets[0], meshlets.size(), &meshlet_vertices[0], &meshlet_triangles[0], &vb[0], vb.size() / 3, 12, NULL, NULL);
+
+		for (size_t i = 0; i < meshlets.size(); ++i)
+		{
+			const meshopt_Meshlet& m = meshlets[i];
+			const meshopt_Bounds& b = bounds[i];
+
+			for (size_t j = 0; j < m.vertex_count; ++j)
+			{
+				const float* p = &vb[meshlet_vertices[m.vertex_offset + j] * 3];
+				float dx = p[0] - b.center[0], dy = p[1] - b.center[1], dz = p[2] - b.center[2];
+				float r = b.radius * 1.001f + 1e-5f;
+
+				assert(dx * dx + dy * dy + dz * dz <= r * r);
+			}
+		}
+
+		for (size_t i = 0; i < ib.size(); i += 3)
+			source.push_back(rotateTriangle(ib[i + 0], ib[i + 1], ib[i + 2]));
+
+		std::sort(triangles.begin(), triangles.end());
+		std::sort(source.begin(), source.end());
+
+		assert(triangles == source);
+	}
+
+	assert(large > 0);
+}
+
+static void optimizeMeshlet()
+{
+	const int N = 20;
+
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	createGrid(vb, ib, N, 0.f);
+
+	const size_t max_vertices = 64;
+	const size_t max_triangles = 124;
+
+	size_t max_meshlets = meshopt_buildMeshletsBound(ib.size(), max_vertices, max_triangles);
+
+	std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+	std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
+	std::vector<unsigned char> meshlet_triangles(max_meshlets * max_triangles * 3);
+	meshlets.resize(meshopt_buildMeshlets(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, max_vertices, max_triangles, 0.5f));
+
+	for (size_t i = 0; i < meshlets.size(); ++i)
+	{
+		const meshopt_Meshlet& m = meshlets[i];
+
+		unsigned int* vertices = &meshlet_vertices[m.vertex_offset];
+		unsigned char* triangles = &meshlet_triangles[m.triangle_offset];
+
+		std::vector<unsigned int> sorted_vertices(vertices, vertices + m.vertex_count);
+		std::vector<std::pair<unsigned int, std::pair<unsigned int, unsigned int> > > source, result;
+
+		for (size_t j = 0; j < m.triangle_count * 3; j += 3)
+			source.push_back(rotateTriangle(vertices[triangles[j + 0]], vertices[triangles[j + 1]], vertices[triangles[j + 2]]));
+
+		meshopt_optimizeMeshlet(vertices, triangles, m.triangle_count, m.vertex_count);
+
+		// vertices must be in the order of first use
+		unsigned int next = 0;
+
+		for (size_t j = 0; j < m.triangle_count * 3; ++j)
+		{
+			assert(triangles[j] <= next);
+			next += triangles[j] == next;
+		}
+
+		assert(next == m.vertex_count);
+
+		// triangles and their winding must be preserved
+		for (size_t j = 0; j < m.triangle_count * 3; j += 3)
+			result.push_back(rotateTriangle(vertices[triangles[j + 0]], vertices[triangles[j + 1]], vertices[triangles[j + 2]]));
+
+		std::sort(source.begin(), source.end());
+		std::sort(result.begin(), result.end());
+		assert(source == result);
+
+		std::vector<unsigned int> optimized_vertices(vertices, vertices + m.vertex_count);
+
+		std::sort(sorted_vertices.begin(), sorted_vertices.end());
+		std::sort(optimized_vertices.begin(), optimized_vertices.end());
+		assert(sorted_vertices == optimized_vertices);
+	}
+}
+
+static void optimizeMeshletUnused()
+{
+	// vertex 1 isn't referenced by any triangle, so it needs to go last
+	unsigned int vertices[] = {10, 11, 12, 13, 14};
+	unsigned char triangles[] = {4, 3, 2, 0, 2, 3};
+
+	meshopt_optimizeMeshlet(vertices, triangles, 2, 5);
+
+	unsigned int expected_vertices[] = {14, 13, 12, 10, 11};
+	unsigned char expected_triangles[] = {0, 1, 2, 3, 2, 1};
+
+	assert(memcmp(vertices, expected_vertices, sizeof(vertices)) == 0);
+	assert(memcmp(triangles, expected_triangles, sizeof(triangles)) == 0);
+}
+
+static void encodeMeshlet()
+{
+	const int N = 20;
+
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	createGrid(vb, ib, N, 0.f);
+
+	const size_t max_vertices = 64;
+	const size_t max_triangles = 124;
+
+	size_t max_meshlets = meshopt_buildMeshletsBound(ib.size(), max_vertices, max_triangles);
+
+	std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+	std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
+	std::vector<unsigned char> meshlet_triangles(max_meshlets * max_triangles * 3);
+	meshlets.resize(meshopt_buildMeshlets(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, max_vertices, max_triangles, 0.f));
+
+	std::vector<unsigned char> buffer(meshopt_encodeMeshletBound(max_vertices, max_triangles));
+	size_t encoded = 0, source = 0;
+
+	for (size_t i = 0; i < meshlets.size(); ++i)
+	{
+		const meshopt_Meshlet& m = meshlets[i];
+
+		size_t size = meshopt_encodeMeshlet(&buffer[0], buffer.size(), &meshlet_vertices[m.vertex_offset], m.vertex_count, &meshlet_triangles[m.triangle_offset], m.triangle_count);
+		assert(size > 0 && size <= buffer.size());
+
+		unsigned int vertices[max_vertices];
+		unsigned char triangles[max_triangles * 3];
+		assert(meshopt_decodeMeshlet(vertices, m.vertex_count, triangles, m.triangle_count, &buffer[0], size) == 0);
+
+		assert(memcmp(vertices, &meshlet_vertices[m.vertex_offset], m.vertex_count * sizeof(unsigned int)) == 0);
+		assert(memcmp(triangles, &meshlet_triangles[m.triangle_offset], m.triangle_count * 3) == 0);
+
+		encoded += size;
+		source += m.vertex_count * sizeof(unsigned int) + m.triangle_count * 3;
+	}
+
+	// meshlet data should compress reasonably well
+	assert(encoded < source / 2);
+}
+
+static void encodeMeshletLarge()
+{
+	// vertex references with large and negative deltas and triangles with arbitrary indices exercise all group modes
+	const size_t vertex_count = 255;
+	const size_t triangle_count = 255;
+
+	unsigned int vertices[vertex_count];
+	unsigned char triangles[triangle_count * 3];
+
+	for (size_t i = 0; i < vertex_count; ++i)
+		vertices[i] = (i % 3 == 0) ? unsigned(i) * 0x9e3779b9u : (i % 3 == 1) ? unsigned(i) : ~0u - unsigned(i) * 7;
+
+	for (size_t i = 0; i < triangle_count * 3; ++i)
+		triangles[i] = (i < triangle_count) ? (unsigned char)(i * 37) : (unsigned char)(i / 3 + i % 3);
+
+	std::vector<unsigned char> buffer(meshopt_encodeMeshletBound(vertex_count, triangle_count));
+	buffer.resize(meshopt_encodeMeshlet(&buffer[0], buffer.size(), vertices, vertex_count, triangles, triangle_count));
+	assert(buffer.size() > 0);
+
+	// encoding into a buffer that is too small should fail
+	std::vector<unsigned char> shortbuffer(buffer.size() - 1);
+	assert(meshopt_encodeMeshlet(&shortbuffer[0], shortbuffer.size(), vertices, vertex_count, triangles, triangle_count) == 0);
+
+	// check all prefixes of counts to make sure partial groups are handled correctly
+	for (size_t k = 0; k <= 40; ++k)
+	{
+		std::vector<unsigned char> data(meshopt_encodeMeshletBound(k, k));
+		data.resize(meshopt_encodeMeshlet(&data[0], data.size(), vertices, k, triangles, k));
+		assert(data.size() > 0);
+
+		unsigned int rv[vertex_count + 1];
+		unsigned char rt[triangle_count * 3 + 1];
+		rv[k] = 42;
+		rt[k * 3] = 42;
+
+		assert(meshopt_decodeMeshlet(rv, k, rt, k, &data[0], data.size()) == 0);
+		assert(memcmp(rv, vertices, k * sizeof(unsigned int)) == 0);
+		assert(memcmp(rt, triangles, k * 3) == 0);
+		assert(rv[k] == 42 && rt[k * 3] == 42);
+	}
+
+	unsigned int rv[vertex_count];
+	unsigned char rt[triangle_count * 3];
+	assert(meshopt_decodeMeshlet(rv, vertex_count, rt, triangle_count, &buffer[0], buffer.size()) == 0);
+	assert(memcmp(rv, vertices, sizeof(vertices)) == 0);
+	assert(memcmp(rt, triangles, sizeof(triangles)) == 0);
+}
+
+static void decodeMeshletMemorySafe()
+{
+	unsigned int vertices[] = {100, 101, 102, 90, 91, 1000, 1001, 5};
+	unsigned char triangles[] = {0, 1, 2, 2, 1, 3, 3, 4, 5, 5, 6, 7, 7, 0, 1};
+
+	const size_t vertex_count = sizeof(vertices) / sizeof(vertices[0]);
+	const size_t triangle_count = sizeof(triangles) / sizeof(triangles[0]) / 3;
+
+	std::vector<unsigned char> buffer(meshopt_encodeMeshletBound(vertex_count, triangle_count));
+	buffer.resize(meshopt_encodeMeshlet(&buffer[0], buffer.size(), vertices, vertex_count, triangles, triangle_count));
+
+	// check that decode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	unsigned int rv[vertex_count];
+	unsigned char rt[triangle_count * 3];
+
+	for (size_t i = 0; i <= buffer.size(); ++i)
+	{
+		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+		int result = meshopt_decodeMeshlet(rv, vertex_count, rt, triangle_count, i == 0 ? 0 : &shortbuffer[0], i);
+
+		if (i == buffer.size())
+			assert(result == 0);
+		else
+			assert(result < 0);
+	}
+
+	// unknown header bytes are rejected
+	std::vector<unsigned char> badheader = buffer;
+	badheader[0] ^= 1;
+	assert(meshopt_decodeMeshlet(rv, vertex_count, rt, triangle_count, &badheader[0], badheader.size()) == -1);
+
+	// extra bytes are rejected as well
+	buffer.push_back(0);
+	assert(meshopt_decodeMeshlet(rv, vertex_count, rt, triangle_count, &buffer[0], buffer.size()) < 0);
+}
+
+static void clusterBoundsDegenerate()
+{
+	const float vbd[] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+	const unsigned int ibd[] = {0, 0, 0};
+	const unsigned int ib1[] = {0, 1, 2};
+
+	// all of the bounds below are degenerate as they use 0 triangles, one topology-degenerate triangle and one position-degenerate triangle respectively
+	meshopt_Bounds bounds0 = meshopt_computeClusterBounds(0, 0, 0, 0, 12);
+	meshopt_Bounds boundsd = meshopt_computeClusterBounds(ibd, 3, vbd, 3, 12);
+	meshopt_Bounds bounds1 = meshopt_computeClusterBounds(ib1, 3, vbd, 3, 12);
+
+	assert(bounds0.center[0] == 0 && bounds0.center[1] == 0 && bounds0.center[2] == 0 && bounds0.radius == 0);
+	assert(boundsd.center[0] == 0 && boundsd.center[1] == 0 && boundsd.center[2] == 0 && boundsd.radius == 0);
+	assert(bounds1.center[0] == 0 && bounds1.center[1] == 0 && bounds1.center[2] == 0 && bounds1.radius == 0);
+
+	const float vb1[] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+	const unsigned int ib2[] = {0, 1, 2, 0, 2, 1};
+
+	// these bounds have a degenerate cone since the cluster has two triangles with opposite normals
+	meshopt_Bounds bounds2 = meshopt_computeClusterBounds(ib2, 6, vb1, 3, 12);
+
+	assert(bounds2.cone_apex[0] == 0 && bounds2.cone_apex[1] == 0 && bounds2.cone_apex[2] == 0);
+	assert(bounds2.cone_axis[0] == 0 && bounds2.cone_axis[1] == 0 && bounds2.cone_axis[2] == 0);
 	assert(bounds2.cone_cutoff == 1);
 	assert(bounds2.cone_axis_s8[0] == 0 && bounds2.cone_axis_s8[1] == 0 && bounds2.cone_axis_s8[2] == 0);
 	assert(bounds2.cone_cutoff_s8 == 127);
@@ -660,6 +1657,94 @@ static void clusterBoundsDegenerate()
 	assert(bounds2.center[2] - bounds2.radius <= 0 && bounds2.center[2] + bounds2.radius >= 1);
 }
 
+static bool boundsEqual(const meshopt_Bounds& lhs, const meshopt_Bounds& rhs, float eps)
+{
+	const float* lf = lhs.center;
+	const float* rf = rhs.center;
+
+	// center, radius, cone apex, cone axis and cutoff are stored consecutively
+	for (int i = 0; i < 11; ++i)
+		if (lf[i] - rf[i] > eps || rf[i] - lf[i] > eps)
+			return false;
+
+	return abs(lhs.cone_cutoff_s8 - rhs.cone_cutoff_s8) <= 1;
+}
+
+static void computeMeshletBoundsBatch()
+{
+	const int N = 100;
+
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	createGrid(vb, ib, N, 0.f);
+
+	// a bumpy grid produces meshlets with both narrow and wide normal cones
+	for (int y = 0; y <= N; ++y)
+		for (int x = 0; x <= N; ++x)
+			vb[(y * (N + 1) + x) * 3 + 2] = float((x * 7 + y * 3) % 11) * 0.1f + float(x % 20 < 10 ? x % 10 : 10 - x % 10) * 20.f;
+
+	const size_t max_vertices = 64;
+	const size_t max_triangles = 64;
+
+	size_t max_meshlets = meshopt_buildMeshletsBound(ib.size(), max_vertices, max_triangles);
+
+	std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+	std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
+	std::vector<unsigned char> meshlet_triangles(max_meshlets * max_triangles * 3);
+	meshlets.resize(meshopt_buildMeshlets(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, max_vertices, max_triangles, 0.5f));
+
+	// we need more than one job to test dispatch
+	assert(meshlets.size() > 256);
+
+	// add a meshlet with a single degenerate triangle at the end
+	const meshopt_Meshlet& last = meshlets.back();
+	meshopt_Meshlet degenerate = {unsigned(last.vertex_offset + last.vertex_count), unsigned(last.triangle_offset + last.triangle_count * 3), 1, 1};
+	meshlet_vertices[degenerate.vertex_offset] = 0;
+	memset(&meshlet_triangles[degenerate.triangle_offset], 0, 3);
+	meshlets.push_back(degenerate);
+
+	std::vector<meshopt_Bounds> bounds(meshlets.size());
+	std::vector<meshopt_Bounds> boundsp(meshlets.size());
+
+	meshopt_computeMeshletBoundsBatch(&bounds[0], &meshlets[0], meshlets.size(), &meshlet_vertices[0], &meshlet_triangles[0], &vb[0], vb.size() / 3, 12, NULL, NULL);
+
+	int dispatches = 0;
+	meshopt_computeMeshletBoundsBatch(&boundsp[0], &meshlets[0], meshlets.size(), &meshlet_vertices[0], &meshlet_triangles[0], &vb[0], vb.size() / 3, 12, dispatchReverse, &dispatches);
+	assert(dispatches == 1);
+
+	assert(memcmp(&bounds[0], &boundsp[0], bounds.size() * sizeof(meshopt_Bounds)) == 0);
+
+	size_t narrow = 0;
+
+	for (size_t i = 0; i < meshlets.size(); ++i)
+	{
+		const meshopt_Meshlet& m = meshlets[i];
+		const meshopt_Bounds& b = bounds[i];
+
+		meshopt_Bounds expected = meshopt_computeMeshletBounds(&meshlet_vertices[m.vertex_offset], &meshlet_triangles[m.triangle_offset], m.triangle_count, &vb[0], vb.size() / 3, 12);
+
+		assert(boundsEqual(b, expected, 1e-3f));
+
+		// the bounding sphere must contain all meshlet vertices
+		for (size_t j = 0; j < m.triangle_count * 3 && b.radius > 0; ++j)
+		{
+			const float* p = &vb[meshlet_vertices[m.vertex_offset + meshlet_triangles[m.triangle_offset + j]] * 3];
+			float d2 = (p[0] - b.center[0]) * (p[0] - b.center[0]) + (p[1] - b.center[1]) * (p[1] - b.center[1]) + (p[2] - b.center[2]) * (p[2] - b.center[2]);
+
+			assert(d2 <= b.radius * b.radius * 1.0001f);
+		}
+
+		narrow += b.cone_cutoff < 1;
+	}
+
+	// make sure both trivial accept and the full cone computation are exercised
+	assert(narrow > 0 && narrow < meshlets.size());
+
+	const meshopt_Bounds& bd = bounds.back();
+	assert(bd.center[0] == 0 && bd.center[1] == 0 && bd.center[2] == 0 && bd.radius == 0);
+	assert(bd.cone_cutoff == 0 && bd.cone_cutoff_s8 == 0);
+}
+
 static size_t allocCount;
 static size_t freeCount;
 
@@ -817,6 +1902,361 @@ static void simplifyFlip()
 	assert(memcmp(ib, expected, sizeof(expected)) == 0);
 }
 
+static void simplifyAttributes()
+{
+	// 9x9 vertex grid in the XY plane; every triangle is coplanar so position error is zero for all collapses
+	float vb[9 * 9][3];
+	float ab[9 * 9][2];
+	unsigned int ib[8 * 8 * 6];
+
+	for (int y = 0; y < 9; ++y)
+		for (int x = 0; x < 9; ++x)
+		{
+			vb[y * 9 + x][0] = float(x);
+			vb[y * 9 + x][1] = float(y);
+			vb[y * 9 + x][2] = 0;
+
+			// first attribute varies linearly, second has a spike in the center
+			ab[y * 9 + x][0] = float(x) / 8;
+			ab[y * 9 + x][1] = (x == 4 && y == 4) ? 1.f : 0.f;
+		}
+
+	for (int y = 0; y < 8; ++y)
+		for (int x = 0; x < 8; ++x)
+		{
+			unsigned int* q = &ib[(y * 8 + x) * 6];
+
+			q[0] = y * 9 + x;
+			q[1] = y * 9 + x + 1;
+			q[2] = (y + 1) * 9 + x;
+			q[3] = (y + 1) * 9 + x;
+			q[4] = y * 9 + x + 1;
+			q[5] = (y + 1) * 9 + x + 1;
+		}
+
+	unsigned int expected[8 * 8 * 6];
+	size_t expected_count = meshopt_simplify(expected, ib, 8 * 8 * 6, vb[0], 9 * 9, 12, 6, 1e-2f);
+	assert(expected_count == 6);
+
+	unsigned int result[8 * 8 * 6];
+	float error = 0;
+
+	// zero weights match position-only simplification
+	const float zero[2] = {0, 0};
+	assert(meshopt_simplifyWithAttributes(result, ib, 8 * 8 * 6, vb[0], 9 * 9, 12, ab[0], 8, zero, 2, NULL, 6, 1e-2f) == expected_count);
+	assert(memcmp(result, expected, expected_count * sizeof(unsigned int)) == 0);
+
+	// linearly varying attributes can be interpolated exactly so they don't restrict simplification
+	const float linear[2] = {1, 0};
+	assert(meshopt_simplifyWithAttributes(result, ib, 8 * 8 * 6, vb[0], 9 * 9, 12, ab[0], 8, linear, 2, NULL, 6, 1e-2f, &error) == 6);
+	assert(error < 1e-3f);
+
+	// the spike in the center can't be removed without exceeding the error limit
+	const float spike[2] = {0, 1};
+	size_t count = meshopt_simplifyWithAttributes(result, ib, 8 * 8 * 6, vb[0], 9 * 9, 12, ab[0], 8, spike, 2, NULL, 6, 1e-2f, &error);
+	assert(count > 6);
+	assert(error <= 1e-2f);
+
+	bool center = false;
+	for (size_t i = 0; i < count; ++i)
+		center |= result[i] == 4 * 9 + 4;
+
+	assert(center);
+}
+
+static void simplifyLock()
+{
+	// 17x17 vertex grid split into two tiles that share the x=8 column
+	const int N = 16;
+
+	std::vector<float> vb;
+	std::vector<unsigned int> grid, ib[2];
+	createGrid(vb, grid, N, 0.01f);
+
+	// grid quads are stored row by row, so the quad index determines the column
+	for (size_t i = 0; i < grid.size(); i += 6)
+	{
+		int x = int(i / 6 % N);
+
+		ib[x >= N / 2].insert(ib[x >= N / 2].end(), &grid[i], &grid[i] + 6);
+	}
+
+	std::vector<unsigned char> lock((N + 1) * (N + 1));
+
+	for (int y = 0; y <= N; ++y)
+		lock[y * (N + 1) + N / 2] = 1;
+
+	// each tile is simplified separately; the shared column must be preserved in both to avoid cracks
+	for (int tile = 0; tile < 2; ++tile)
+	{
+		std::vector<unsigned int> result(ib[tile].size());
+		result.resize(meshopt_simplifyWithAttributes(&result[0], &ib[tile][0], ib[tile].size(), &vb[0], vb.size() / 3, 12, NULL, 0, NULL, 0, &lock[0], ib[tile].size() / 10, 1e-1f));
+
+		assert(result.size() < ib[tile].size() / 2);
+
+		for (int y = 0; y <= N; ++y)
+			assert(std::find(result.begin(), result.end(), unsigned(y * (N + 1) + N / 2)) != result.end());
+	}
+
+	// when everything is locked, nothing can be simplified
+	std::fill(lock.begin(), lock.end(), 1);
+
+	std::vector<unsigned int> result(ib[0].size());
+	assert(meshopt_simplifyWithAttributes(&result[0], &ib[0][0], ib[0].size(), &vb[0], vb.size() / 3, 12, NULL, 0, NULL, 0, &lock[0], 0, 1.f) == ib[0].size());
+}
+
+static void simplifySloppyParallel()
+{
+	// 150x150 grid with a wavy surface, which is enough for several vertex and triangle jobs
+	const int N = 150;
+
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	createGrid(vb, ib, N, 0.5f);
+
+	// the second target error limits the grid size so the result is larger than the target index count
+	float targets[2] = {1e-1f, 1e-2f};
+
+	for (int i = 0; i < 2; ++i)
+	{
+		std::vector<unsigned int> expected(ib.size());
+		float expected_error = 0;
+		expected.resize(meshopt_simplifySloppy(&expected[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, ib.size() / 20, targets[i], &expected_error));
+		assert(expected.size() > 0);
+
+		std::vector<unsigned int> result(ib.size());
+		float result_error = 0;
+		int dispatches = 0;
+		result.resize(meshopt_simplifySloppyParallel(&result[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, ib.size() / 20, targets[i], &result_error, dispatchReverse, &dispatches));
+
+		assert(result == expected);
+		assert(result_error == expected_error);
+		assert(dispatches > 0);
+
+		// NULL dispatch runs all jobs serially
+		result.resize(ib.size());
+		result.resize(meshopt_simplifySloppyParallel(&result[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, ib.size() / 20, targets[i], NULL, NULL, NULL));
+
+		assert(result == expected);
+	}
+}
+
+static void simplifyLodChain()
+{
+	// 41x41 vertex grid with a wavy surface
+	const int N = 40;
+
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	createGrid(vb, ib, N, 0.1f);
+
+	const size_t lod_count = 3;
+	size_t targets[lod_count] = {ib.size() / 2, ib.size() / 8, 0};
+	float errors[lod_count] = {1e-2f, 5e-2f, 1e-1f};
+
+	std::vector<unsigned int> lods(ib.size() * lod_count);
+	size_t counts[lod_count] = {};
+	float result_errors[lod_count] = {};
+
+	size_t total = meshopt_simplifyLodChain(&lods[0], counts, &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, targets, errors, lod_count, result_errors);
+	assert(total == counts[0] + counts[1] + counts[2]);
+
+	// the first level matches a regular simplification with the same target
+	std::vector<unsigned int> expected(ib.size());
+	float expected_error = 0;
+	expected.resize(meshopt_simplify(&expected[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, targets[0], errors[0], &expected_error));
+
+	assert(counts[0] == expected.size());
+	assert(memcmp(&lods[0], &expected[0], expected.size() * sizeof(unsigned int)) == 0);
+	assert(result_errors[0] == expected_error);
+
+	// every level is coarser than the previous one and only uses vertices from it
+	std::vector<unsigned char> used(vb.size() / 3);
+	size_t offset = 0;
+
+	for (size_t lod = 0; lod < lod_count; ++lod)
+	{
+		assert(lod == 0 || (counts[lod] < counts[lod - 1] && result_errors[lod] >= result_errors[lod - 1]));
+		assert(result_errors[lod] <= errors[lod]);
+
+		for (size_t i = 0; i < counts[lod]; ++i)
+			assert(lod == 0 || used[lods[offset + i]]);
+
+		std::fill(used.begin(), used.end(), 0);
+
+		for (size_t i = 0; i < counts[lod]; ++i)
+			used[lods[offset + i]] = 1;
+
+		offset += counts[lod];
+	}
+}
+
+static void simplifyContext()
+{
+	const int N = 30;
+
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	createGrid(vb, ib, N, 0.f);
+
+	for (int y = 0; y <= N; ++y)
+		for (int x = 0; x <= N; ++x)
+			vb[(y * (N + 1) + x) * 3 + 2] = float((x * 3 + y * 5) % 7) * 0.05f;
+
+	meshopt_SimplifierContext* context = meshopt_createSimplifierContext(&ib[0], ib.size(), &vb[0], vb.size() / 3, 12);
+
+	// queries in arbitrary order match independent simplification runs
+	size_t targets[4] = {ib.size() / 4, ib.size() / 2, 0, ib.size() / 4};
+	float errors[4] = {1e-2f, 1e-1f, 5e-2f, 1e-2f};
+
+	std::vector<unsigned int> result(ib.size());
+	std::vector<unsigned int> expected(ib.size());
+
+	for (int i = 0; i < 4; ++i)
+	{
+		float result_error = 0, expected_error = 0;
+		size_t result_size = meshopt_simplifyWithContext(context, &result[0], targets[i], errors[i], &result_error);
+		size_t expected_size = meshopt_simplify(&expected[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, targets[i], errors[i], &expected_error);
+
+		assert(result_size == expected_size && result_size < ib.size());
+		assert(memcmp(&result[0], &expected[0], result_size * sizeof(unsigned int)) == 0);
+		assert(result_error == expected_error);
+	}
+
+	meshopt_destroySimplifierContext(context);
+}
+
+static size_t budgetAllocated;
+static size_t budgetPeak;
+
+static void* budgetAlloc(size_t size)
+{
+	size_t* result = static_cast<size_t*>(malloc(size + sizeof(size_t) * 2));
+	result[0] = size;
+
+	budgetAllocated += size;
+	budgetPeak = budgetPeak < budgetAllocated ? budgetAllocated : budgetPeak;
+
+	return result + 2;
+}
+
+static void budgetFree(void* ptr)
+{
+	size_t* block = static_cast<size_t*>(ptr) - 2;
+	budgetAllocated -= block[0];
+
+	free(block);
+}
+
+static void simplifyOutOfCore()
+{
+	const int N = 60;
+
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	createGrid(vb, ib, N, 0.1f);
+
+	// the budget is much smaller than what meshopt_simplify needs for this mesh, so the mesh is processed in batches
+	const size_t budget = 256 * 1024;
+	size_t target = ib.size() / 20 / 3 * 3;
+
+	std::vector<unsigned int> result(ib.size());
+	float error = 0;
+
+	meshopt_setAllocator(budgetAlloc, budgetFree);
+	result.resize(meshopt_simplifyOutOfCore(&result[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, target, 1e-1f, &error, budget));
+	meshopt_setAllocator(operator new, operator delete);
+
+	assert(budgetAllocated == 0 && budgetPeak <= budget);
+	assert(result.size() <= target && result.size() > target / 2);
+	assert(error <= 1e-1f);
+
+	for (size_t i = 0; i < result.size(); ++i)
+		assert(result[i] < vb.size() / 3);
+
+	// the grid border can't move, so the corners must be preserved
+	unsigned int corners[4] = {0, unsigned(N), unsigned(N * (N + 1)), unsigned(N * (N + 1) + N)};
+
+	for (int k = 0; k < 4; ++k)
+		assert(std::find(result.begin(), result.end(), corners[k]) != result.end());
+
+	budgetPeak = 0;
+}
+
+static void clusterLod()
+{
+	const int N = 40;
+
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	createGrid(vb, ib, N, 0.1f);
+
+	const size_t max_vertices = 64;
+	const size_t max_triangles = 64;
+
+	size_t capacity = meshopt_buildClusterLodBound(ib.size(), max_vertices, max_triangles);
+	std::vector<meshopt_LodCluster> clusters(capacity);
+	std::vector<unsigned int> cluster_vertices(capacity * max_vertices);
+	std::vector<unsigned char> cluster_triangles(capacity * max_triangles * 3);
+
+	clusters.resize(meshopt_buildClusterLod(&clusters[0], &cluster_vertices[0], &cluster_triangles[0], capacity, &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, max_vertices, max_triangles));
+
+	size_t roots = 0;
+	unsigned int max_level = 0;
+
+	for (size_t i = 0; i < clusters.size(); ++i)
+	{
+		const meshopt_LodCluster& cluster = clusters[i];
+
+		assert(cluster.error <= cluster.parent_error);
+		assert((cluster.level == 0) == (cluster.group == ~0u));
+		assert((cluster.parent_group == ~0u) == (cluster.parent_error == FLT_MAX));
+
+		roots += cluster.parent_group == ~0u;
+		max_level = max_level < cluster.level ? cluster.level : max_level;
+	}
+
+	// the hierarchy should reduce the mesh to a few clusters
+	assert(max_level >= 3 && roots < clusters.size() / 8);
+
+	// any cut through the DAG must be crack-free: edges that are only used once must be on the border of the grid
+	float thresholds[] = {0.f, 0.05f, 0.2f, 1.f, 1e9f};
+
+	for (size_t t = 0; t < sizeof(thresholds) / sizeof(thresholds[0]); ++t)
+	{
+		std::vector<unsigned long long> edges;
+
+		for (size_t i = 0; i < clusters.size(); ++i)
+		{
+			const meshopt_LodCluster& cluster = clusters[i];
+
+			if (cluster.error > thresholds[t] || cluster.parent_error <= thresholds[t])
+				continue;
+
+			for (size_t j = 0; j < cluster.triangle_count * 3; ++j)
+			{
+				unsigned int a = cluster_vertices[cluster.vertex_offset + cluster_triangles[cluster.triangle_offset + j]];
+				unsigned int b = cluster_vertices[cluster.vertex_offset + cluster_triangles[cluster.triangle_offset + (j % 3 == 2 ? j - 2 : j + 1)]];
+
+				edges.push_back(a < b ? (unsigned long long)(a) << 32 | b : (unsigned long long)(b) << 32 | a);
+			}
+		}
+
+		std::sort(edges.begin(), edges.end());
+
+		for (size_t i = 0; i < edges.size(); ++i)
+		{
+			if ((i > 0 && edges[i - 1] == edges[i]) || (i + 1 < edges.size() && edges[i + 1] == edges[i]))
+				continue;
+
+			unsigned int a = unsigned(edges[i] >> 32), b = unsigned(edges[i]);
+			int ax = a % (N + 1), ay = a / (N + 1), bx = b % (N + 1), by = b / (N + 1);
+
+			assert((ax == bx && (ax == 0 || ax == N)) || (ay == by && (ay == 0 || ay == N)));
+		}
+	}
+}
+
 static void simplifyScale()
 {
 	const float vb[] = {0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 3};
@@ -824,6 +2264,77 @@ static void simplifyScale()
 	assert(meshopt_simplifyScale(vb, 4, 12) == 3.f);
 }
 
+static void hausdorffDistance()
+{
+	// unit square split in two halves at x = 0.5, plus a copy of the square at z = 0.25
+	const float vb[] = {
+	    0, 0, 0, 0.5f, 0, 0, 1, 0, 0,
+	    0, 1, 0, 0.5f, 1, 0, 1, 1, 0,
+	    0, 0, 0.25f, 1, 0, 0.25f, 0, 1, 0.25f, 1, 1, 0.25f};
+
+	const unsigned int full[] = {0, 2, 3, 3, 2, 5};
+	const unsigned int half[] = {0, 1, 3, 3, 1, 4};
+	const unsigned int both[] = {0, 1, 3, 3, 1, 4, 1, 2, 4, 4, 2, 5};
+	const unsigned int copy[] = {6, 7, 8, 8, 7, 9};
+
+	// identical surfaces, even with different triangulations
+	assert(meshopt_computeHausdorffDistance(full, 6, full, 6, vb, 10, 12) == 0.f);
+	assert(meshopt_computeHausdorffDistance(both, 12, full, 6, vb, 10, 12) < 1e-5f);
+	assert(meshopt_computeHausdorffDistance(full, 6, both, 12, vb, 10, 12) < 1e-5f);
+
+	// the distance is one-sided: every point of the half is on the full square, but the far edge of the full square is 0.5 away from the half
+	assert(meshopt_computeHausdorffDistance(half, 6, full, 6, vb, 10, 12) < 1e-5f);
+
+	float d = meshopt_computeHausdorffDistance(full, 6, half, 6, vb, 10, 12);
+	assert(d >= 0.5f && d <= 0.5f * 1.04f);
+
+	// parallel squares
+	d = meshopt_computeHausdorffDistance(full, 6, copy, 6, vb, 10, 12);
+	assert(d >= 0.25f && d <= 0.25f * 1.04f);
+
+	d = meshopt_computeHausdorffDistance(copy, 6, full, 6, vb, 10, 12);
+	assert(d >= 0.25f && d <= 0.25f * 1.04f);
+
+	// empty meshes
+	assert(meshopt_computeHausdorffDistance(NULL, 0, full, 6, vb, 10, 12) == 0.f);
+	assert(meshopt_computeHausdorffDistance(full, 6, NULL, 0, vb, 10, 12) > 1e30f);
+}
+
+static void simplifyIndexAdapter()
+{
+	const int N = 20;
+
+	std::vector<float> vb;
+	std::vector<unsigned int> ib;
+	createGrid(vb, ib, N, 0.1f);
+
+	std::vector<unsigned short> ibs(ib.begin(), ib.end());
+
+	// 16-bit overloads must produce the same results as 32-bit functions
+	const size_t lod_count = 2;
+	size_t targets[lod_count] = {ib.size() / 2, ib.size() / 8};
+	float errors[lod_count] = {1e-2f, 1e-1f};
+
+	std::vector<unsigned int> lods(ib.size() * lod_count);
+	std::vector<unsigned short> lodss(ib.size() * lod_count);
+	size_t counts[lod_count] = {}, countss[lod_count] = {};
+
+	size_t total = meshopt_simplifyLodChain(&lods[0], counts, &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, targets, errors, lod_count);
+	assert(meshopt_simplifyLodChain(&lodss[0], countss, &ibs[0], ibs.size(), &vb[0], vb.size() / 3, 12, targets, errors, lod_count) == total);
+	assert(counts[0] == countss[0] && counts[1] == countss[1]);
+	assert(std::equal(lods.begin(), lods.begin() + total, lodss.begin()));
+
+	std::vector<unsigned int> result(ib.size());
+	std::vector<unsigned short> results(ib.size());
+
+	result.resize(meshopt_simplifyOutOfCore(&result[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, ib.size() / 10, 1e-1f, NULL, 16 * 1024));
+	results.resize(meshopt_simplifyOutOfCore(&results[0], &ibs[0], ibs.size(), &vb[0], vb.size() / 3, 12, ib.size() / 10, 1e-1f, NULL, 16 * 1024));
+	assert(result.size() == results.size() && std::equal(result.begin(), result.end(), results.begin()));
+
+	float d = meshopt_computeHausdorffDistance(&result[0], result.size(), &ib[0], ib.size(), &vb[0], vb.size() / 3, 12);
+	assert(meshopt_computeHausdorffDistance(&results[0], results.size(), &ibs[0], ibs.size(), &vb[0], vb.size() / 3, 12) == d);
+}
+
 static void adjacency()
 {
 	// 0 1/4
@@ -894,6 +2405,9 @@ static void runTestsOnce()
 	decodeIndexRejectInvalidVersion();
 	decodeIndexMalformedVByte();
 	roundtripIndexTricky();
+	roundtripIndexLarge();
+	encodeIndexV2();
+	decodeIndexRange();
 	encodeIndexEmpty();
 
 	decodeIndexSequence();
@@ -906,6 +2420,7 @@ static void runTestsOnce()
 	encodeIndexSequenceEmpty();
 
 	decodeVertexV0();
+	encodeVertexV0();
 	encodeVertexMemorySafe();
 	decodeVertexMemorySafe();
 	decodeVertexRejectExtraBytes();
@@ -913,14 +2428,30 @@ static void runTestsOnce()
 	decodeVertexBitGroups();
 	decodeVertexBitGroupSentinels();
 	decodeVertexLarge();
+	decodeVertexParallel();
+	decodeVertexV1();
+	decodeVertexV1MemorySafe();
+	decodeVertexRange();
+	decodeVertexStreaming();
+	decodeVertexStreamingLargeBlock();
+	decodeVertexRejectInvalidVersion();
 	encodeVertexEmpty();
 
 	decodeFilterOct8();
 	decodeFilterOct12();
 	decodeFilterQuat12();
 	decodeFilterExp();
+	decodeVertexFiltered();
 
 	clusterBoundsDegenerate();
+	computeMeshletBoundsBatch();
+	buildMeshletsParallel();
+	buildMeshletsSpatial();
+	optimizeMeshlet();
+	optimizeMeshletUnused();
+	encodeMeshlet();
+	encodeMeshletLarge();
+	decodeMeshletMemorySafe();
 
 	customAllocator();
 
@@ -930,7 +2461,16 @@ static void runTestsOnce()
 	simplifySloppyStuck();
 	simplifyPointsStuck();
 	simplifyFlip();
+	simplifyAttributes();
+	simplifyLock();
+	simplifySloppyParallel();
+	simplifyLodChain();
+	simplifyContext();
+	simplifyOutOfCore();
+	clusterLod();
 	simplifyScale();
+	hausdorffDistance();
+	simplifyIndexAdapter();
 
 	adjacency();
 	tessellation();
@@ -938,22 +2478,26 @@ static void runTestsOnce()
 
 namespace meshopt
 {
-extern unsigned int cpuid;
+extern int gSimdLevel;
 }
 
 void runTests()
 {
 	runTestsOnce();
 
-#if !(defined(__AVX__) || defined(__SSSE3__)) && (defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__))
-	// When SSSE3/AVX support isn't enabled unconditionally, we use a cpuid-based fallback
-	// It's useful to be able to test scalar code in this case, so we temporarily fake the feature bits
-	// and restore them later
-	unsigned int cpuid = meshopt::cpuid;
-	meshopt::cpuid = 0;
+	// SIMD kernels are selected at runtime based on the SIMD level detected from cpuid
+	// It's useful to be able to test all kernels supported by the hardware, so we temporarily lower the level
+	// and restore it later; levels that don't have a dedicated kernel on this platform reuse the closest one
+	int level = meshopt::gSimdLevel;
 
-	runTestsOnce();
+	for (int i = level - 1; i >= 0; --i)
+	{
+		meshopt::gSimdLevel = i;
+
+		runTestsOnce();
+	}
+
+	meshopt::gSimdLevel = level;
 
-	meshopt::cpuid = cpuid;
-#endif
+	assert(meshopt_getSimdLevel() == level);
 }
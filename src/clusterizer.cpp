@@ -6,6 +6,9 @@
 #include <math.h>
 #include <string.h>
 
+#include "internal.h"
+#include "simd.h"
+
 // This work is based on:
 // Graham Wihlidal. Optimizing the Graphics Pipeline with Compute. 2016
 // Matthaeus Chajdas. GeometryFX 1.2 - Cluster Culling. 2016
@@ -26,15 +29,10 @@ struct TriangleAdjacency2
 	unsigned int* data;
 };
 
-static void buildTriangleAdjacency(TriangleAdjacency2& adjacency, const unsigned int* indices, size_t index_count, size_t vertex_count, meshopt_Allocator& allocator)
+static void buildTriangleAdjacency(TriangleAdjacency2& adjacency, const unsigned int* indices, size_t index_count, size_t vertex_count)
 {
 	size_t face_count = index_count / 3;
 
-	// allocate arrays
-	adjacency.counts = allocator.allocate<unsigned int>(vertex_count);
-	adjacency.offsets = allocator.allocate<unsigned int>(vertex_count);
-	adjacency.data = allocator.allocate<unsigned int>(index_count);
-
 	// fill triangle counts
 	memset(adjacency.counts, 0, vertex_count * sizeof(unsigned int));
 
@@ -145,6 +143,38 @@ static void computeBoundingSphere(float result[4], const float points[][3], size
 	result[3] = radius;
 }
 
+static void computeBoundsCone(meshopt_Bounds& bounds, const float center[3], const float axis[3], float mindp, float maxt)
+{
+	// cone apex should be in the negative half-space of all cluster triangles by construction
+	bounds.cone_apex[0] = center[0] - axis[0] * maxt;
+	bounds.cone_apex[1] = center[1] - axis[1] * maxt;
+	bounds.cone_apex[2] = center[2] - axis[2] * maxt;
+
+	// note: this axis is the axis of the normal cone, but our test for perspective camera effectively negates the axis
+	bounds.cone_axis[0] = axis[0];
+	bounds.cone_axis[1] = axis[1];
+	bounds.cone_axis[2] = axis[2];
+
+	// cos(a) for normal cone is mindp; we need to add 90 degrees on both sides and invert the cone
+	// which gives us -cos(a+90) = -(-sin(a)) = sin(a) = sqrt(1 - cos^2(a))
+	bounds.cone_cutoff = sqrtf(1 - mindp * mindp);
+
+	// quantize axis & cutoff to 8-bit SNORM format
+	bounds.cone_axis_s8[0] = (signed char)(meshopt_quantizeSnorm(bounds.cone_axis[0], 8));
+	bounds.cone_axis_s8[1] = (signed char)(meshopt_quantizeSnorm(bounds.cone_axis[1], 8));
+	bounds.cone_axis_s8[2] = (signed char)(meshopt_quantizeSnorm(bounds.cone_axis[2], 8));
+
+	// for the 8-bit test to be conservative, we need to adjust the cutoff by measuring the max. error
+	float cone_axis_s8_e0 = fabsf(bounds.cone_axis_s8[0] / 127.f - bounds.cone_axis[0]);
+	float cone_axis_s8_e1 = fabsf(bounds.cone_axis_s8[1] / 127.f - bounds.cone_axis[1]);
+	float cone_axis_s8_e2 = fabsf(bounds.cone_axis_s8[2] / 127.f - bounds.cone_axis[2]);
+
+	// note that we need to round this up instead of rounding to nearest, hence +1
+	int cone_cutoff_s8 = int(127 * (bounds.cone_cutoff + cone_axis_s8_e0 + cone_axis_s8_e1 + cone_axis_s8_e2) + 1);
+
+	bounds.cone_cutoff_s8 = (cone_cutoff_s8 > 127) ? 127 : (signed char)(cone_cutoff_s8);
+}
+
 struct Cone
 {
 	float px, py, pz;
@@ -436,73 +466,69 @@ static void kdtreeNearest(KDNode* nodes, unsigned int root, const float* points,
 	}
 }
 
-} // namespace meshopt
-
-size_t meshopt_buildMeshletsBound(size_t index_count, size_t max_vertices, size_t max_triangles)
+struct MeshletScratch
 {
-	using namespace meshopt;
+	// counts and offsets have an element per vertex, data has an element per index
+	TriangleAdjacency2 adjacency;
+
+	// per vertex
+	unsigned int* live_triangles;
+	unsigned char* used;
+
+	// per triangle; nodes has two elements per triangle
+	unsigned char* emitted_flags;
+	Cone* triangles;
+	unsigned int* kdindices;
+	KDNode* nodes;
+};
 
-	assert(index_count % 3 == 0);
-	assert(max_vertices >= 3 && max_vertices <= kMeshletMaxVertices);
-	assert(max_triangles >= 1 && max_triangles <= kMeshletMaxTriangles);
-	assert(max_triangles % 4 == 0); // ensures the caller will compute output space properly as index data is 4b aligned
+static void allocateMeshletScratch(MeshletScratch& scratch, size_t index_count, size_t vertex_count, meshopt_Allocator& allocator)
+{
+	size_t face_count = index_count / 3;
 
-	(void)kMeshletMaxVertices;
-	(void)kMeshletMaxTriangles;
+	scratch.adjacency.counts = allocator.allocate<unsigned int>(vertex_count);
+	scratch.adjacency.offsets = allocator.allocate<unsigned int>(vertex_count);
+	scratch.adjacency.data = allocator.allocate<unsigned int>(index_count);
 
-	// meshlet construction is limited by max vertices and max triangles per meshlet
-	// the worst case is that the input is an unindexed stream since this equally stresses both limits
-	// note that we assume that in the worst case, we leave 2 vertices unpacked in each meshlet - if we have space for 3 we can pack any triangle
-	size_t max_vertices_conservative = max_vertices - 2;
-	size_t meshlet_limit_vertices = (index_count + max_vertices_conservative - 1) / max_vertices_conservative;
-	size_t meshlet_limit_triangles = (index_count / 3 + max_triangles - 1) / max_triangles;
+	scratch.live_triangles = allocator.allocate<unsigned int>(vertex_count);
+	scratch.used = allocator.allocate<unsigned char>(vertex_count);
 
-	return meshlet_limit_vertices > meshlet_limit_triangles ? meshlet_limit_vertices : meshlet_limit_triangles;
+	scratch.emitted_flags = allocator.allocate<unsigned char>(face_count);
+	scratch.triangles = allocator.allocate<Cone>(face_count);
+	scratch.kdindices = allocator.allocate<unsigned int>(face_count);
+	scratch.nodes = allocator.allocate<KDNode>(face_count * 2);
 }
 
-size_t meshopt_buildMeshlets(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight)
+// scratch.triangles must be filled by computeTriangleCones (which also returns mesh_area) before calling this
+static size_t buildMeshlets(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, size_t vertex_count, float mesh_area, size_t max_vertices, size_t max_triangles, float cone_weight, MeshletScratch& scratch)
 {
-	using namespace meshopt;
-
-	assert(index_count % 3 == 0);
-	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
-	assert(vertex_positions_stride % sizeof(float) == 0);
-
-	assert(max_vertices >= 3 && max_vertices <= kMeshletMaxVertices);
-	assert(max_triangles >= 1 && max_triangles <= kMeshletMaxTriangles);
-	assert(max_triangles % 4 == 0); // ensures the caller will compute output space properly as index data is 4b aligned
-
-	meshopt_Allocator allocator;
-
-	TriangleAdjacency2 adjacency = {};
-	buildTriangleAdjacency(adjacency, indices, index_count, vertex_count, allocator);
+	TriangleAdjacency2& adjacency = scratch.adjacency;
+	buildTriangleAdjacency(adjacency, indices, index_count, vertex_count);
 
-	unsigned int* live_triangles = allocator.allocate<unsigned int>(vertex_count);
+	unsigned int* live_triangles = scratch.live_triangles;
 	memcpy(live_triangles, adjacency.counts, vertex_count * sizeof(unsigned int));
 
 	size_t face_count = index_count / 3;
 
-	unsigned char* emitted_flags = allocator.allocate<unsigned char>(face_count);
+	unsigned char* emitted_flags = scratch.emitted_flags;
 	memset(emitted_flags, 0, face_count);
 
-	// for each triangle, precompute centroid & normal to use for scoring
-	Cone* triangles = allocator.allocate<Cone>(face_count);
-	float mesh_area = computeTriangleCones(triangles, indices, index_count, vertex_positions, vertex_count, vertex_positions_stride);
+	const Cone* triangles = scratch.triangles;
 
 	// assuming each meshlet is a square patch, expected radius is sqrt(expected area)
 	float triangle_area_avg = face_count == 0 ? 0.f : mesh_area / float(face_count) * 0.5f;
 	float meshlet_expected_radius = sqrtf(triangle_area_avg * max_triangles) * 0.5f;
 
 	// build a kd-tree for nearest neighbor lookup
-	unsigned int* kdindices = allocator.allocate<unsigned int>(face_count);
+	unsigned int* kdindices = scratch.kdindices;
 	for (size_t i = 0; i < face_count; ++i)
 		kdindices[i] = unsigned(i);
 
-	KDNode* nodes = allocator.allocate<KDNode>(face_count * 2);
+	KDNode* nodes = scratch.nodes;
 	kdtreeBuild(0, nodes, face_count * 2, &triangles[0].px, sizeof(Cone) / sizeof(float), kdindices, face_count, /* leaf_size= */ 8);
 
 	// index of the vertex in the meshlet, 0xff if the vertex isn't used
-	unsigned char* used = allocator.allocate<unsigned char>(vertex_count);
+	unsigned char* used = scratch.used;
 	memset(used, -1, vertex_count);
 
 	meshopt_Meshlet meshlet = {};
@@ -639,198 +665,1360 @@ size_t meshopt_buildMeshlets(meshopt_Meshlet* meshlets, unsigned int* meshlet_ve
 		meshlets[meshlet_offset++] = meshlet;
 	}
 
-	assert(meshlet_offset <= meshopt_buildMeshletsBound(index_count, max_vertices, max_triangles));
 	return meshlet_offset;
 }
 
-size_t meshopt_buildMeshletsScan(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, size_t vertex_count, size_t max_vertices, size_t max_triangles)
+// maximum partition size used by meshopt_buildMeshletsParallel (see getMeshletPartitionSize)
+const size_t kMeshletJobTriangles = 16384;
+
+static size_t getMeshletPartitionSize(size_t max_triangles)
 {
-	using namespace meshopt;
+	// partitions are a multiple of max_triangles so that only the vertex limit can leave a partially filled meshlet at the end of a partition
+	// the size is capped by kMeshletJobTriangles so that mid-size meshes are split into enough jobs
+	return kMeshletJobTriangles / max_triangles * max_triangles;
+}
 
-	assert(index_count % 3 == 0);
+struct MeshletJobs
+{
+	meshopt_Meshlet* meshlets;
+	unsigned int* meshlet_vertices;
+	unsigned char* meshlet_triangles;
+	size_t* meshlet_counts;
+
+	const unsigned int* indices;
+	const unsigned int* local_indices;
+	const unsigned int* local_vertices;
+	const size_t* vertex_offsets;
+	size_t index_count;
+	const float* vertex_positions;
+	size_t vertex_count;
+	size_t vertex_positions_stride;
+
+	size_t max_vertices;
+	size_t max_triangles;
+	float cone_weight;
+
+	size_t partition_size;
+	size_t partition_bound;
+
+	MeshletScratch scratch;
+};
 
-	assert(max_vertices >= 3 && max_vertices <= kMeshletMaxVertices);
-	assert(max_triangles >= 1 && max_triangles <= kMeshletMaxTriangles);
-	assert(max_triangles % 4 == 0); // ensures the caller will compute output space properly as index data is 4b aligned
+static void buildMeshletsJob(void* job_data, size_t job_index)
+{
+	const MeshletJobs& jobs = *static_cast<const MeshletJobs*>(job_data);
 
-	meshopt_Allocator allocator;
+	size_t begin = job_index * jobs.partition_size * 3;
+	size_t end = begin + jobs.partition_size * 3 < jobs.index_count ? begin + jobs.partition_size * 3 : jobs.index_count;
 
-	// index of the vertex in the meshlet, 0xff if the vertex isn't used
-	unsigned char* used = allocator.allocate<unsigned char>(vertex_count);
-	memset(used, -1, vertex_count);
+	size_t vertex_begin = jobs.vertex_offsets[job_index];
+	size_t vertex_end = jobs.vertex_offsets[job_index + 1];
 
-	meshopt_Meshlet meshlet = {};
-	size_t meshlet_offset = 0;
+	// every job gets the part of the scratch space that corresponds to its triangles and vertices
+	MeshletScratch scratch = {};
+	scratch.adjacency.counts = jobs.scratch.adjacency.counts + vertex_begin;
+	scratch.adjacency.offsets = jobs.scratch.adjacency.offsets + vertex_begin;
+	scratch.adjacency.data = jobs.scratch.adjacency.data + begin;
+	scratch.live_triangles = jobs.scratch.live_triangles + vertex_begin;
+	scratch.used = jobs.scratch.used + vertex_begin;
+	scratch.emitted_flags = jobs.scratch.emitted_flags + begin / 3;
+	scratch.triangles = jobs.scratch.triangles + begin / 3;
+	scratch.kdindices = jobs.scratch.kdindices + begin / 3;
+	scratch.nodes = jobs.scratch.nodes + begin / 3 * 2;
 
-	for (size_t i = 0; i < index_count; i += 3)
-	{
-		unsigned int a = indices[i + 0], b = indices[i + 1], c = indices[i + 2];
-		assert(a < vertex_count && b < vertex_count && c < vertex_count);
+	// cones use original vertex indices since positions aren't remapped
+	float mesh_area = computeTriangleCones(scratch.triangles, jobs.indices + begin, end - begin, jobs.vertex_positions, jobs.vertex_count, jobs.vertex_positions_stride);
 
-		// appends triangle to the meshlet and writes previous meshlet to the output if full
-		meshlet_offset += appendMeshlet(meshlet, a, b, c, used, meshlets, meshlet_vertices, meshlet_triangles, meshlet_offset, max_vertices, max_triangles);
-	}
+	// every job writes to the part of the output that is large enough for the worst case number of meshlets in its partition
+	size_t meshlet_begin = job_index * jobs.partition_bound;
 
-	if (meshlet.triangle_count)
-	{
-		finishMeshlet(meshlet, meshlet_triangles);
+	meshopt_Meshlet* meshlets = jobs.meshlets + meshlet_begin;
+	unsigned int* meshlet_vertices = jobs.meshlet_vertices + meshlet_begin * jobs.max_vertices;
+	unsigned char* meshlet_triangles = jobs.meshlet_triangles + meshlet_begin * jobs.max_triangles * 3;
 
-		meshlets[meshlet_offset++] = meshlet;
-	}
+	size_t meshlet_count = buildMeshlets(meshlets, meshlet_vertices, meshlet_triangles, jobs.local_indices + begin, end - begin, vertex_end - vertex_begin, mesh_area, jobs.max_vertices, jobs.max_triangles, jobs.cone_weight, scratch);
 
-	assert(meshlet_offset <= meshopt_buildMeshletsBound(index_count, max_vertices, max_triangles));
-	return meshlet_offset;
+	// meshlet vertices are emitted back to back, so we can convert them to original vertex indices in one pass
+	size_t vertex_size = meshlet_count ? meshlets[meshlet_count - 1].vertex_offset + meshlets[meshlet_count - 1].vertex_count : 0;
+
+	for (size_t i = 0; i < vertex_size; ++i)
+		meshlet_vertices[i] = jobs.local_vertices[vertex_begin + meshlet_vertices[i]];
+
+	jobs.meshlet_counts[job_index] = meshlet_count;
 }
 
-meshopt_Bounds meshopt_computeClusterBounds(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
+// meshopt_buildMeshletsSpatial doesn't use triangle indices within meshlets for anything but storage, so it can go above kMeshletMaxTriangles
+const size_t kMeshletMaxTrianglesSpatial = 1024;
+
+static void sortTriangles(unsigned int* order, unsigned int* scratch, const unsigned int* keys, size_t count)
 {
-	using namespace meshopt;
+	unsigned int hist[1024][3];
+	memset(hist, 0, sizeof(hist));
 
-	assert(index_count % 3 == 0);
-	assert(index_count / 3 <= kMeshletMaxTriangles);
-	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
-	assert(vertex_positions_stride % sizeof(float) == 0);
+	// compute 3 10-bit histograms in parallel
+	for (size_t i = 0; i < count; ++i)
+	{
+		unsigned int id = keys[i];
 
-	(void)vertex_count;
+		hist[(id >> 0) & 1023][0]++;
+		hist[(id >> 10) & 1023][1]++;
+		hist[(id >> 20) & 1023][2]++;
+	}
 
-	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+	unsigned int sum[3] = {};
 
-	// compute triangle normals and gather triangle corners
-	float normals[kMeshletMaxTriangles][3];
-	float corners[kMeshletMaxTriangles][3][3];
-	size_t triangles = 0;
+	// replace histogram data with prefix histogram sums in-place
+	for (int i = 0; i < 1024; ++i)
+		for (int k = 0; k < 3; ++k)
+		{
+			unsigned int h = hist[i][k];
+			hist[i][k] = sum[k];
+			sum[k] += h;
+		}
 
-	for (size_t i = 0; i < index_count; i += 3)
+	for (size_t i = 0; i < count; ++i)
+		order[i] = unsigned(i);
+
+	// 3-pass radix sort; since the number of passes is odd, the result ends up in scratch
+	unsigned int* source = order;
+	unsigned int* destination = scratch;
+
+	for (int pass = 0; pass < 3; ++pass)
 	{
-		unsigned int a = indices[i + 0], b = indices[i + 1], c = indices[i + 2];
-		assert(a < vertex_count && b < vertex_count && c < vertex_count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			unsigned int id = (keys[source[i]] >> (pass * 10)) & 1023;
 
-		const float* p0 = vertex_positions + vertex_stride_float * a;
-		const float* p1 = vertex_positions + vertex_stride_float * b;
-		const float* p2 = vertex_positions + vertex_stride_float * c;
+			destination[hist[id][pass]++] = source[i];
+		}
 
-		float p10[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
-		float p20[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+		unsigned int* temp = source;
+		source = destination;
+		destination = temp;
+	}
 
-		float normalx = p10[1] * p20[2] - p10[2] * p20[1];
-		float normaly = p10[2] * p20[0] - p10[0] * p20[2];
-		float normalz = p10[0] * p20[1] - p10[1] * p20[0];
+	memcpy(order, scratch, count * sizeof(unsigned int));
+}
 
-		float area = sqrtf(normalx * normalx + normaly * normaly + normalz * normalz);
+static float getSurfaceArea(const float box[6])
+{
+	float sx = box[3] - box[0], sy = box[4] - box[1], sz = box[5] - box[2];
 
-		// no need to include degenerate triangles - they will be invisible anyway
-		if (area == 0.f)
-			continue;
+	return sx * sy + sy * sz + sz * sx;
+}
 
-		// record triangle normals & corners for future use; normal and corner 0 define a plane equation
-		normals[triangles][0] = normalx / area;
-		normals[triangles][1] = normaly / area;
-		normals[triangles][2] = normalz / area;
-		memcpy(corners[triangles][0], p0, 3 * sizeof(float));
-		memcpy(corners[triangles][1], p1, 3 * sizeof(float));
-		memcpy(corners[triangles][2], p2, 3 * sizeof(float));
-		triangles++;
+static void mergeBox(float box[6], const float other[6])
+{
+	for (int k = 0; k < 3; ++k)
+	{
+		box[k] = other[k] < box[k] ? other[k] : box[k];
+		box[k + 3] = other[k + 3] > box[k + 3] ? other[k + 3] : box[k + 3];
 	}
+}
 
-	meshopt_Bounds bounds = {};
+static float getSplitCost(size_t count, size_t max_triangles)
+{
+	// triangle count is rounded up to a multiple of max_triangles to favor splits that produce full clusters
+	size_t rounded = (count + max_triangles - 1) / max_triangles * max_triangles;
 
-	// degenerate cluster, no valid triangles => trivial reject (cone data is 0)
-	if (triangles == 0)
-		return bounds;
+	return float(count + rounded);
+}
 
-	// compute cluster bounding sphere; we'll use the center to determine normal cone apex as well
-	float psphere[4] = {};
-	computeBoundingSphere(psphere, corners[0], triangles * 3);
+// returns the split position (number of triangles on the left side) with the lowest SAH cost, or 0 if no split is possible
+static size_t findSpatialSplit(int& best_axis, unsigned int* const orders[3], size_t count, const float* triangle_boxes, float* areas, size_t min_triangles, size_t max_triangles)
+{
+	size_t best_split = 0;
+	float best_cost = FLT_MAX;
 
-	float center[3] = {psphere[0], psphere[1], psphere[2]};
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		const unsigned int* order = orders[axis];
 
-	// treating triangle normals as points, find the bounding sphere - the sphere center determines the optimal cone axis
-	float nsphere[4] = {};
-	computeBoundingSphere(nsphere, normals, triangles);
+		float box[6] = {FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX};
 
-	float axis[3] = {nsphere[0], nsphere[1], nsphere[2]};
-	float axislength = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
-	float invaxislength = axislength == 0.f ? 0.f : 1.f / axislength;
+		// areas[i] is the surface area of the first i+1 triangles
+		for (size_t i = 0; i < count; ++i)
+		{
+			mergeBox(box, &triangle_boxes[order[i] * 6]);
+			areas[i] = getSurfaceArea(box);
+		}
 
-	axis[0] *= invaxislength;
-	axis[1] *= invaxislength;
-	axis[2] *= invaxislength;
+		float rbox[6] = {FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX};
 
-	// compute a tight cone around all normals, mindp = cos(angle/2)
-	float mindp = 1.f;
+		for (size_t i = count - 1; i >= min_triangles; --i)
+		{
+			mergeBox(rbox, &triangle_boxes[order[i] * 6]);
 
-	for (size_t i = 0; i < triangles; ++i)
-	{
-		float dp = normals[i][0] * axis[0] + normals[i][1] * axis[1] + normals[i][2] * axis[2];
+			// left side has i triangles, right side has count-i triangles
+			if (count - i < min_triangles)
+				continue;
 
-		mindp = (dp < mindp) ? dp : mindp;
+			float cost = areas[i - 1] * getSplitCost(i, max_triangles) + getSurfaceArea(rbox) * getSplitCost(count - i, max_triangles);
+
+			if (cost < best_cost)
+			{
+				best_axis = axis;
+				best_split = i;
+				best_cost = cost;
+			}
+		}
 	}
 
-	// fill bounding sphere info; note that below we can return bounds without cone information for degenerate cones
-	bounds.center[0] = center[0];
-	bounds.center[1] = center[1];
-	bounds.center[2] = center[2];
-	bounds.radius = psphere[3];
+	return best_split;
+}
 
-	// degenerate cluster, normal cone is larger than a hemisphere => trivial accept
-	// note that if mindp is positive but close to 0, the triangle intersection code below gets less stable
-	// we arbitrarily decide that if a normal cone is ~168 degrees wide or more, the cone isn't useful
-	if (mindp <= 0.1f)
+static void emitSpatialMeshlets(meshopt_Meshlet& meshlet, size_t& meshlet_offset, const unsigned int* order, size_t count, const unsigned int* indices, unsigned char* used, meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, size_t max_vertices, size_t max_triangles)
+{
+	// appendMeshlet starts a new meshlet if the triangles don't fit, which only happens for partitions that couldn't be split further
+	for (size_t i = 0; i < count; ++i)
 	{
-		bounds.cone_cutoff = 1;
-		bounds.cone_cutoff_s8 = 127;
-		return bounds;
+		unsigned int a = indices[order[i] * 3 + 0], b = indices[order[i] * 3 + 1], c = indices[order[i] * 3 + 2];
+
+		meshlet_offset += appendMeshlet(meshlet, a, b, c, used, meshlets, meshlet_vertices, meshlet_triangles, meshlet_offset, max_vertices, max_triangles);
 	}
 
-	float maxt = 0;
+	// every partition ends with a new meshlet, same as when appendMeshlet runs out of space
+	meshlets[meshlet_offset++] = meshlet;
 
-	// we need to find the point on center-t*axis ray that lies in negative half-space of all triangles
-	for (size_t i = 0; i < triangles; ++i)
-	{
-		// dot(center-t*axis-corner, trinormal) = 0
-		// dot(center-corner, trinormal) - t * dot(axis, trinormal) = 0
-		float cx = center[0] - corners[i][0][0];
-		float cy = center[1] - corners[i][0][1];
-		float cz = center[2] - corners[i][0][2];
+	for (size_t j = 0; j < meshlet.vertex_count; ++j)
+		used[meshlet_vertices[meshlet.vertex_offset + j]] = 0xff;
 
-		float dc = cx * normals[i][0] + cy * normals[i][1] + cz * normals[i][2];
-		float dn = axis[0] * normals[i][0] + axis[1] * normals[i][1] + axis[2] * normals[i][2];
+	finishMeshlet(meshlet, meshlet_triangles);
 
-		// dn should be larger than mindp cutoff above
-		assert(dn > 0.f);
-		float t = dc / dn;
+	meshlet.vertex_offset += meshlet.vertex_count;
+	meshlet.triangle_offset += (meshlet.triangle_count * 3 + 3) & ~3; // 4b padding
+	meshlet.vertex_count = 0;
+	meshlet.triangle_count = 0;
+}
 
-		maxt = (t > maxt) ? t : maxt;
-	}
+// meshopt_computeMeshletBoundsBatch splits the work into jobs with this many meshlets
+const size_t kBoundsJobMeshlets = 256;
 
-	// cone apex should be in the negative half-space of all cluster triangles by construction
-	bounds.cone_apex[0] = center[0] - axis[0] * maxt;
-	bounds.cone_apex[1] = center[1] - axis[1] * maxt;
-	bounds.cone_apex[2] = center[2] - axis[2] * maxt;
+// Meshlet data for batched bounds computation is stored in SoA layout; all arrays are padded to a multiple of 4 elements with copies of the last element
+struct BoundsData
+{
+	// unique vertex positions in the order of first use by non-degenerate triangles
+	float px[kMeshletMaxVertices + 1];
+	float py[kMeshletMaxVertices + 1];
+	float pz[kMeshletMaxVertices + 1];
+
+	// triangle normals, which are gathered unnormalized, and first corners; together they define triangle planes
+	// note: sized for meshlets produced by meshopt_buildMeshletsSpatial, which can have more triangles than other builders
+	float nx[kMeshletMaxTrianglesSpatial];
+	float ny[kMeshletMaxTrianglesSpatial];
+	float nz[kMeshletMaxTrianglesSpatial];
+	float cx[kMeshletMaxTrianglesSpatial];
+	float cy[kMeshletMaxTrianglesSpatial];
+	float cz[kMeshletMaxTrianglesSpatial];
+};
 
-	// note: this axis is the axis of the normal cone, but our test for perspective camera effectively negates the axis
-	bounds.cone_axis[0] = axis[0];
-	bounds.cone_axis[1] = axis[1];
-	bounds.cone_axis[2] = axis[2];
+struct BoundsKernels
+{
+	void (*normalize)(BoundsData& data, size_t count);
+	void (*sphere)(float result[4], const float* x, const float* y, const float* z, size_t count);
+	float (*mindp)(const BoundsData& data, size_t count, const float axis[3]);
+	float (*maxt)(const BoundsData& data, size_t count, const float center[3], const float axis[3]);
+};
 
-	// cos(a) for normal cone is mindp; we need to add 90 degrees on both sides and invert the cone
-	// which gives us -cos(a+90) = -(-sin(a)) = sin(a) = sqrt(1 - cos^2(a))
-	bounds.cone_cutoff = sqrtf(1 - mindp * mindp);
+static void initBoundingSphere(float center[3], float& radius, const float* x, const float* y, const float* z, const size_t pmin[3], const size_t pmax[3])
+{
+	// find the pair of points with largest distance
+	float paxisd2 = 0;
+	int paxis = 0;
 
-	// quantize axis & cutoff to 8-bit SNORM format
-	bounds.cone_axis_s8[0] = (signed char)(meshopt_quantizeSnorm(bounds.cone_axis[0], 8));
-	bounds.cone_axis_s8[1] = (signed char)(meshopt_quantizeSnorm(bounds.cone_axis[1], 8));
-	bounds.cone_axis_s8[2] = (signed char)(meshopt_quantizeSnorm(bounds.cone_axis[2], 8));
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		size_t p1 = pmin[axis], p2 = pmax[axis];
 
-	// for the 8-bit test to be conservative, we need to adjust the cutoff by measuring the max. error
-	float cone_axis_s8_e0 = fabsf(bounds.cone_axis_s8[0] / 127.f - bounds.cone_axis[0]);
-	float cone_axis_s8_e1 = fabsf(bounds.cone_axis_s8[1] / 127.f - bounds.cone_axis[1]);
-	float cone_axis_s8_e2 = fabsf(bounds.cone_axis_s8[2] / 127.f - bounds.cone_axis[2]);
+		float d2 = (x[p2] - x[p1]) * (x[p2] - x[p1]) + (y[p2] - y[p1]) * (y[p2] - y[p1]) + (z[p2] - z[p1]) * (z[p2] - z[p1]);
 
-	// note that we need to round this up instead of rounding to nearest, hence +1
-	int cone_cutoff_s8 = int(127 * (bounds.cone_cutoff + cone_axis_s8_e0 + cone_axis_s8_e1 + cone_axis_s8_e2) + 1);
+		if (d2 > paxisd2)
+		{
+			paxisd2 = d2;
+			paxis = axis;
+		}
+	}
+
+	// use the longest segment as the initial sphere diameter
+	size_t p1 = pmin[paxis], p2 = pmax[paxis];
+
+	center[0] = (x[p1] + x[p2]) / 2;
+	center[1] = (y[p1] + y[p2]) / 2;
+	center[2] = (z[p1] + z[p2]) / 2;
+	radius = sqrtf(paxisd2) / 2;
+}
+
+static void growBoundingSphere(float center[3], float& radius, float x, float y, float z)
+{
+	float d2 = (x - center[0]) * (x - center[0]) + (y - center[1]) * (y - center[1]) + (z - center[2]) * (z - center[2]);
+
+	if (d2 > radius * radius)
+	{
+		float d = sqrtf(d2);
+		assert(d > 0);
+
+		float k = 0.5f + (radius / d) / 2;
+
+		center[0] = center[0] * k + x * (1 - k);
+		center[1] = center[1] * k + y * (1 - k);
+		center[2] = center[2] * k + z * (1 - k);
+		radius = (radius + d) / 2;
+	}
+}
+
+static void computeBoundingSphereSoA(float result[4], const float* x, const float* y, const float* z, size_t count)
+{
+	assert(count > 0);
+
+	// find extremum points along all 3 axes; for each axis we get a pair of points with min/max coordinates
+	const float* coords[3] = {x, y, z};
+	size_t pmin[3] = {0, 0, 0};
+	size_t pmax[3] = {0, 0, 0};
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		const float* v = coords[axis];
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			pmin[axis] = (v[i] < v[pmin[axis]]) ? i : pmin[axis];
+			pmax[axis] = (v[i] > v[pmax[axis]]) ? i : pmax[axis];
+		}
+	}
+
+	float center[3];
+	float radius;
+	initBoundingSphere(center, radius, x, y, z, pmin, pmax);
+
+	// iteratively adjust the sphere up until all points fit
+	for (size_t i = 0; i < count; ++i)
+		growBoundingSphere(center, radius, x[i], y[i], z[i]);
+
+	result[0] = center[0];
+	result[1] = center[1];
+	result[2] = center[2];
+	result[3] = radius;
+}
+
+static void normalizeTriangleNormals(BoundsData& data, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		float area = sqrtf(data.nx[i] * data.nx[i] + data.ny[i] * data.ny[i] + data.nz[i] * data.nz[i]);
+
+		data.nx[i] /= area;
+		data.ny[i] /= area;
+		data.nz[i] /= area;
+	}
+}
+
+static float computeConeMinDot(const BoundsData& data, size_t count, const float axis[3])
+{
+	float mindp = 1.f;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		float dp = data.nx[i] * axis[0] + data.ny[i] * axis[1] + data.nz[i] * axis[2];
+
+		mindp = (dp < mindp) ? dp : mindp;
+	}
+
+	return mindp;
+}
+
+static float computeConeMaxT(const BoundsData& data, size_t count, const float center[3], const float axis[3])
+{
+	float maxt = 0;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		float cx = center[0] - data.cx[i];
+		float cy = center[1] - data.cy[i];
+		float cz = center[2] - data.cz[i];
+
+		float dc = cx * data.nx[i] + cy * data.ny[i] + cz * data.nz[i];
+		float dn = axis[0] * data.nx[i] + axis[1] * data.ny[i] + axis[2] * data.nz[i];
+
+		// dn should be larger than mindp cutoff
+		assert(dn > 0.f);
+		float t = dc / dn;
+
+		maxt = (t > maxt) ? t : maxt;
+	}
+
+	return maxt;
+}
+
+#ifdef SIMD_SSE
+static size_t selectExtremum(const float* values, const unsigned int* indices, bool greater)
+{
+	int result = 0;
+
+	for (int k = 1; k < 4; ++k)
+	{
+		bool better = greater ? values[k] > values[result] : values[k] < values[result];
+
+		// every lane has the first index of its extremum; on ties across lanes we pick the smallest one to match the scalar version
+		if (better || (values[k] == values[result] && indices[k] < indices[result]))
+			result = k;
+	}
+
+	return indices[result];
+}
+#endif
+
+#ifdef SIMD_SSE
+SIMD_TARGET
+static void computeExtremumSimd(size_t& pmin, size_t& pmax, const float* v, size_t count)
+{
+	__m128 vmin = _mm_loadu_ps(v), vmax = vmin;
+	__m128i index = _mm_setr_epi32(0, 1, 2, 3), imin = index, imax = index;
+
+	for (size_t i = 4; i < count; i += 4)
+	{
+		__m128 p = _mm_loadu_ps(v + i);
+		index = _mm_add_epi32(index, _mm_set1_epi32(4));
+
+		// strict comparisons keep the first index of the extremum in each lane
+		__m128 lt = _mm_cmplt_ps(p, vmin);
+		__m128 gt = _mm_cmpgt_ps(p, vmax);
+
+		vmin = _mm_or_ps(_mm_and_ps(lt, p), _mm_andnot_ps(lt, vmin));
+		vmax = _mm_or_ps(_mm_and_ps(gt, p), _mm_andnot_ps(gt, vmax));
+		imin = _mm_or_si128(_mm_and_si128(_mm_castps_si128(lt), index), _mm_andnot_si128(_mm_castps_si128(lt), imin));
+		imax = _mm_or_si128(_mm_and_si128(_mm_castps_si128(gt), index), _mm_andnot_si128(_mm_castps_si128(gt), imax));
+	}
+
+	float smin[4], smax[4];
+	unsigned int jmin[4], jmax[4];
+
+	_mm_storeu_ps(smin, vmin);
+	_mm_storeu_ps(smax, vmax);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(jmin), imin);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(jmax), imax);
+
+	pmin = selectExtremum(smin, jmin, false);
+	pmax = selectExtremum(smax, jmax, true);
+}
+
+SIMD_TARGET
+static bool testOutsideSimd(const float* x, const float* y, const float* z, const float center[3], float radius)
+{
+	__m128 dx = _mm_sub_ps(_mm_loadu_ps(x), _mm_set1_ps(center[0]));
+	__m128 dy = _mm_sub_ps(_mm_loadu_ps(y), _mm_set1_ps(center[1]));
+	__m128 dz = _mm_sub_ps(_mm_loadu_ps(z), _mm_set1_ps(center[2]));
+
+	__m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+	return _mm_movemask_ps(_mm_cmpgt_ps(d2, _mm_set1_ps(radius * radius))) != 0;
+}
+
+SIMD_TARGET
+static void normalizeTriangleNormalsSimd(BoundsData& data, size_t count)
+{
+	for (size_t i = 0; i < count; i += 4)
+	{
+		__m128 nx = _mm_loadu_ps(data.nx + i), ny = _mm_loadu_ps(data.ny + i), nz = _mm_loadu_ps(data.nz + i);
+
+		__m128 area = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz)));
+
+		_mm_storeu_ps(data.nx + i, _mm_div_ps(nx, area));
+		_mm_storeu_ps(data.ny + i, _mm_div_ps(ny, area));
+		_mm_storeu_ps(data.nz + i, _mm_div_ps(nz, area));
+	}
+}
+
+SIMD_TARGET
+static float computeConeMinDotSimd(const BoundsData& data, size_t count, const float axis[3])
+{
+	__m128 ax = _mm_set1_ps(axis[0]), ay = _mm_set1_ps(axis[1]), az = _mm_set1_ps(axis[2]);
+	__m128 mindp = _mm_set1_ps(1.f);
+
+	for (size_t i = 0; i < count; i += 4)
+	{
+		__m128 dp = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(data.nx + i), ax), _mm_mul_ps(_mm_loadu_ps(data.ny + i), ay)), _mm_mul_ps(_mm_loadu_ps(data.nz + i), az));
+
+		mindp = _mm_min_ps(mindp, dp);
+	}
+
+	mindp = _mm_min_ps(mindp, _mm_shuffle_ps(mindp, mindp, _MM_SHUFFLE(2, 3, 0, 1)));
+	mindp = _mm_min_ps(mindp, _mm_shuffle_ps(mindp, mindp, _MM_SHUFFLE(1, 0, 3, 2)));
+
+	return _mm_cvtss_f32(mindp);
+}
+
+SIMD_TARGET
+static float computeConeMaxTSimd(const BoundsData& data, size_t count, const float center[3], const float axis[3])
+{
+	__m128 ax = _mm_set1_ps(axis[0]), ay = _mm_set1_ps(axis[1]), az = _mm_set1_ps(axis[2]);
+	__m128 ox = _mm_set1_ps(center[0]), oy = _mm_set1_ps(center[1]), oz = _mm_set1_ps(center[2]);
+	__m128 maxt = _mm_setzero_ps();
+
+	for (size_t i = 0; i < count; i += 4)
+	{
+		__m128 nx = _mm_loadu_ps(data.nx + i), ny = _mm_loadu_ps(data.ny + i), nz = _mm_loadu_ps(data.nz + i);
+
+		__m128 cx = _mm_sub_ps(ox, _mm_loadu_ps(data.cx + i));
+		__m128 cy = _mm_sub_ps(oy, _mm_loadu_ps(data.cy + i));
+		__m128 cz = _mm_sub_ps(oz, _mm_loadu_ps(data.cz + i));
+
+		__m128 dc = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, nx), _mm_mul_ps(cy, ny)), _mm_mul_ps(cz, nz));
+		__m128 dn = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, nx), _mm_mul_ps(ay, ny)), _mm_mul_ps(az, nz));
+
+		maxt = _mm_max_ps(maxt, _mm_div_ps(dc, dn));
+	}
+
+	maxt = _mm_max_ps(maxt, _mm_shuffle_ps(maxt, maxt, _MM_SHUFFLE(2, 3, 0, 1)));
+	maxt = _mm_max_ps(maxt, _mm_shuffle_ps(maxt, maxt, _MM_SHUFFLE(1, 0, 3, 2)));
+
+	return _mm_cvtss_f32(maxt);
+}
+#endif
+
+#ifdef SIMD_SSE
+SIMD_TARGET
+static void computeBoundingSphereSimd(float result[4], const float* x, const float* y, const float* z, size_t count)
+{
+	assert(count > 0);
+
+	// find extremum points along all 3 axes; padding elements duplicate the last point so they don't change the result
+	size_t pmin[3], pmax[3];
+	computeExtremumSimd(pmin[0], pmax[0], x, count);
+	computeExtremumSimd(pmin[1], pmax[1], y, count);
+	computeExtremumSimd(pmin[2], pmax[2], z, count);
+
+	float center[3];
+	float radius;
+	initBoundingSphere(center, radius, x, y, z, pmin, pmax);
+
+	// iteratively adjust the sphere up until all points fit; most groups of 4 points are inside the sphere and can be skipped
+	for (size_t i = 0; i < count; i += 4)
+	{
+		if (!testOutsideSimd(x + i, y + i, z + i, center, radius))
+			continue;
+
+		for (size_t j = i; j < i + 4 && j < count; ++j)
+			growBoundingSphere(center, radius, x[j], y[j], z[j]);
+	}
+
+	result[0] = center[0];
+	result[1] = center[1];
+	result[2] = center[2];
+	result[3] = radius;
+}
+#endif
+
+static meshopt_Bounds computeMeshletBoundsSoA(BoundsData& data, const BoundsKernels& kernels, const unsigned int* meshlet_vertices, const unsigned char* meshlet_triangles, size_t triangle_count, size_t meshlet_vertex_count, const float* vertex_positions, size_t vertex_count, size_t vertex_stride_float)
+{
+	assert(triangle_count <= kMeshletMaxTrianglesSpatial);
+	assert(meshlet_vertex_count <= kMeshletMaxVertices);
+
+	(void)vertex_count;
+
+	unsigned char used[kMeshletMaxVertices];
+	memset(used, 0, meshlet_vertex_count);
+
+	size_t points = 0;
+	size_t triangles = 0;
+
+	for (size_t i = 0; i < triangle_count; ++i)
+	{
+		unsigned int corners[3] = {meshlet_triangles[i * 3 + 0], meshlet_triangles[i * 3 + 1], meshlet_triangles[i * 3 + 2]};
+		assert(corners[0] < meshlet_vertex_count && corners[1] < meshlet_vertex_count && corners[2] < meshlet_vertex_count);
+
+		unsigned int a = meshlet_vertices[corners[0]], b = meshlet_vertices[corners[1]], c = meshlet_vertices[corners[2]];
+		assert(a < vertex_count && b < vertex_count && c < vertex_count);
+
+		const float* p[3] = {vertex_positions + vertex_stride_float * a, vertex_positions + vertex_stride_float * b, vertex_positions + vertex_stride_float * c};
+
+		float p10[3] = {p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2]};
+		float p20[3] = {p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2]};
+
+		float normalx = p10[1] * p20[2] - p10[2] * p20[1];
+		float normaly = p10[2] * p20[0] - p10[0] * p20[2];
+		float normalz = p10[0] * p20[1] - p10[1] * p20[0];
+
+		// no need to include degenerate triangles - they will be invisible anyway; note that sqrt(area2) == 0 iff area2 == 0
+		float area2 = normalx * normalx + normaly * normaly + normalz * normalz;
+
+		if (area2 == 0.f)
+			continue;
+
+		data.nx[triangles] = normalx;
+		data.ny[triangles] = normaly;
+		data.nz[triangles] = normalz;
+		data.cx[triangles] = p[0][0];
+		data.cy[triangles] = p[0][1];
+		data.cz[triangles] = p[0][2];
+		triangles++;
+
+		// the bounding sphere only needs each corner once, as long as the order of first use is preserved
+		for (int k = 0; k < 3; ++k)
+		{
+			if (used[corners[k]])
+				continue;
+
+			used[corners[k]] = 1;
+
+			data.px[points] = p[k][0];
+			data.py[points] = p[k][1];
+			data.pz[points] = p[k][2];
+			points++;
+		}
+	}
+
+	meshopt_Bounds bounds = {};
+
+	// degenerate cluster, no valid triangles => trivial reject (cone data is 0)
+	if (triangles == 0)
+		return bounds;
+
+	// pad all arrays to a multiple of 4 elements so that SIMD kernels can process full groups
+	for (size_t i = points; i & 3; ++i)
+	{
+		data.px[i] = data.px[points - 1];
+		data.py[i] = data.py[points - 1];
+		data.pz[i] = data.pz[points - 1];
+	}
+
+	for (size_t i = triangles; i & 3; ++i)
+	{
+		data.nx[i] = data.nx[triangles - 1];
+		data.ny[i] = data.ny[triangles - 1];
+		data.nz[i] = data.nz[triangles - 1];
+		data.cx[i] = data.cx[triangles - 1];
+		data.cy[i] = data.cy[triangles - 1];
+		data.cz[i] = data.cz[triangles - 1];
+	}
+
+	kernels.normalize(data, triangles);
+
+	// compute cluster bounding sphere; we'll use the center to determine normal cone apex as well
+	float psphere[4] = {};
+	kernels.sphere(psphere, data.px, data.py, data.pz, points);
+
+	float center[3] = {psphere[0], psphere[1], psphere[2]};
+
+	// treating triangle normals as points, find the bounding sphere - the sphere center determines the optimal cone axis
+	float nsphere[4] = {};
+	kernels.sphere(nsphere, data.nx, data.ny, data.nz, triangles);
+
+	float axis[3] = {nsphere[0], nsphere[1], nsphere[2]};
+	float axislength = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+	float invaxislength = axislength == 0.f ? 0.f : 1.f / axislength;
+
+	axis[0] *= invaxislength;
+	axis[1] *= invaxislength;
+	axis[2] *= invaxislength;
+
+	// compute a tight cone around all normals, mindp = cos(angle/2)
+	float mindp = kernels.mindp(data, triangles, axis);
+
+	bounds.center[0] = center[0];
+	bounds.center[1] = center[1];
+	bounds.center[2] = center[2];
+	bounds.radius = psphere[3];
+
+	// degenerate cluster, normal cone is larger than a hemisphere => trivial accept; see meshopt_computeClusterBounds
+	if (mindp <= 0.1f)
+	{
+		bounds.cone_cutoff = 1;
+		bounds.cone_cutoff_s8 = 127;
+		return bounds;
+	}
+
+	// find the point on center-t*axis ray that lies in negative half-space of all triangles
+	float maxt = kernels.maxt(data, triangles, center, axis);
+
+	computeBoundsCone(bounds, center, axis, mindp, maxt);
+
+	return bounds;
+}
+
+struct BoundsJobs
+{
+	meshopt_Bounds* bounds;
+	const meshopt_Meshlet* meshlets;
+	size_t meshlet_count;
+
+	const unsigned int* meshlet_vertices;
+	const unsigned char* meshlet_triangles;
+	const float* vertex_positions;
+	size_t vertex_count;
+	size_t vertex_stride_float;
+
+	BoundsKernels kernels;
+};
+
+static void computeBoundsJob(void* job_data, size_t job_index)
+{
+	const BoundsJobs& jobs = *static_cast<const BoundsJobs*>(job_data);
+
+	size_t begin = job_index * kBoundsJobMeshlets;
+	size_t end = begin + kBoundsJobMeshlets < jobs.meshlet_count ? begin + kBoundsJobMeshlets : jobs.meshlet_count;
+
+	BoundsData data;
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		const meshopt_Meshlet& m = jobs.meshlets[i];
+
+		jobs.bounds[i] = computeMeshletBoundsSoA(data, jobs.kernels, jobs.meshlet_vertices + m.vertex_offset, jobs.meshlet_triangles + m.triangle_offset, m.triangle_count, m.vertex_count, jobs.vertex_positions, jobs.vertex_count, jobs.vertex_stride_float);
+	}
+}
+
+} // namespace meshopt
+
+size_t meshopt_buildMeshletsBound(size_t index_count, size_t max_vertices, size_t max_triangles)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(max_vertices >= 3 && max_vertices <= kMeshletMaxVertices);
+	assert(max_triangles >= 1 && max_triangles <= kMeshletMaxTriangles);
+	assert(max_triangles % 4 == 0); // ensures the caller will compute output space properly as index data is 4b aligned
+
+	(void)kMeshletMaxVertices;
+	(void)kMeshletMaxTriangles;
+
+	// meshlet construction is limited by max vertices and max triangles per meshlet
+	// the worst case is that the input is an unindexed stream since this equally stresses both limits
+	// note that we assume that in the worst case, we leave 2 vertices unpacked in each meshlet - if we have space for 3 we can pack any triangle
+	size_t max_vertices_conservative = max_vertices - 2;
+	size_t meshlet_limit_vertices = (index_count + max_vertices_conservative - 1) / max_vertices_conservative;
+	size_t meshlet_limit_triangles = (index_count / 3 + max_triangles - 1) / max_triangles;
+
+	return meshlet_limit_vertices > meshlet_limit_triangles ? meshlet_limit_vertices : meshlet_limit_triangles;
+}
+
+size_t meshopt_buildMeshlets(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+
+	assert(max_vertices >= 3 && max_vertices <= kMeshletMaxVertices);
+	assert(max_triangles >= 1 && max_triangles <= kMeshletMaxTriangles);
+	assert(max_triangles % 4 == 0); // ensures the caller will compute output space properly as index data is 4b aligned
+
+	meshopt_Allocator allocator;
+
+	MeshletScratch scratch = {};
+	allocateMeshletScratch(scratch, index_count, vertex_count, allocator);
+
+	// for each triangle, precompute centroid & normal to use for scoring
+	float mesh_area = computeTriangleCones(scratch.triangles, indices, index_count, vertex_positions, vertex_count, vertex_positions_stride);
+
+	size_t meshlet_offset = buildMeshlets(meshlets, meshlet_vertices, meshlet_triangles, indices, index_count, vertex_count, mesh_area, max_vertices, max_triangles, cone_weight, scratch);
+
+	assert(meshlet_offset <= meshopt_buildMeshletsBound(index_count, max_vertices, max_triangles));
+	return meshlet_offset;
+}
+
+size_t meshopt_buildMeshletsParallelBound(size_t index_count, size_t max_vertices, size_t max_triangles)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(max_vertices >= 3 && max_vertices <= kMeshletMaxVertices);
+	assert(max_triangles >= 1 && max_triangles <= kMeshletMaxTriangles);
+	assert(max_triangles % 4 == 0); // ensures the caller will compute output space properly as index data is 4b aligned
+
+	// every partition is clusterized separately and may end with a partially filled meshlet, so the bound is the sum of per-partition bounds
+	size_t partition_size = getMeshletPartitionSize(max_triangles);
+	size_t full_partitions = index_count / 3 / partition_size;
+	size_t last_partition = index_count / 3 - full_partitions * partition_size;
+
+	return full_partitions * meshopt_buildMeshletsBound(partition_size * 3, max_vertices, max_triangles) + meshopt_buildMeshletsBound(last_partition * 3, max_vertices, max_triangles);
+}
+
+size_t meshopt_buildMeshletsParallel(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight, meshopt_DispatchCallback dispatch, void* context)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+
+	assert(max_vertices >= 3 && max_vertices <= kMeshletMaxVertices);
+	assert(max_triangles >= 1 && max_triangles <= kMeshletMaxTriangles);
+	assert(max_triangles % 4 == 0); // ensures the caller will compute output space properly as index data is 4b aligned
+
+	meshopt_Allocator allocator;
+
+	size_t face_count = index_count / 3;
+	size_t partition_size = getMeshletPartitionSize(max_triangles);
+	size_t partition_count = (face_count + partition_size - 1) / partition_size;
+
+	// spatial order makes sure that every partition covers a compact region of the mesh
+	unsigned int* sorted_indices = allocator.allocate<unsigned int>(index_count);
+	meshopt_spatialSortTriangles(sorted_indices, indices, index_count, vertex_positions, vertex_count, vertex_positions_stride);
+
+	// every partition uses its own vertex numbering so that per-vertex scratch space is proportional to the partition size
+	unsigned int* local_indices = allocator.allocate<unsigned int>(index_count);
+	unsigned int* local_vertices = allocator.allocate<unsigned int>(index_count);
+	size_t* vertex_offsets = allocator.allocate<size_t>(partition_count + 1);
+
+	unsigned int* vertex_partition = allocator.allocate<unsigned int>(vertex_count);
+	memset(vertex_partition, -1, vertex_count * sizeof(unsigned int));
+
+	unsigned int* vertex_local = allocator.allocate<unsigned int>(vertex_count);
+
+	size_t local_vertex_count = 0;
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		unsigned int partition = unsigned(i / (partition_size * 3));
+		unsigned int v = sorted_indices[i];
+		assert(v < vertex_count);
+
+		if (i % (partition_size * 3) == 0)
+			vertex_offsets[partition] = local_vertex_count;
+
+		if (vertex_partition[v] != partition)
+		{
+			vertex_partition[v] = partition;
+			vertex_local[v] = unsigned(local_vertex_count - vertex_offsets[partition]);
+			local_vertices[local_vertex_count++] = v;
+		}
+
+		local_indices[i] = vertex_local[v];
+	}
+
+	vertex_offsets[partition_count] = local_vertex_count;
+
+	MeshletScratch scratch = {};
+	allocateMeshletScratch(scratch, index_count, local_vertex_count, allocator);
+
+	size_t* meshlet_counts = allocator.allocate<size_t>(partition_count);
+
+	size_t partition_bound = meshopt_buildMeshletsBound(partition_size * 3, max_vertices, max_triangles);
+	assert(partition_count == 0 || (partition_count - 1) * partition_bound + meshopt_buildMeshletsBound(index_count - (partition_count - 1) * partition_size * 3, max_vertices, max_triangles) == meshopt_buildMeshletsParallelBound(index_count, max_vertices, max_triangles));
+
+	MeshletJobs jobs = {meshlets, meshlet_vertices, meshlet_triangles, meshlet_counts, sorted_indices, local_indices, local_vertices, vertex_offsets, index_count, vertex_positions, vertex_count, vertex_positions_stride, max_vertices, max_triangles, cone_weight, partition_size, partition_bound, scratch};
+	dispatchJobs(dispatch, context, buildMeshletsJob, &jobs, partition_count);
+
+	// compact the results of all jobs, moving meshlet data back to back and adjusting the offsets
+	size_t meshlet_offset = 0;
+	size_t vertex_offset = 0;
+	size_t triangle_offset = 0;
+
+	for (size_t i = 0; i < partition_count; ++i)
+	{
+		const meshopt_Meshlet* partition_meshlets = meshlets + i * partition_bound;
+		size_t partition_meshlet_count = meshlet_counts[i];
+		assert(partition_meshlet_count > 0);
+
+		const meshopt_Meshlet& last = partition_meshlets[partition_meshlet_count - 1];
+		size_t vertex_size = last.vertex_offset + last.vertex_count;
+		size_t triangle_size = last.triangle_offset + ((last.triangle_count * 3 + 3) & ~3);
+
+		memmove(meshlet_vertices + vertex_offset, meshlet_vertices + i * partition_bound * max_vertices, vertex_size * sizeof(unsigned int));
+		memmove(meshlet_triangles + triangle_offset, meshlet_triangles + i * partition_bound * max_triangles * 3, triangle_size);
+
+		// the destination never comes after the source, so meshlets can be moved one by one in order
+		for (size_t j = 0; j < partition_meshlet_count; ++j)
+		{
+			meshopt_Meshlet meshlet = partition_meshlets[j];
+			meshlet.vertex_offset += unsigned(vertex_offset);
+			meshlet.triangle_offset += unsigned(triangle_offset);
+
+			meshlets[meshlet_offset++] = meshlet;
+		}
+
+		vertex_offset += vertex_size;
+		triangle_offset += triangle_size;
+	}
+
+	assert(meshlet_offset <= meshopt_buildMeshletsParallelBound(index_count, max_vertices, max_triangles));
+	return meshlet_offset;
+}
+
+size_t meshopt_buildMeshletsScan(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, size_t vertex_count, size_t max_vertices, size_t max_triangles)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+
+	assert(max_vertices >= 3 && max_vertices <= kMeshletMaxVertices);
+	assert(max_triangles >= 1 && max_triangles <= kMeshletMaxTriangles);
+	assert(max_triangles % 4 == 0); // ensures the caller will compute output space properly as index data is 4b aligned
+
+	meshopt_Allocator allocator;
+
+	// index of the vertex in the meshlet, 0xff if the vertex isn't used
+	unsigned char* used = allocator.allocate<unsigned char>(vertex_count);
+	memset(used, -1, vertex_count);
+
+	meshopt_Meshlet meshlet = {};
+	size_t meshlet_offset = 0;
+
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		unsigned int a = indices[i + 0], b = indices[i + 1], c = indices[i + 2];
+		assert(a < vertex_count && b < vertex_count && c < vertex_count);
+
+		// appends triangle to the meshlet and writes previous meshlet to the output if full
+		meshlet_offset += appendMeshlet(meshlet, a, b, c, used, meshlets, meshlet_vertices, meshlet_triangles, meshlet_offset, max_vertices, max_triangles);
+	}
+
+	if (meshlet.triangle_count)
+	{
+		finishMeshlet(meshlet, meshlet_triangles);
+
+		meshlets[meshlet_offset++] = meshlet;
+	}
+
+	assert(meshlet_offset <= meshopt_buildMeshletsBound(index_count, max_vertices, max_triangles));
+	return meshlet_offset;
+}
+
+size_t meshopt_buildMeshletsSpatialBound(size_t index_count, size_t max_vertices, size_t min_triangles)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(max_vertices >= 3 && max_vertices <= kMeshletMaxVertices);
+	assert(min_triangles >= 1);
+
+	// every partition has at least min_triangles triangles and produces one meshlet, unless it needs to be split because of the vertex limit
+	// in that case, every meshlet except the last one in the partition has at least max_vertices - 2 vertices, same as in meshopt_buildMeshletsBound
+	size_t meshlet_limit_triangles = (index_count / 3 + min_triangles - 1) / min_triangles;
+	size_t meshlet_limit_vertices = index_count / (max_vertices - 2);
+
+	return meshlet_limit_triangles + meshlet_limit_vertices;
+}
+
+size_t meshopt_buildMeshletsSpatial(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, float* meshlet_aabbs, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t min_triangles, size_t max_triangles)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+
+	assert(max_vertices >= 3 && max_vertices <= kMeshletMaxVertices);
+	assert(max_triangles >= 1 && max_triangles <= kMeshletMaxTrianglesSpatial);
+	assert(max_triangles % 4 == 0); // ensures the caller will compute output space properly as index data is 4b aligned
+	assert(min_triangles >= 1 && min_triangles <= max_triangles / 2);
+
+	(void)kMeshletMaxTrianglesSpatial;
+
+	meshopt_Allocator allocator;
+
+	size_t face_count = index_count / 3;
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+
+	// compute triangle bounding boxes and mesh bounds
+	float* triangle_boxes = allocator.allocate<float>(face_count * 6);
+	float mesh_box[6] = {FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+	for (size_t i = 0; i < face_count; ++i)
+	{
+		float* box = &triangle_boxes[i * 6];
+
+		for (int k = 0; k < 3; ++k)
+		{
+			box[k] = FLT_MAX;
+			box[k + 3] = -FLT_MAX;
+		}
+
+		for (int j = 0; j < 3; ++j)
+		{
+			unsigned int v = indices[i * 3 + j];
+			assert(v < vertex_count);
+
+			const float* p = vertex_positions + v * vertex_stride_float;
+
+			float pbox[6] = {p[0], p[1], p[2], p[0], p[1], p[2]};
+			mergeBox(box, pbox);
+		}
+
+		mergeBox(mesh_box, box);
+	}
 
-	bounds.cone_cutoff_s8 = (cone_cutoff_s8 > 127) ? 127 : (signed char)(cone_cutoff_s8);
+	// sort triangles by box centers along each axis; partitions keep these orders so that splits can be evaluated with a linear sweep
+	unsigned int* orders[3] = {};
+	unsigned int* keys = allocator.allocate<unsigned int>(face_count);
+	unsigned int* scratch = allocator.allocate<unsigned int>(face_count);
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		float extent = mesh_box[axis + 3] - mesh_box[axis];
+		float scale = extent > 0 ? 1.f / extent : 0.f;
+
+		for (size_t i = 0; i < face_count; ++i)
+		{
+			const float* box = &triangle_boxes[i * 6];
+			float center = (box[axis] + box[axis + 3]) * 0.5f;
+
+			// 30-bit fixed point position within mesh bounds
+			keys[i] = unsigned((center - mesh_box[axis]) * scale * float(1023 << 20));
+		}
+
+		orders[axis] = allocator.allocate<unsigned int>(face_count);
+		sortTriangles(orders[axis], scratch, keys, face_count);
+	}
+
+	float* areas = allocator.allocate<float>(face_count);
+	unsigned char* sides = allocator.allocate<unsigned char>(face_count);
+
+	// used for counting unique vertices in each partition
+	unsigned int* vertex_stamps = allocator.allocate<unsigned int>(vertex_count);
+	memset(vertex_stamps, -1, vertex_count * sizeof(unsigned int));
+
+	// index of the vertex in the meshlet, 0xff if the vertex isn't used
+	unsigned char* used = allocator.allocate<unsigned char>(vertex_count);
+	memset(used, -1, vertex_count);
+
+	// partitions are disjoint and non-empty, so the stack never has more than face_count entries
+	size_t* stack = allocator.allocate<size_t>(face_count * 2 + 2);
+	size_t stack_size = 0;
+
+	if (face_count)
+	{
+		stack[stack_size++] = 0;
+		stack[stack_size++] = face_count;
+	}
+
+	meshopt_Meshlet meshlet = {};
+	size_t meshlet_offset = 0;
+	unsigned int partition_id = 0;
+
+	while (stack_size)
+	{
+		size_t end = stack[--stack_size];
+		size_t begin = stack[--stack_size];
+		size_t count = end - begin;
+
+		unsigned int* const partition[3] = {orders[0] + begin, orders[1] + begin, orders[2] + begin};
+
+		size_t unique_vertices = 0;
+
+		for (size_t i = begin * 3; i < end * 3; ++i)
+		{
+			unsigned int v = indices[orders[0][i / 3] * 3 + i % 3];
+
+			unique_vertices += vertex_stamps[v] != partition_id;
+			vertex_stamps[v] = partition_id;
+		}
+
+		partition_id++;
+
+		if (count <= max_triangles && unique_vertices <= max_vertices)
+		{
+			emitSpatialMeshlets(meshlet, meshlet_offset, partition[0], count, indices, used, meshlets, meshlet_vertices, meshlet_triangles, max_vertices, max_triangles);
+			continue;
+		}
+
+		int axis = 0;
+		size_t split = count >= min_triangles * 2 ? findSpatialSplit(axis, partition, count, triangle_boxes, areas, min_triangles, max_triangles) : 0;
+
+		if (split == 0)
+		{
+			// partition is too small to split without going under min_triangles, so we split it into meshlets greedily along the longest axis
+			float box[6] = {FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+			for (size_t i = 0; i < count; ++i)
+				mergeBox(box, &triangle_boxes[partition[0][i] * 6]);
+
+			int longest = (box[4] - box[1] > box[3] - box[0]) ? 1 : 0;
+			longest = (box[5] - box[2] > box[longest + 3] - box[longest]) ? 2 : longest;
+
+			emitSpatialMeshlets(meshlet, meshlet_offset, partition[longest], count, indices, used, meshlets, meshlet_vertices, meshlet_triangles, max_vertices, max_triangles);
+			continue;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+			sides[partition[axis][i]] = i < split;
+
+		// stable partition of the other axes maintains the sort order in both halves
+		for (int k = 0; k < 3; ++k)
+		{
+			if (k == axis)
+				continue;
+
+			unsigned int* order = partition[k];
+			size_t left = 0, right = 0;
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				unsigned int tri = order[i];
+
+				if (sides[tri])
+					order[left++] = tri;
+				else
+					scratch[right++] = tri;
+			}
+
+			assert(left == split && left + right == count);
+			memcpy(order + left, scratch, right * sizeof(unsigned int));
+		}
+
+		// left partition is processed first so that meshlets come in spatially coherent order
+		stack[stack_size++] = begin + split;
+		stack[stack_size++] = end;
+		stack[stack_size++] = begin;
+		stack[stack_size++] = begin + split;
+	}
+
+	if (meshlet_aabbs)
+	{
+		for (size_t i = 0; i < meshlet_offset; ++i)
+		{
+			const meshopt_Meshlet& m = meshlets[i];
+			float* box = &meshlet_aabbs[i * 6];
+
+			for (int k = 0; k < 3; ++k)
+			{
+				box[k] = FLT_MAX;
+				box[k + 3] = -FLT_MAX;
+			}
+
+			for (size_t j = 0; j < m.vertex_count; ++j)
+			{
+				const float* p = vertex_positions + meshlet_vertices[m.vertex_offset + j] * vertex_stride_float;
+
+				float pbox[6] = {p[0], p[1], p[2], p[0], p[1], p[2]};
+				mergeBox(box, pbox);
+			}
+		}
+	}
+
+	assert(meshlet_offset <= meshopt_buildMeshletsSpatialBound(index_count, max_vertices, min_triangles));
+	return meshlet_offset;
+}
+
+void meshopt_optimizeMeshlet(unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, size_t triangle_count, size_t vertex_count)
+{
+	using namespace meshopt;
+
+	assert(triangle_count <= kMeshletMaxTrianglesSpatial);
+	assert(vertex_count <= kMeshletMaxVertices);
+
+	unsigned char* indices = meshlet_triangles;
+	unsigned int* vertices = meshlet_vertices;
+
+	// vertices used by the last few triangles are scored by age; 6 triangles is ~8-12 vertices depending on reuse
+	const unsigned int cache_window = 6;
+
+	// cache stores the timestamp of the last triangle that used each vertex; initial values are outside of the window
+	unsigned int cache[kMeshletMaxVertices];
+	memset(cache, 0, vertex_count * sizeof(unsigned int));
+
+	unsigned int timestamp = cache_window;
+
+	// live tracks the number of remaining triangles for each vertex; finishing off a vertex is preferred as it won't be needed again
+	unsigned short live[kMeshletMaxVertices];
+	memset(live, 0, vertex_count * sizeof(unsigned short));
+
+	for (size_t i = 0; i < triangle_count * 3; ++i)
+	{
+		assert(indices[i] < vertex_count);
+		live[indices[i]]++;
+	}
+
+	for (size_t i = 0; i < triangle_count; ++i)
+	{
+		size_t next = i;
+		int next_score = -1;
+
+		// pick the first remaining triangle with the highest score; ties preserve the original order which is already fairly local
+		for (size_t j = i; j < triangle_count; ++j)
+		{
+			int score = 0;
+
+			for (int k = 0; k < 3; ++k)
+			{
+				unsigned char v = indices[j * 3 + k];
+				unsigned int age = timestamp - cache[v];
+
+				score += (age < cache_window) ? int(cache_window - age) * 4 : 0;
+				score += (live[v] == 1) ? 2 : 0;
+			}
+
+			if (score > next_score)
+			{
+				next = j;
+				next_score = score;
+
+				// a triangle that shares an edge with the last triangle and finishes off a vertex is rarely beaten by later candidates
+				if (score >= int(cache_window - 1) * 4 * 2 + 2)
+					break;
+			}
+		}
+
+		unsigned char a = indices[next * 3 + 0], b = indices[next * 3 + 1], c = indices[next * 3 + 2];
+
+		// shift skipped triangles forward instead of swapping to preserve the order of the remaining triangles
+		memmove(&indices[(i + 1) * 3], &indices[i * 3], (next - i) * 3);
+
+		indices[i * 3 + 0] = a;
+		indices[i * 3 + 1] = b;
+		indices[i * 3 + 2] = c;
+
+		timestamp++;
+		cache[a] = cache[b] = cache[c] = timestamp;
+		live[a]--;
+		live[b]--;
+		live[c]--;
+	}
+
+	// reorder vertices in the order of first use, assuming the triangles are processed sequentially
+	unsigned int order[kMeshletMaxVertices];
+
+	unsigned char remap[kMeshletMaxVertices];
+	memset(remap, 0xff, vertex_count);
+
+	size_t vertex_offset = 0;
+
+	for (size_t i = 0; i < triangle_count * 3; ++i)
+	{
+		unsigned char& r = remap[indices[i]];
+
+		if (r == 0xff)
+		{
+			r = (unsigned char)(vertex_offset);
+			order[vertex_offset] = vertices[indices[i]];
+			vertex_offset++;
+		}
+
+		indices[i] = r;
+	}
+
+	// vertices that aren't referenced by any triangle go last
+	for (size_t i = 0; i < vertex_count; ++i)
+		if (remap[i] == 0xff)
+			order[vertex_offset++] = vertices[i];
+
+	assert(vertex_offset == vertex_count);
+	memcpy(vertices, order, vertex_count * sizeof(unsigned int));
+}
+
+meshopt_Bounds meshopt_computeClusterBounds(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(index_count / 3 <= kMeshletMaxTriangles);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+
+	(void)vertex_count;
+
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+
+	// compute triangle normals and gather triangle corners
+	float normals[kMeshletMaxTriangles][3];
+	float corners[kMeshletMaxTriangles][3][3];
+	size_t triangles = 0;
+
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		unsigned int a = indices[i + 0], b = indices[i + 1], c = indices[i + 2];
+		assert(a < vertex_count && b < vertex_count && c < vertex_count);
+
+		const float* p0 = vertex_positions + vertex_stride_float * a;
+		const float* p1 = vertex_positions + vertex_stride_float * b;
+		const float* p2 = vertex_positions + vertex_stride_float * c;
+
+		float p10[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+		float p20[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+
+		float normalx = p10[1] * p20[2] - p10[2] * p20[1];
+		float normaly = p10[2] * p20[0] - p10[0] * p20[2];
+		float normalz = p10[0] * p20[1] - p10[1] * p20[0];
+
+		float area = sqrtf(normalx * normalx + normaly * normaly + normalz * normalz);
+
+		// no need to include degenerate triangles - they will be invisible anyway
+		if (area == 0.f)
+			continue;
+
+		// record triangle normals & corners for future use; normal and corner 0 define a plane equation
+		normals[triangles][0] = normalx / area;
+		normals[triangles][1] = normaly / area;
+		normals[triangles][2] = normalz / area;
+		memcpy(corners[triangles][0], p0, 3 * sizeof(float));
+		memcpy(corners[triangles][1], p1, 3 * sizeof(float));
+		memcpy(corners[triangles][2], p2, 3 * sizeof(float));
+		triangles++;
+	}
+
+	meshopt_Bounds bounds = {};
+
+	// degenerate cluster, no valid triangles => trivial reject (cone data is 0)
+	if (triangles == 0)
+		return bounds;
+
+	// compute cluster bounding sphere; we'll use the center to determine normal cone apex as well
+	float psphere[4] = {};
+	computeBoundingSphere(psphere, corners[0], triangles * 3);
+
+	float center[3] = {psphere[0], psphere[1], psphere[2]};
+
+	// treating triangle normals as points, find the bounding sphere - the sphere center determines the optimal cone axis
+	float nsphere[4] = {};
+	computeBoundingSphere(nsphere, normals, triangles);
+
+	float axis[3] = {nsphere[0], nsphere[1], nsphere[2]};
+	float axislength = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+	float invaxislength = axislength == 0.f ? 0.f : 1.f / axislength;
+
+	axis[0] *= invaxislength;
+	axis[1] *= invaxislength;
+	axis[2] *= invaxislength;
+
+	// compute a tight cone around all normals, mindp = cos(angle/2)
+	float mindp = 1.f;
+
+	for (size_t i = 0; i < triangles; ++i)
+	{
+		float dp = normals[i][0] * axis[0] + normals[i][1] * axis[1] + normals[i][2] * axis[2];
+
+		mindp = (dp < mindp) ? dp : mindp;
+	}
+
+	// fill bounding sphere info; note that below we can return bounds without cone information for degenerate cones
+	bounds.center[0] = center[0];
+	bounds.center[1] = center[1];
+	bounds.center[2] = center[2];
+	bounds.radius = psphere[3];
+
+	// degenerate cluster, normal cone is larger than a hemisphere => trivial accept
+	// note that if mindp is positive but close to 0, the triangle intersection code below gets less stable
+	// we arbitrarily decide that if a normal cone is ~168 degrees wide or more, the cone isn't useful
+	if (mindp <= 0.1f)
+	{
+		bounds.cone_cutoff = 1;
+		bounds.cone_cutoff_s8 = 127;
+		return bounds;
+	}
+
+	float maxt = 0;
+
+	// we need to find the point on center-t*axis ray that lies in negative half-space of all triangles
+	for (size_t i = 0; i < triangles; ++i)
+	{
+		// dot(center-t*axis-corner, trinormal) = 0
+		// dot(center-corner, trinormal) - t * dot(axis, trinormal) = 0
+		float cx = center[0] - corners[i][0][0];
+		float cy = center[1] - corners[i][0][1];
+		float cz = center[2] - corners[i][0][2];
+
+		float dc = cx * normals[i][0] + cy * normals[i][1] + cz * normals[i][2];
+		float dn = axis[0] * normals[i][0] + axis[1] * normals[i][1] + axis[2] * normals[i][2];
+
+		// dn should be larger than mindp cutoff above
+		assert(dn > 0.f);
+		float t = dc / dn;
+
+		maxt = (t > maxt) ? t : maxt;
+	}
+
+	computeBoundsCone(bounds, center, axis, mindp, maxt);
 
 	return bounds;
 }
@@ -855,3 +2043,53 @@ meshopt_Bounds meshopt_computeMeshletBounds(const unsigned int* meshlet_vertices
 
 	return meshopt_computeClusterBounds(indices, triangle_count * 3, vertex_positions, vertex_count, vertex_positions_stride);
 }
+
+void meshopt_computeMeshletBoundsBatch(meshopt_Bounds* bounds, const meshopt_Meshlet* meshlets, size_t meshlet_count, const unsigned int* meshlet_vertices, const unsigned char* meshlet_triangles, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, meshopt_DispatchCallback dispatch, void* context)
+{
+	using namespace meshopt;
+
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+
+	BoundsJobs jobs = {};
+	jobs.bounds = bounds;
+	jobs.meshlets = meshlets;
+	jobs.meshlet_count = meshlet_count;
+	jobs.meshlet_vertices = meshlet_vertices;
+	jobs.meshlet_triangles = meshlet_triangles;
+	jobs.vertex_positions = vertex_positions;
+	jobs.vertex_count = vertex_count;
+	jobs.vertex_stride_float = vertex_positions_stride / sizeof(float);
+
+	jobs.kernels.normalize = normalizeTriangleNormals;
+	jobs.kernels.sphere = computeBoundingSphereSoA;
+	jobs.kernels.mindp = computeConeMinDot;
+	jobs.kernels.maxt = computeConeMaxT;
+
+#ifdef SIMD_SSE
+	// the scalar kernels are always available so that SIMD level 0 can be used as a reference
+	if (meshopt_getSimdLevel() >= meshopt_SimdBaseline)
+	{
+		jobs.kernels.normalize = normalizeTriangleNormalsSimd;
+		jobs.kernels.sphere = computeBoundingSphereSimd;
+		jobs.kernels.mindp = computeConeMinDotSimd;
+		jobs.kernels.maxt = computeConeMaxTSimd;
+	}
+#endif
+
+	dispatchJobs(dispatch, context, computeBoundsJob, &jobs, (meshlet_count + kBoundsJobMeshlets - 1) / kBoundsJobMeshlets);
+}
+
+#undef SIMD_TARGET_ATTRIBUTE
+#undef SIMD_SSE
+#undef SIMD_FALLBACK
+#undef SIMD_TARGET
+#undef SIMD_SSSE3
+#undef SIMD_FALLBACK_SSSE3
+#undef SIMD_TARGET_SSSE3
+#undef SIMD_NEON
+#undef SIMD_WASM
+#undef SIMD_AVX2
+#undef SIMD_AVX
+#undef SIMD_TARGET_AVX2
+#undef SIMD_TARGET_AVX512
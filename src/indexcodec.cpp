@@ -4,6 +4,8 @@
 #include <assert.h>
 #include <string.h>
 
+#include "internal.h"
+
 // This work is based on:
 // Fabian Giesen. Simple lossless index buffer compression & follow-up. 2013
 // Conor Stokes. Vertex Cache Optimised Index Buffer Compression. 2014
@@ -29,6 +31,12 @@ static const unsigned char kCodeAuxEncodingTable[16] = {
     0, 0, // last two entries aren't used for encoding
 };
 
+static size_t getIndexBufferMinSize(size_t index_count, size_t table_size)
+{
+	// the minimum valid encoding is header, 1 byte per triangle, chunk table (version 2 only) and a 16-byte codeaux table
+	return 1 + index_count / 3 + table_size + 16;
+}
+
 static int rotateTriangle(unsigned int a, unsigned int b, unsigned int c, unsigned int next)
 {
 	(void)a;
@@ -159,22 +167,8 @@ static void writeTriangle(void* destination, size_t offset, size_t index_size, u
 	}
 }
 
-} // namespace meshopt
-
-size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count)
+static unsigned char* encodeTriangles(unsigned char* code, unsigned char* data, unsigned char* data_safe_end, const unsigned int* indices, size_t index_count, int version, unsigned int next)
 {
-	using namespace meshopt;
-
-	assert(index_count % 3 == 0);
-
-	// the minimum valid encoding is header, 1 byte per triangle and a 16-byte codeaux table
-	if (buffer_size < 1 + index_count / 3 + 16)
-		return 0;
-
-	int version = gEncodeIndexVersion;
-
-	buffer[0] = (unsigned char)(kIndexHeader | version);
-
 	EdgeFifo edgefifo;
 	memset(edgefifo, -1, sizeof(edgefifo));
 
@@ -184,12 +178,8 @@ size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, cons
 	size_t edgefifooffset = 0;
 	size_t vertexfifooffset = 0;
 
-	unsigned int next = 0;
-	unsigned int last = 0;
-
-	unsigned char* code = buffer + 1;
-	unsigned char* data = code + index_count / 3;
-	unsigned char* data_safe_end = buffer + buffer_size - 16;
+	// free indices are delta-encoded relative to the last free index, which starts at next
+	unsigned int last = next;
 
 	int fecmax = version >= 1 ? 13 : 15;
 
@@ -312,9 +302,12 @@ size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, cons
 		}
 	}
 
-	// make sure we have enough space to write codeaux table
-	if (data > data_safe_end)
-		return 0;
+	return data;
+}
+
+static unsigned char* writeCodeAuxTable(unsigned char* data)
+{
+	const unsigned char* codeaux_table = kCodeAuxEncodingTable;
 
 	// add codeaux encoding table to the end of the stream; this is used for decoding codeaux *and* as padding
 	// we need padding for decoding to be able to assume that each triangle is encoded as <= 16 bytes of extra data
@@ -330,81 +323,59 @@ size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, cons
 	// since we encode restarts as codeaux without a table reference, we need to make sure 00 is encoded as a table reference
 	assert(codeaux_table[0] == 0);
 
-	assert(data >= buffer + index_count / 3 + 16);
-	assert(data <= buffer + buffer_size);
-
-	return data - buffer;
+	return data;
 }
 
-size_t meshopt_encodeIndexBufferBound(size_t index_count, size_t vertex_count)
+// decoder state that is carried between consecutive decodeTriangles calls on the same stream
+struct TriangleDecoder
 {
-	assert(index_count % 3 == 0);
-
-	// compute number of bits required for each index
-	unsigned int vertex_bits = 1;
-
-	while (vertex_bits < 32 && vertex_count > size_t(1) << vertex_bits)
-		vertex_bits++;
+	EdgeFifo edgefifo;
+	VertexFifo vertexfifo;
 
-	// worst-case encoding is 2 header bytes + 3 varint-7 encoded index deltas
-	unsigned int vertex_groups = (vertex_bits + 1 + 6) / 7;
+	size_t edgefifooffset;
+	size_t vertexfifooffset;
 
-	return 1 + (index_count / 3) * (2 + 3 * vertex_groups) + 16;
-}
+	unsigned int next;
+	unsigned int last;
+};
 
-void meshopt_encodeIndexVersion(int version)
+static void initTriangleDecoder(TriangleDecoder& decoder, unsigned int next)
 {
-	assert(unsigned(version) <= 1);
+	memset(decoder.edgefifo, -1, sizeof(decoder.edgefifo));
+	memset(decoder.vertexfifo, -1, sizeof(decoder.vertexfifo));
 
-	meshopt::gEncodeIndexVersion = version;
+	decoder.edgefifooffset = 0;
+	decoder.vertexfifooffset = 0;
+
+	// free indices are delta-encoded relative to the last free index, which starts at next
+	decoder.next = next;
+	decoder.last = next;
 }
 
-int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size)
+static const unsigned char* decodeTriangles(void* destination, size_t index_count, size_t index_size, const unsigned char* code, const unsigned char* data, const unsigned char* data_safe_end, const unsigned char* codeaux_table, int version, TriangleDecoder& decoder)
 {
-	using namespace meshopt;
-
-	assert(index_count % 3 == 0);
-	assert(index_size == 2 || index_size == 4);
-
-	// the minimum valid encoding is header, 1 byte per triangle and a 16-byte codeaux table
-	if (buffer_size < 1 + index_count / 3 + 16)
-		return -2;
-
-	if ((buffer[0] & 0xf0) != kIndexHeader)
-		return -1;
-
-	int version = buffer[0] & 0x0f;
-	if (version > 1)
-		return -1;
-
+	// note: the state is copied to locals since writes to destination could otherwise alias it
 	EdgeFifo edgefifo;
-	memset(edgefifo, -1, sizeof(edgefifo));
+	memcpy(edgefifo, decoder.edgefifo, sizeof(edgefifo));
 
 	VertexFifo vertexfifo;
-	memset(vertexfifo, -1, sizeof(vertexfifo));
+	memcpy(vertexfifo, decoder.vertexfifo, sizeof(vertexfifo));
 
-	size_t edgefifooffset = 0;
-	size_t vertexfifooffset = 0;
+	size_t edgefifooffset = decoder.edgefifooffset;
+	size_t vertexfifooffset = decoder.vertexfifooffset;
 
-	unsigned int next = 0;
-	unsigned int last = 0;
+	unsigned int next = decoder.next;
+	unsigned int last = decoder.last;
 
 	int fecmax = version >= 1 ? 13 : 15;
 
-	// since we store 16-byte codeaux table at the end, triangle data has to begin before data_safe_end
-	const unsigned char* code = buffer + 1;
-	const unsigned char* data = code + index_count / 3;
-	const unsigned char* data_safe_end = buffer + buffer_size - 16;
-
-	const unsigned char* codeaux_table = data_safe_end;
-
 	for (size_t i = 0; i < index_count; i += 3)
 	{
 		// make sure we have enough data to read for a triangle
 		// each triangle reads at most 16 bytes of data: 1b for codeaux and 5b for each free index
 		// after this we can be sure we can read without extra bounds checks
 		if (data > data_safe_end)
-			return -2;
+			return 0;
 
 		unsigned char codetri = *code++;
 
@@ -539,6 +510,438 @@ int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t inde
 		}
 	}
 
+	memcpy(decoder.edgefifo, edgefifo, sizeof(edgefifo));
+	memcpy(decoder.vertexfifo, vertexfifo, sizeof(vertexfifo));
+
+	decoder.edgefifooffset = edgefifooffset;
+	decoder.vertexfifooffset = vertexfifooffset;
+
+	decoder.next = next;
+	decoder.last = last;
+
+	return data;
+}
+
+// triangles before the range are decoded into a small window on stack since they are only needed to reconstruct the fifo state
+const size_t kIndexDecodeWindow = 256;
+
+static const unsigned char* decodeTrianglesRange(void* destination, size_t first_index, size_t index_count, size_t index_size, const unsigned char* code, const unsigned char* data, const unsigned char* data_safe_end, const unsigned char* codeaux_table, int version, unsigned int next)
+{
+	TriangleDecoder decoder;
+	initTriangleDecoder(decoder, next);
+
+	unsigned int window[kIndexDecodeWindow * 3];
+
+	for (size_t i = 0; i < first_index; i += kIndexDecodeWindow * 3)
+	{
+		size_t window_count = first_index - i < kIndexDecodeWindow * 3 ? first_index - i : kIndexDecodeWindow * 3;
+
+		data = decodeTriangles(window, window_count, 4, code + i / 3, data, data_safe_end, codeaux_table, version, decoder);
+		if (!data)
+			return 0;
+	}
+
+	return decodeTriangles(destination, index_count, index_size, code + first_index / 3, data, data_safe_end, codeaux_table, version, decoder);
+}
+
+// starting from version 2, triangles are split into chunks that are encoded independently
+const size_t kIndexChunkSize = 16384;
+const size_t kIndexChunksPerJob = 4;
+
+// chunk table stores chunk offset and the initial value of next for each chunk
+const size_t kIndexChunkEntrySize = 8;
+
+static void writeUint32(unsigned char* data, size_t value)
+{
+	assert(value <= ~0u);
+
+	data[0] = (unsigned char)(value >> 0);
+	data[1] = (unsigned char)(value >> 8);
+	data[2] = (unsigned char)(value >> 16);
+	data[3] = (unsigned char)(value >> 24);
+}
+
+static unsigned int readUint32(const unsigned char* data)
+{
+	return data[0] | (data[1] << 8) | (data[2] << 16) | (unsigned(data[3]) << 24);
+}
+
+static unsigned int getChunkNext(const unsigned int* indices, size_t index_count, unsigned int next)
+{
+	// since vertex fetch optimization assigns vertex indices in order of first use, one past the largest index seen so far is a good guess for the next new vertex
+	for (size_t i = 0; i < index_count; ++i)
+		next = indices[i] >= next ? indices[i] + 1 : next;
+
+	return next;
+}
+
+static size_t getVByteBound(const unsigned int* indices, size_t index_count)
+{
+	unsigned int max_index = 0;
+
+	for (size_t i = 0; i < index_count; ++i)
+		max_index = indices[i] > max_index ? indices[i] : max_index;
+
+	unsigned int vertex_bits = 1;
+
+	while (vertex_bits < 32 && max_index >= 1u << vertex_bits)
+		vertex_bits++;
+
+	// free indices are zigzag-encoded deltas, which take one more bit than the indices themselves
+	return (vertex_bits + 1 + 6) / 7;
+}
+
+static size_t getChunkTriangles(size_t triangle_count, size_t chunk)
+{
+	size_t offset = chunk * kIndexChunkSize;
+
+	return (offset + kIndexChunkSize < triangle_count) ? kIndexChunkSize : triangle_count - offset;
+}
+
+static int decodeIndexChunk(void* destination, size_t first_index, size_t index_count, size_t index_size, const unsigned char* buffer, const unsigned char* table, size_t chunk_count, size_t triangle_count, size_t chunk, int version)
+{
+	size_t begin = readUint32(table + chunk * kIndexChunkEntrySize);
+	size_t end = chunk + 1 < chunk_count ? readUint32(table + (chunk + 1) * kIndexChunkEntrySize) : size_t(table - buffer);
+	unsigned int next = readUint32(table + chunk * kIndexChunkEntrySize + 4);
+
+	// chunks must follow each other without gaps and end before the chunk table
+	if ((chunk == 0 && begin != 1) || begin > end || end > size_t(table - buffer))
+		return -3;
+
+	size_t triangles = getChunkTriangles(triangle_count, chunk);
+
+	// each chunk starts with 1 code byte per triangle
+	if (end - begin < triangles)
+		return -2;
+
+	const unsigned char* code = buffer + begin;
+	const unsigned char* data_end = buffer + end;
+
+	// note: even though we only check that triangle data begins before the end of the chunk, the chunk table and 16-byte codeaux table that follow make reads safe
+	assert(first_index + index_count <= triangles * 3);
+
+	const unsigned char* data = decodeTrianglesRange(destination, first_index, index_count, index_size, code, code + triangles, data_end, table + kIndexChunkEntrySize * chunk_count, version, next);
+	if (!data)
+		return -2;
+
+	// if the chunk was decoded to the end, we should've read all data bytes and stopped at the boundary between this chunk and the next one
+	if (first_index + index_count == triangles * 3 && data != data_end)
+		return -3;
+
+	return 0;
+}
+
+struct IndexEncodeJobs
+{
+	const unsigned int* indices;
+	size_t triangle_count;
+	size_t chunk_count;
+	int version;
+
+	unsigned char* buffer;
+	size_t triangle_bound;
+
+	const unsigned int* chunk_next;
+	size_t* chunk_size;
+};
+
+static void encodeIndexJob(void* job_data, size_t job_index)
+{
+	IndexEncodeJobs& jobs = *static_cast<IndexEncodeJobs*>(job_data);
+
+	size_t chunk_begin = job_index * kIndexChunksPerJob;
+	size_t chunk_end = chunk_begin + kIndexChunksPerJob < jobs.chunk_count ? chunk_begin + kIndexChunksPerJob : jobs.chunk_count;
+
+	for (size_t i = chunk_begin; i < chunk_end; ++i)
+	{
+		size_t triangles = getChunkTriangles(jobs.triangle_count, i);
+
+		unsigned char* code = jobs.buffer + 1 + i * kIndexChunkSize * jobs.triangle_bound;
+		unsigned char* code_end = code + triangles * jobs.triangle_bound;
+
+		// triangle_bound covers the worst case encoding for the index range of the mesh, so the chunk can't overflow into the next chunk's region
+		unsigned char* data = encodeTriangles(code, code + triangles, code_end, jobs.indices + i * kIndexChunkSize * 3, triangles * 3, jobs.version, jobs.chunk_next[i]);
+		assert(data && data <= code_end);
+
+		jobs.chunk_size[i] = data - code;
+	}
+}
+
+static size_t encodeIndexChunks(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count, int version, meshopt_DispatchCallback dispatch, void* context)
+{
+	size_t triangle_count = index_count / 3;
+	size_t chunk_count = (triangle_count + kIndexChunkSize - 1) / kIndexChunkSize;
+	size_t table_size = chunk_count * kIndexChunkEntrySize;
+
+	if (buffer_size < getIndexBufferMinSize(index_count, table_size))
+		return 0;
+
+	buffer[0] = (unsigned char)(kIndexHeader | version);
+
+	meshopt_Allocator allocator;
+
+	unsigned int* chunk_next = allocator.allocate<unsigned int>(chunk_count);
+	size_t* chunk_offset = allocator.allocate<size_t>(chunk_count);
+
+	// each chunk starts with empty fifos; next is computed from the index data so that chunks can be encoded without encoding previous chunks first
+	unsigned int next = 0;
+
+	for (size_t i = 0; i < chunk_count; ++i)
+	{
+		chunk_next[i] = next;
+		next = getChunkNext(indices + i * kIndexChunkSize * 3, getChunkTriangles(triangle_count, i) * 3, next);
+	}
+
+	unsigned char* data = buffer + 1;
+	unsigned char* data_safe_end = buffer + buffer_size - table_size - 16;
+
+	size_t job_count = (chunk_count + kIndexChunksPerJob - 1) / kIndexChunksPerJob;
+
+	// jobs encode chunks directly into the buffer, each chunk into a region that fits its worst case encoding; this needs the buffer to be large enough for the worst case
+	// the worst case is computed from the largest index, same as in meshopt_encodeIndexBufferBound
+	size_t triangle_bound = dispatch && job_count > 1 ? 2 + 3 * getVByteBound(indices, index_count) : 0;
+
+	if (triangle_bound && 1 + triangle_count * triangle_bound <= size_t(data_safe_end - buffer))
+	{
+		size_t* chunk_size = allocator.allocate<size_t>(chunk_count);
+
+		IndexEncodeJobs jobs = {};
+		jobs.indices = indices;
+		jobs.triangle_count = triangle_count;
+		jobs.chunk_count = chunk_count;
+		jobs.version = version;
+		jobs.buffer = buffer;
+		jobs.triangle_bound = triangle_bound;
+		jobs.chunk_next = chunk_next;
+		jobs.chunk_size = chunk_size;
+
+		dispatchJobs(dispatch, context, encodeIndexJob, &jobs, job_count);
+
+		// pack chunks back to back; the destination never comes after the source, so chunks can be moved in order
+		for (size_t i = 0; i < chunk_count; ++i)
+		{
+			chunk_offset[i] = data - buffer;
+
+			memmove(data, buffer + 1 + i * kIndexChunkSize * triangle_bound, chunk_size[i]);
+			data += chunk_size[i];
+		}
+	}
+	else
+	{
+		for (size_t i = 0; i < chunk_count; ++i)
+		{
+			size_t triangles = getChunkTriangles(triangle_count, i);
+
+			chunk_offset[i] = data - buffer;
+
+			unsigned char* code = data;
+			data = code + triangles;
+
+			if (data > data_safe_end)
+				return 0;
+
+			data = encodeTriangles(code, data, data_safe_end, indices + i * kIndexChunkSize * 3, triangles * 3, version, chunk_next[i]);
+			if (!data)
+				return 0;
+		}
+	}
+
+	// make sure we have enough space to write chunk table and codeaux table
+	if (data > data_safe_end)
+		return 0;
+
+	for (size_t i = 0; i < chunk_count; ++i)
+	{
+		writeUint32(data + 0, chunk_offset[i]);
+		writeUint32(data + 4, chunk_next[i]);
+		data += kIndexChunkEntrySize;
+	}
+
+	data = writeCodeAuxTable(data);
+
+	assert(data >= buffer + triangle_count + table_size + 16);
+	assert(data <= buffer + buffer_size);
+
+	return data - buffer;
+}
+
+struct IndexDecodeJobs
+{
+	unsigned char* destination;
+	size_t index_size;
+
+	const unsigned char* buffer;
+	const unsigned char* table;
+	size_t chunk_count;
+	size_t triangle_count;
+	int version;
+
+	signed char* job_result;
+};
+
+static void decodeIndexJob(void* job_data, size_t job_index)
+{
+	IndexDecodeJobs& jobs = *static_cast<IndexDecodeJobs*>(job_data);
+
+	size_t chunk_begin = job_index * kIndexChunksPerJob;
+	size_t chunk_end = chunk_begin + kIndexChunksPerJob < jobs.chunk_count ? chunk_begin + kIndexChunksPerJob : jobs.chunk_count;
+
+	for (size_t i = chunk_begin; i < chunk_end; ++i)
+	{
+		int result = decodeIndexChunk(jobs.destination + i * kIndexChunkSize * 3 * jobs.index_size, 0, getChunkTriangles(jobs.triangle_count, i) * 3, jobs.index_size, jobs.buffer, jobs.table, jobs.chunk_count, jobs.triangle_count, i, jobs.version);
+
+		if (result)
+		{
+			jobs.job_result[job_index] = (signed char)result;
+			return;
+		}
+	}
+}
+
+static int decodeIndexChunks(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size, int version, meshopt_DispatchCallback dispatch, void* context)
+{
+	size_t triangle_count = index_count / 3;
+	size_t chunk_count = (triangle_count + kIndexChunkSize - 1) / kIndexChunkSize;
+	size_t table_size = chunk_count * kIndexChunkEntrySize;
+
+	if (buffer_size < getIndexBufferMinSize(index_count, table_size))
+		return -2;
+
+	const unsigned char* table = buffer + buffer_size - 16 - table_size;
+
+	size_t job_count = (chunk_count + kIndexChunksPerJob - 1) / kIndexChunksPerJob;
+
+	if (!dispatch || job_count <= 1)
+	{
+		for (size_t i = 0; i < chunk_count; ++i)
+		{
+			int result = decodeIndexChunk(static_cast<unsigned char*>(destination) + i * kIndexChunkSize * 3 * index_size, 0, getChunkTriangles(triangle_count, i) * 3, index_size, buffer, table, chunk_count, triangle_count, i, version);
+
+			if (result)
+				return result;
+		}
+
+		return 0;
+	}
+
+	meshopt_Allocator allocator;
+
+	IndexDecodeJobs jobs = {};
+	jobs.destination = static_cast<unsigned char*>(destination);
+	jobs.index_size = index_size;
+	jobs.buffer = buffer;
+	jobs.table = table;
+	jobs.chunk_count = chunk_count;
+	jobs.triangle_count = triangle_count;
+	jobs.version = version;
+	jobs.job_result = allocator.allocate<signed char>(job_count);
+
+	memset(jobs.job_result, 0, job_count);
+
+	dispatchJobs(dispatch, context, decodeIndexJob, &jobs, job_count);
+
+	for (size_t i = 0; i < job_count; ++i)
+		if (jobs.job_result[i])
+			return jobs.job_result[i];
+
+	return 0;
+}
+
+} // namespace meshopt
+
+size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+
+	if (buffer_size < getIndexBufferMinSize(index_count, 0))
+		return 0;
+
+	int version = gEncodeIndexVersion;
+
+	if (version >= 2)
+		return encodeIndexChunks(buffer, buffer_size, indices, index_count, version, 0, 0);
+
+	buffer[0] = (unsigned char)(kIndexHeader | version);
+
+	unsigned char* code = buffer + 1;
+	unsigned char* data = code + index_count / 3;
+	unsigned char* data_safe_end = buffer + buffer_size - 16;
+
+	data = encodeTriangles(code, data, data_safe_end, indices, index_count, version, 0);
+	if (!data)
+		return 0;
+
+	// make sure we have enough space to write codeaux table
+	if (data > data_safe_end)
+		return 0;
+
+	data = writeCodeAuxTable(data);
+
+	assert(data >= buffer + index_count / 3 + 16);
+	assert(data <= buffer + buffer_size);
+
+	return data - buffer;
+}
+
+size_t meshopt_encodeIndexBufferBound(size_t index_count, size_t vertex_count)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+
+	// compute number of bits required for each index
+	unsigned int vertex_bits = 1;
+
+	while (vertex_bits < 32 && vertex_count > size_t(1) << vertex_bits)
+		vertex_bits++;
+
+	// worst-case encoding is 2 header bytes + 3 varint-7 encoded index deltas
+	unsigned int vertex_groups = (vertex_bits + 1 + 6) / 7;
+
+	// version 2 also needs a chunk table entry for every chunk
+	size_t chunk_count = (index_count / 3 + kIndexChunkSize - 1) / kIndexChunkSize;
+
+	return 1 + (index_count / 3) * (2 + 3 * vertex_groups) + chunk_count * kIndexChunkEntrySize + 16;
+}
+
+void meshopt_encodeIndexVersion(int version)
+{
+	assert(unsigned(version) <= 2);
+
+	meshopt::gEncodeIndexVersion = version;
+}
+
+int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(index_size == 2 || index_size == 4);
+
+	if (buffer_size < getIndexBufferMinSize(index_count, 0))
+		return -2;
+
+	if ((buffer[0] & 0xf0) != kIndexHeader)
+		return -1;
+
+	int version = buffer[0] & 0x0f;
+	if (version > 2)
+		return -1;
+
+	if (version >= 2)
+		return decodeIndexChunks(destination, index_count, index_size, buffer, buffer_size, version, 0, 0);
+
+	// since we store 16-byte codeaux table at the end, triangle data has to begin before data_safe_end
+	const unsigned char* code = buffer + 1;
+	const unsigned char* data = code + index_count / 3;
+	const unsigned char* data_safe_end = buffer + buffer_size - 16;
+
+	data = decodeTrianglesRange(destination, 0, index_count, index_size, code, data, data_safe_end, data_safe_end, version, 0);
+	if (!data)
+		return -2;
+
 	// we should've read all data bytes and stopped at the boundary between data and codeaux table
 	if (data != data_safe_end)
 		return -3;
@@ -546,6 +949,110 @@ int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t inde
 	return 0;
 }
 
+size_t meshopt_encodeIndexBufferParallel(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count, meshopt_DispatchCallback dispatch, void* context)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+
+	int version = gEncodeIndexVersion;
+
+	// earlier versions encode the entire buffer as a single stream
+	if (version < 2)
+		return meshopt_encodeIndexBuffer(buffer, buffer_size, indices, index_count);
+
+	return encodeIndexChunks(buffer, buffer_size, indices, index_count, version, dispatch, context);
+}
+
+int meshopt_decodeIndexBufferParallel(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size, meshopt_DispatchCallback dispatch, void* context)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(index_size == 2 || index_size == 4);
+
+	if (buffer_size < getIndexBufferMinSize(index_count, 0))
+		return -2;
+
+	if ((buffer[0] & 0xf0) != kIndexHeader)
+		return -1;
+
+	int version = buffer[0] & 0x0f;
+
+	// earlier versions encode the entire buffer as a single stream
+	if (version < 2)
+		return meshopt_decodeIndexBuffer(destination, index_count, index_size, buffer, buffer_size);
+
+	if (version > 2)
+		return -1;
+
+	return decodeIndexChunks(destination, index_count, index_size, buffer, buffer_size, version, dispatch, context);
+}
+
+int meshopt_decodeIndexBufferRange(void* destination, size_t first_index, size_t count, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0 && first_index % 3 == 0 && count % 3 == 0);
+	assert(index_size == 2 || index_size == 4);
+	assert(first_index + count <= index_count);
+
+	if (buffer_size < getIndexBufferMinSize(index_count, 0))
+		return -2;
+
+	if ((buffer[0] & 0xf0) != kIndexHeader)
+		return -1;
+
+	int version = buffer[0] & 0x0f;
+	if (version > 2)
+		return -1;
+
+	if (count == 0)
+		return 0;
+
+	unsigned char* result = static_cast<unsigned char*>(destination);
+
+	if (version < 2)
+	{
+		// earlier versions encode the entire buffer as a single stream, so we need to decode all triangles before the range
+		const unsigned char* code = buffer + 1;
+		const unsigned char* data = code + index_count / 3;
+		const unsigned char* data_safe_end = buffer + buffer_size - 16;
+
+		if (!decodeTrianglesRange(result, first_index, count, index_size, code, data, data_safe_end, data_safe_end, version, 0))
+			return -2;
+
+		return 0;
+	}
+
+	size_t triangle_count = index_count / 3;
+	size_t chunk_count = (triangle_count + kIndexChunkSize - 1) / kIndexChunkSize;
+	size_t table_size = chunk_count * kIndexChunkEntrySize;
+
+	if (buffer_size < 1 + triangle_count + table_size + 16)
+		return -2;
+
+	const unsigned char* table = buffer + buffer_size - 16 - table_size;
+
+	size_t chunk_begin = first_index / 3 / kIndexChunkSize;
+	size_t chunk_end = ((first_index + count) / 3 + kIndexChunkSize - 1) / kIndexChunkSize;
+
+	for (size_t i = chunk_begin; i < chunk_end; ++i)
+	{
+		size_t chunk_first = i * kIndexChunkSize * 3;
+		size_t chunk_count_indices = getChunkTriangles(triangle_count, i) * 3;
+
+		size_t range_begin = chunk_first < first_index ? first_index : chunk_first;
+		size_t range_end = chunk_first + chunk_count_indices < first_index + count ? chunk_first + chunk_count_indices : first_index + count;
+
+		int rc = decodeIndexChunk(result + (range_begin - first_index) * index_size, range_begin - chunk_first, range_end - range_begin, index_size, buffer, table, chunk_count, triangle_count, i, version);
+		if (rc)
+			return rc;
+	}
+
+	return 0;
+}
+
 size_t meshopt_encodeIndexSequence(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count)
 {
 	using namespace meshopt;
@@ -554,7 +1061,8 @@ size_t meshopt_encodeIndexSequence(unsigned char* buffer, size_t buffer_size, co
 	if (buffer_size < 1 + index_count + 4)
 		return 0;
 
-	int version = gEncodeIndexVersion;
+	// version 2 only changes the index buffer codec; index sequences use version 1 which is identical to version 0
+	int version = gEncodeIndexVersion > 1 ? 1 : gEncodeIndexVersion;
 
 	buffer[0] = (unsigned char)(kSequenceHeader | version);
 
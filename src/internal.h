@@ -0,0 +1,34 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+// Internal header with helpers that are shared between several source files
+#ifndef MESHOPTIMIZER_INTERNAL_H
+#define MESHOPTIMIZER_INTERNAL_H
+
+#include "meshoptimizer.h"
+
+namespace meshopt
+{
+
+// Runs job_count jobs via dispatch (see meshopt_DispatchCallback), or serially on the calling thread if dispatch is null
+inline void dispatchJobs(meshopt_DispatchCallback dispatch, void* context, meshopt_JobCallback job, void* job_data, size_t job_count)
+{
+	if (dispatch)
+		dispatch(context, job, job_data, job_count);
+	else
+		for (size_t i = 0; i < job_count; ++i)
+			job(job_data, i);
+}
+
+// "Insert" two 0 bits after each of the 10 low bits of x
+inline unsigned int part1By2(unsigned int x)
+{
+	x &= 0x000003ff;                  // x = ---- ---- ---- ---- ---- --98 7654 3210
+	x = (x ^ (x << 16)) & 0xff0000ff; // x = ---- --98 ---- ---- ---- ---- 7654 3210
+	x = (x ^ (x << 8)) & 0x0300f00f;  // x = ---- --98 ---- ---- 7654 ---- ---- 3210
+	x = (x ^ (x << 4)) & 0x030c30c3;  // x = ---- --98 ---- 76-- --54 ---- 32-- --10
+	x = (x ^ (x << 2)) & 0x09249249;  // x = ---- 9--8 --7- -6-- 5--4 --3- -2-- 1--0
+	return x;
+}
+
+} // namespace meshopt
+
+#endif
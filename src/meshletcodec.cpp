@@ -0,0 +1,493 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+#include "meshoptimizer.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "simd.h"
+
+// Meshlet data starts with a header byte that stores the format version, and is followed by a set of byte streams, each split into groups of 16 bytes:
+// - the first vertex reference is stored as is, followed by 4 streams with bytes 0-3 of zigzag-encoded deltas between consecutive vertex references
+// - triangle indices are stored as a single stream; since meshlet builders assign local indices in the order of first use, each index is encoded as
+//   a distance back from the next unused index, which is 0 for new vertices and is small for recently used ones
+// Each group uses a 2-bit mode stored in the header which selects the number of bits used for each value in the group.
+namespace meshopt
+{
+
+const unsigned char kMeshletHeader = 0x90;
+
+const size_t kMeshletGroupSize = 16;
+
+// vertex deltas often have all high bytes set to 0, whereas triangle groups are almost never 0 but usually fit into 6 bits
+static const unsigned char kVertexGroupBits[4] = {0, 2, 4, 8};
+static const unsigned char kTriangleGroupBits[4] = {2, 4, 6, 8};
+
+inline unsigned int zigzag32(unsigned int v)
+{
+	return (unsigned int)((int)(v) >> 31) ^ (v << 1);
+}
+
+inline unsigned int unzigzag32(unsigned int v)
+{
+	return -(v & 1) ^ (v >> 1);
+}
+
+static int getGroupBits(const unsigned char* header, size_t group, const unsigned char* table)
+{
+	return table[(header[group / 4] >> ((group % 4) * 2)) & 3];
+}
+
+static size_t getVertexGroups(size_t vertex_count)
+{
+	// first vertex reference is stored separately, so we only encode deltas for the rest
+	return vertex_count > 1 ? (vertex_count - 2) / kMeshletGroupSize + 1 : 0;
+}
+
+static size_t getTriangleGroups(size_t triangle_count)
+{
+	return (triangle_count * 3 + kMeshletGroupSize - 1) / kMeshletGroupSize;
+}
+
+static unsigned char* encodeGroup(unsigned char* data, unsigned char* data_end, unsigned char* header, size_t group, const unsigned char* values, const unsigned char* table)
+{
+	unsigned char maxv = 0;
+
+	for (size_t i = 0; i < kMeshletGroupSize; ++i)
+		maxv = values[i] > maxv ? values[i] : maxv;
+
+	int mode = 0;
+
+	while (mode < 3 && maxv >= (1 << table[mode]))
+		mode++;
+
+	int bits = table[mode];
+
+	if (size_t(data_end - data) < size_t(bits * 2))
+		return 0;
+
+	header[group / 4] |= (unsigned char)(mode << ((group % 4) * 2));
+
+	switch (bits)
+	{
+	case 2:
+		for (size_t i = 0; i < 4; ++i)
+			data[i] = (unsigned char)(values[i * 4 + 0] | (values[i * 4 + 1] << 2) | (values[i * 4 + 2] << 4) | (values[i * 4 + 3] << 6));
+		break;
+
+	case 4:
+		for (size_t i = 0; i < 8; ++i)
+			data[i] = (unsigned char)(values[i * 2 + 0] | (values[i * 2 + 1] << 4));
+		break;
+
+	case 6:
+		// low 4 bits are stored the same way as a 4-bit group, followed by high 2 bits stored as a 2-bit group
+		for (size_t i = 0; i < 8; ++i)
+			data[i] = (unsigned char)((values[i * 2 + 0] & 15) | ((values[i * 2 + 1] & 15) << 4));
+
+		for (size_t i = 0; i < 4; ++i)
+			data[8 + i] = (unsigned char)((values[i * 4 + 0] >> 4) | ((values[i * 4 + 1] >> 4) << 2) | ((values[i * 4 + 2] >> 4) << 4) | ((values[i * 4 + 3] >> 4) << 6));
+		break;
+
+	case 8:
+		memcpy(data, values, kMeshletGroupSize);
+		break;
+	}
+
+	return data + bits * 2;
+}
+
+static const unsigned char* decodeGroup(const unsigned char* data, unsigned char* values, int bits)
+{
+	switch (bits)
+	{
+	case 0:
+		memset(values, 0, kMeshletGroupSize);
+		break;
+
+	case 2:
+		for (size_t i = 0; i < kMeshletGroupSize; ++i)
+			values[i] = (data[i / 4] >> ((i % 4) * 2)) & 3;
+		break;
+
+	case 4:
+		for (size_t i = 0; i < kMeshletGroupSize; ++i)
+			values[i] = (data[i / 2] >> ((i % 2) * 4)) & 15;
+		break;
+
+	case 6:
+		for (size_t i = 0; i < kMeshletGroupSize; ++i)
+			values[i] = (unsigned char)(((data[i / 2] >> ((i % 2) * 4)) & 15) | (((data[8 + i / 4] >> ((i % 4) * 2)) & 3) << 4));
+		break;
+
+	default:
+		memcpy(values, data, kMeshletGroupSize);
+	}
+
+	return data + bits * 2;
+}
+
+static void decodeMeshletVertices(unsigned int* vertices, size_t vertex_count, unsigned int first, const unsigned char* header, const unsigned char** streams, size_t group_count)
+{
+	unsigned int last = first;
+
+	for (size_t g = 0; g < group_count; ++g)
+	{
+		unsigned char planes[4][kMeshletGroupSize];
+
+		for (int k = 0; k < 4; ++k)
+			streams[k] = decodeGroup(streams[k], planes[k], getGroupBits(header, k * group_count + g, kVertexGroupBits));
+
+		size_t offset = 1 + g * kMeshletGroupSize;
+		size_t count = vertex_count - offset < kMeshletGroupSize ? vertex_count - offset : kMeshletGroupSize;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			unsigned int v = planes[0][i] | (planes[1][i] << 8) | (planes[2][i] << 16) | (unsigned(planes[3][i]) << 24);
+
+			last += unzigzag32(v);
+			vertices[offset + i] = last;
+		}
+	}
+}
+
+static void decodeMeshletTriangles(unsigned char* indices, size_t index_count, const unsigned char* header, size_t group_offset, const unsigned char* data, size_t group_count)
+{
+	unsigned char next = 0;
+
+	for (size_t g = 0; g < group_count; ++g)
+	{
+		unsigned char values[kMeshletGroupSize];
+
+		data = decodeGroup(data, values, getGroupBits(header, group_offset + g, kTriangleGroupBits));
+
+		size_t offset = g * kMeshletGroupSize;
+		size_t count = index_count - offset < kMeshletGroupSize ? index_count - offset : kMeshletGroupSize;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			indices[offset + i] = (unsigned char)(next - values[i]);
+
+			if (values[i] == 0)
+				next++;
+		}
+	}
+}
+
+#ifdef SIMD_SSE
+SIMD_TARGET
+static __m128i decodeBits2Simd(const unsigned char* data)
+{
+	int v;
+	memcpy(&v, data, 4);
+
+	__m128i b = _mm_cvtsi32_si128(v);
+	__m128i m = _mm_set1_epi8(3);
+
+	// 16-bit shifts move bits across bytes, but masking removes them
+	__m128i e0 = _mm_and_si128(b, m);
+	__m128i e1 = _mm_and_si128(_mm_srli_epi16(b, 2), m);
+	__m128i e2 = _mm_and_si128(_mm_srli_epi16(b, 4), m);
+	__m128i e3 = _mm_and_si128(_mm_srli_epi16(b, 6), m);
+
+	return _mm_unpacklo_epi16(_mm_unpacklo_epi8(e0, e1), _mm_unpacklo_epi8(e2, e3));
+}
+
+SIMD_TARGET
+static __m128i decodeBits4Simd(const unsigned char* data)
+{
+	__m128i b = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+	__m128i m = _mm_set1_epi8(15);
+
+	return _mm_unpacklo_epi8(_mm_and_si128(b, m), _mm_and_si128(_mm_srli_epi16(b, 4), m));
+}
+
+SIMD_TARGET
+static __m128i decodeGroupSimd(const unsigned char*& data, int bits)
+{
+	const unsigned char* group = data;
+	data += bits * 2;
+
+	switch (bits)
+	{
+	case 0:
+		return _mm_setzero_si128();
+
+	case 2:
+		return decodeBits2Simd(group);
+
+	case 4:
+		return decodeBits4Simd(group);
+
+	case 6:
+		// high 2 bits are at most 3, so 16-bit shift doesn't move bits across bytes
+		return _mm_or_si128(decodeBits4Simd(group), _mm_slli_epi16(decodeBits2Simd(group + 8), 4));
+
+	default:
+		return _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+	}
+}
+
+SIMD_TARGET
+static __m128i unzigzag32(__m128i v)
+{
+	__m128i xl = _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(v, _mm_set1_epi32(1)));
+	__m128i xr = _mm_srli_epi32(v, 1);
+
+	return _mm_xor_si128(xl, xr);
+}
+
+SIMD_TARGET
+static void decodeMeshletVerticesSimd(unsigned int* vertices, size_t vertex_count, unsigned int first, const unsigned char* header, const unsigned char** streams, size_t group_count)
+{
+	__m128i last = _mm_set1_epi32(first);
+
+	for (size_t g = 0; g < group_count; ++g)
+	{
+		__m128i p0 = decodeGroupSimd(streams[0], getGroupBits(header, 0 * group_count + g, kVertexGroupBits));
+		__m128i p1 = decodeGroupSimd(streams[1], getGroupBits(header, 1 * group_count + g, kVertexGroupBits));
+		__m128i p2 = decodeGroupSimd(streams[2], getGroupBits(header, 2 * group_count + g, kVertexGroupBits));
+		__m128i p3 = decodeGroupSimd(streams[3], getGroupBits(header, 3 * group_count + g, kVertexGroupBits));
+
+		// transpose byte planes into 32-bit values
+		__m128i p01l = _mm_unpacklo_epi8(p0, p1), p01h = _mm_unpackhi_epi8(p0, p1);
+		__m128i p23l = _mm_unpacklo_epi8(p2, p3), p23h = _mm_unpackhi_epi8(p2, p3);
+
+		__m128i v[4] = {_mm_unpacklo_epi16(p01l, p23l), _mm_unpackhi_epi16(p01l, p23l), _mm_unpacklo_epi16(p01h, p23h), _mm_unpackhi_epi16(p01h, p23h)};
+
+		unsigned int result[kMeshletGroupSize];
+
+		for (int k = 0; k < 4; ++k)
+		{
+			// prefix sum of deltas, offset by the last decoded value
+			__m128i d = unzigzag32(v[k]);
+			d = _mm_add_epi32(d, _mm_slli_si128(d, 4));
+			d = _mm_add_epi32(d, _mm_slli_si128(d, 8));
+
+			last = _mm_add_epi32(d, _mm_shuffle_epi32(last, 0xff));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&result[k * 4]), last);
+		}
+
+		size_t offset = 1 + g * kMeshletGroupSize;
+		size_t count = vertex_count - offset < kMeshletGroupSize ? vertex_count - offset : kMeshletGroupSize;
+
+		memcpy(&vertices[offset], result, count * sizeof(unsigned int));
+	}
+}
+
+SIMD_TARGET
+static void decodeMeshletTrianglesSimd(unsigned char* indices, size_t index_count, const unsigned char* header, size_t group_offset, const unsigned char* data, size_t group_count)
+{
+	__m128i next = _mm_setzero_si128();
+
+	for (size_t g = 0; g < group_count; ++g)
+	{
+		__m128i u = decodeGroupSimd(data, getGroupBits(header, group_offset + g, kTriangleGroupBits));
+
+		// new vertices are encoded as 0; prefix sum of the mask gives negated number of new vertices up to and including each index
+		__m128i z = _mm_cmpeq_epi8(u, _mm_setzero_si128());
+
+		__m128i s = z;
+		s = _mm_add_epi8(s, _mm_slli_si128(s, 1));
+		s = _mm_add_epi8(s, _mm_slli_si128(s, 2));
+		s = _mm_add_epi8(s, _mm_slli_si128(s, 4));
+		s = _mm_add_epi8(s, _mm_slli_si128(s, 8));
+
+		__m128i r = _mm_sub_epi8(_mm_add_epi8(next, _mm_sub_epi8(z, s)), u);
+
+		// broadcast last byte of s to all bytes
+		__m128i l = _mm_srli_si128(s, 15);
+		l = _mm_unpacklo_epi8(l, l);
+		l = _mm_shufflelo_epi16(l, 0);
+		next = _mm_sub_epi8(next, _mm_unpacklo_epi64(l, l));
+
+		size_t offset = g * kMeshletGroupSize;
+
+		if (index_count - offset >= kMeshletGroupSize)
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&indices[offset]), r);
+		}
+		else
+		{
+			unsigned char result[kMeshletGroupSize];
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(result), r);
+
+			memcpy(&indices[offset], result, index_count - offset);
+		}
+	}
+}
+#endif
+
+} // namespace meshopt
+
+size_t meshopt_encodeMeshletBound(size_t max_vertices, size_t max_triangles)
+{
+	using namespace meshopt;
+
+	size_t group_count = getVertexGroups(max_vertices) * 4 + getTriangleGroups(max_triangles);
+
+	// header byte, first vertex reference, 2-bit mode for each group and group data
+	return 1 + 4 + (group_count + 3) / 4 + group_count * kMeshletGroupSize;
+}
+
+size_t meshopt_encodeMeshlet(unsigned char* buffer, size_t buffer_size, const unsigned int* vertices, size_t vertex_count, const unsigned char* triangles, size_t triangle_count)
+{
+	using namespace meshopt;
+
+	size_t vertex_groups = getVertexGroups(vertex_count);
+	size_t triangle_groups = getTriangleGroups(triangle_count);
+	size_t group_count = vertex_groups * 4 + triangle_groups;
+
+	if (buffer_size < 1 + (vertex_count ? 4 : 0) + (group_count + 3) / 4)
+		return 0;
+
+	unsigned char* data = buffer;
+	unsigned char* data_end = buffer + buffer_size;
+
+	*data++ = kMeshletHeader;
+
+	if (vertex_count)
+	{
+		unsigned int v = vertices[0];
+
+		// little endian
+		data[0] = (unsigned char)(v >> 0);
+		data[1] = (unsigned char)(v >> 8);
+		data[2] = (unsigned char)(v >> 16);
+		data[3] = (unsigned char)(v >> 24);
+		data += 4;
+	}
+
+	unsigned char* header = data;
+	memset(header, 0, (group_count + 3) / 4);
+	data += (group_count + 3) / 4;
+
+	size_t group = 0;
+
+	for (int k = 0; k < 4; ++k)
+		for (size_t g = 0; g < vertex_groups; ++g)
+		{
+			unsigned char values[kMeshletGroupSize] = {};
+
+			for (size_t i = 0; i < kMeshletGroupSize && 1 + g * kMeshletGroupSize + i < vertex_count; ++i)
+			{
+				size_t index = 1 + g * kMeshletGroupSize + i;
+
+				values[i] = (unsigned char)(zigzag32(vertices[index] - vertices[index - 1]) >> (k * 8));
+			}
+
+			data = encodeGroup(data, data_end, header, group++, values, kVertexGroupBits);
+			if (!data)
+				return 0;
+		}
+
+	size_t index_count = triangle_count * 3;
+	unsigned char next = 0;
+
+	for (size_t g = 0; g < triangle_groups; ++g)
+	{
+		unsigned char values[kMeshletGroupSize] = {};
+
+		for (size_t i = 0; i < kMeshletGroupSize && g * kMeshletGroupSize + i < index_count; ++i)
+		{
+			values[i] = (unsigned char)(next - triangles[g * kMeshletGroupSize + i]);
+
+			if (values[i] == 0)
+				next++;
+		}
+
+		data = encodeGroup(data, data_end, header, group++, values, kTriangleGroupBits);
+		if (!data)
+			return 0;
+	}
+
+	assert(group == group_count);
+	assert(data <= buffer + buffer_size);
+
+	return data - buffer;
+}
+
+int meshopt_decodeMeshlet(unsigned int* vertices, size_t vertex_count, unsigned char* triangles, size_t triangle_count, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	size_t vertex_groups = getVertexGroups(vertex_count);
+	size_t triangle_groups = getTriangleGroups(triangle_count);
+	size_t group_count = vertex_groups * 4 + triangle_groups;
+
+	if (buffer_size < 1 + (vertex_count ? 4 : 0) + (group_count + 3) / 4)
+		return -2;
+
+	const unsigned char* data = buffer;
+
+	if (*data++ != kMeshletHeader)
+		return -1;
+
+	unsigned int first = 0;
+
+	if (vertex_count)
+	{
+		first = data[0] | (data[1] << 8) | (data[2] << 16) | (unsigned(data[3]) << 24);
+		data += 4;
+	}
+
+	const unsigned char* header = data;
+	data += (group_count + 3) / 4;
+
+	// locate all streams and validate the total size before decoding
+	const unsigned char* streams[5];
+	size_t group = 0;
+
+	for (int k = 0; k < 5; ++k)
+	{
+		size_t stream_groups = k < 4 ? vertex_groups : triangle_groups;
+		const unsigned char* table = k < 4 ? kVertexGroupBits : kTriangleGroupBits;
+
+		size_t stream_size = 0;
+
+		for (size_t g = 0; g < stream_groups; ++g)
+			stream_size += getGroupBits(header, group++, table) * 2;
+
+		if (size_t(buffer + buffer_size - data) < stream_size)
+			return -2;
+
+		streams[k] = data;
+		data += stream_size;
+	}
+
+	if (data != buffer + buffer_size)
+		return -3;
+
+	if (vertex_count)
+		vertices[0] = first;
+
+#ifdef SIMD_SSE
+	// the scalar decoder is always available so that SIMD level 0 can be used as a reference
+	if (meshopt_getSimdLevel() >= meshopt_SimdBaseline)
+	{
+		decodeMeshletVerticesSimd(vertices, vertex_count, first, header, streams, vertex_groups);
+		decodeMeshletTrianglesSimd(triangles, triangle_count * 3, header, vertex_groups * 4, streams[4], triangle_groups);
+
+		return 0;
+	}
+#endif
+
+	decodeMeshletVertices(vertices, vertex_count, first, header, streams, vertex_groups);
+	decodeMeshletTriangles(triangles, triangle_count * 3, header, vertex_groups * 4, streams[4], triangle_groups);
+
+	return 0;
+}
+
+#undef SIMD_TARGET_ATTRIBUTE
+#undef SIMD_SSE
+#undef SIMD_FALLBACK
+#undef SIMD_TARGET
+#undef SIMD_SSSE3
+#undef SIMD_FALLBACK_SSSE3
+#undef SIMD_TARGET_SSSE3
+#undef SIMD_NEON
+#undef SIMD_WASM
+#undef SIMD_AVX2
+#undef SIMD_AVX
+#undef SIMD_TARGET_AVX2
+#undef SIMD_TARGET_AVX512
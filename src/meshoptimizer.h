@@ -38,6 +38,16 @@ struct meshopt_Stream
 	size_t stride;
 };
 
+/**
+ * Experimental: Job dispatch callback, used by functions that can process data on multiple threads
+ * The library doesn't create any threads; instead, work is split into job_count independent jobs and dispatch is called once per parallel phase.
+ * dispatch must call job(job_data, i) exactly once for each i in [0..job_count), in any order and on any thread, and return after all jobs complete.
+ * Jobs don't allocate memory, so allocation callbacks set via meshopt_setAllocator are only called from the thread that calls the library function.
+ * Passing NULL instead of a dispatch callback runs all jobs serially on the calling thread; context is passed to dispatch as is.
+ */
+typedef void (*meshopt_JobCallback)(void* job_data, size_t job_index);
+typedef void (*meshopt_DispatchCallback)(void* context, meshopt_JobCallback job, void* job_data, size_t job_count);
+
 /**
  * Generates a vertex remap table from the vertex buffer and an optional index buffer and returns number of unique vertices
  * As a result, all vertices that are binary equivalent map to the same (new) location, with no gaps in the resulting sequence.
@@ -202,7 +212,8 @@ MESHOPTIMIZER_API size_t meshopt_encodeIndexBufferBound(size_t index_count, size
 
 /**
  * Experimental: Set index encoder format version
- * version must specify the data format version to encode; valid values are 0 (decodable by all library versions) and 1 (decodable by 0.14+)
+ * version must specify the data format version to encode; valid values are 0 (decodable by all library versions), 1 (decodable by 0.14+) and 2 (chunked, see meshopt_decodeIndexBufferParallel)
+ * Version 2 splits triangles into chunks of 16384 that are encoded independently and appends a table with 8 bytes per chunk, which allows encoding and decoding chunks in parallel and decoding arbitrary triangle ranges.
  */
 MESHOPTIMIZER_EXPERIMENTAL void meshopt_encodeIndexVersion(int version);
 
@@ -216,6 +227,40 @@ MESHOPTIMIZER_EXPERIMENTAL void meshopt_encodeIndexVersion(int version);
  */
 MESHOPTIMIZER_API int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size);
 
+/**
+ * Experimental: Parallel index buffer encoder
+ * Encodes index data like meshopt_encodeIndexBuffer, splitting the work into jobs that run via dispatch (see meshopt_DispatchCallback); the results are identical to meshopt_encodeIndexBuffer.
+ * Only version 2 (see meshopt_encodeIndexVersion) can be encoded in parallel; every job encodes its chunks into worst case regions of the buffer, which are then packed together.
+ *
+ * buffer must contain enough space for the encoded index buffer (use meshopt_encodeIndexBufferBound to compute worst case size); smaller buffers are encoded serially
+ * dispatch can be NULL, in which case the buffer is encoded serially on the calling thread
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeIndexBufferParallel(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count, meshopt_DispatchCallback dispatch, void* context);
+
+/**
+ * Experimental: Parallel index buffer decoder
+ * Decodes index data from an array of bytes generated by meshopt_encodeIndexBuffer, splitting the work into jobs that run via dispatch (see meshopt_DispatchCallback)
+ * Returns 0 if decoding was successful, and an error code otherwise; the results are identical to meshopt_decodeIndexBuffer.
+ * Only data encoded with version 2 (see meshopt_encodeIndexVersion) can be decoded in parallel; earlier versions are decoded serially on the calling thread.
+ *
+ * destination must contain enough space for the resulting index buffer (index_count elements)
+ * dispatch can be NULL, in which case all jobs are executed serially on the calling thread
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeIndexBufferParallel(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size, meshopt_DispatchCallback dispatch, void* context);
+
+/**
+ * Experimental: Index buffer range decoder
+ * Decodes count indices starting from first_index from an array of bytes generated by meshopt_encodeIndexBuffer
+ * Returns 0 if decoding was successful, and an error code otherwise
+ * For data encoded with version 2 (see meshopt_encodeIndexVersion) the decoder seeks to the first chunk of the range using the chunk table and only decodes chunks that overlap the range.
+ * For data encoded with earlier versions all triangles before the range need to be decoded as well, so the cost is proportional to first_index + count; the memory usage doesn't depend on the range.
+ * The decoder is safe to use for untrusted input, but it may produce garbage data; unlike meshopt_decodeIndexBuffer, data outside of the range isn't validated.
+ *
+ * destination must contain enough space for the resulting index range (count elements)
+ * index_count must be equal to the number of indices in the entire encoded buffer; first_index and count must be divisible by 3, and first_index + count must not exceed index_count
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeIndexBufferRange(void* destination, size_t first_index, size_t count, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size);
+
 /**
  * Experimental: Index sequence encoder
  * Encodes index sequence into an array of bytes that is generally smaller and compresses better compared to original.
@@ -251,7 +296,11 @@ MESHOPTIMIZER_API size_t meshopt_encodeVertexBufferBound(size_t vertex_count, si
 
 /**
  * Experimental: Set vertex encoder format version
- * version must specify the data format version to encode; valid values are 0 (decodable by all library versions)
+ * version must specify the data format version to encode; valid values are 0 (decodable by all library versions) and 1 (seekable, see meshopt_decodeVertexBufferRange)
+ * Version 1 encodes each vertex block independently and appends a table with 4 bytes per block that stores block offsets, which allows decoding arbitrary vertex ranges.
+ * Version 1 also stores the first vertex after the header, which allows meshopt_VertexDecoder to produce final vertices before the entire buffer arrives.
+ * Version 1 uses its own header byte (0xa1) since its layout can't be decoded as version 0; decoders that only support version 0 reject it instead of producing garbage.
+ * All decoders return -1 for versions they don't know, but the version number isn't coordinated with other implementations of the format, so version 1 data should only be decoded by this library.
  */
 MESHOPTIMIZER_EXPERIMENTAL void meshopt_encodeVertexVersion(int version);
 
@@ -265,6 +314,51 @@ MESHOPTIMIZER_EXPERIMENTAL void meshopt_encodeVertexVersion(int version);
  */
 MESHOPTIMIZER_API int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size);
 
+/**
+ * Experimental: Parallel vertex buffer decoder
+ * Decodes vertex data from an array of bytes generated by meshopt_encodeVertexBuffer, splitting the work into jobs that run via dispatch (see meshopt_DispatchCallback)
+ * Returns 0 if decoding was successful, and an error code otherwise; the results are identical to meshopt_decodeVertexBuffer.
+ * Since vertex blocks are delta-encoded relative to the previous block, the decoder locates the blocks using a serial scan over block headers, decodes runs of blocks in parallel and then adjusts each run based on the run that precedes it.
+ *
+ * destination must contain enough space for the resulting vertex buffer (vertex_count * vertex_size bytes)
+ * dispatch can be NULL, in which case all jobs are executed serially on the calling thread
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeVertexBufferParallel(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size, meshopt_DispatchCallback dispatch, void* context);
+
+/**
+ * Experimental: Vertex buffer range decoder
+ * Decodes count vertices starting from first_vertex from an array of bytes generated by meshopt_encodeVertexBuffer
+ * Returns 0 if decoding was successful, and an error code otherwise
+ * For data encoded with version 1 (see meshopt_encodeVertexVersion) the decoder seeks to the first block of the range using the block offset table and only decodes blocks that overlap the range.
+ * For data encoded with version 0 all blocks before the range need to be decoded as well, so the cost is proportional to first_vertex + count.
+ * The decoder is safe to use for untrusted input, but it may produce garbage data; unlike meshopt_decodeVertexBuffer, data outside of the range isn't validated.
+ *
+ * destination must contain enough space for the resulting vertex range (count * vertex_size bytes)
+ * vertex_count must be equal to the number of vertices in the entire encoded buffer; first_vertex + count must not exceed vertex_count
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeVertexBufferRange(void* destination, size_t first_vertex, size_t count, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size);
+
+/**
+ * Experimental: Streaming vertex buffer decoder
+ * Decodes vertex data generated by meshopt_encodeVertexBuffer incrementally, as chunks of the encoded buffer arrive (e.g. from network)
+ * meshopt_createVertexDecoder prepares the decoder to write vertex_count vertices into destination (vertex_count * vertex_size bytes); the decoder must be destroyed with meshopt_destroyVertexDecoder.
+ * meshopt_feedVertexDecoder consumes the next size bytes of the encoded buffer and decodes all blocks that are complete; returns 0 on success and an error code otherwise.
+ * meshopt_finishVertexDecoder must be called after the entire buffer has been fed; returns 0 if decoding was successful, and an error code otherwise.
+ * The decoder accepts the same inputs and produces the same results as meshopt_decodeVertexBuffer, except that the block offset table of version 1 streams is skipped instead of validated.
+ * The decoder is safe to use for untrusted input, but it may produce garbage data in destination, including for the vertices that were reported as ready.
+ *
+ * meshopt_getVertexDecoderReady returns the number of vertices at the start of destination that have their final values.
+ * Version 1 streams (see meshopt_encodeVertexVersion) store the first vertex before vertex blocks, so every block is final as soon as it's decoded; version 0 streams store it at the end, so all vertices only become ready in meshopt_finishVertexDecoder.
+ * Every feed only scans and decodes data that hasn't been processed before; the decoder keeps at most one encoded block (~13 KB) in memory.
+ */
+struct meshopt_VertexDecoder;
+
+MESHOPTIMIZER_EXPERIMENTAL struct meshopt_VertexDecoder* meshopt_createVertexDecoder(void* destination, size_t vertex_count, size_t vertex_size);
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_feedVertexDecoder(struct meshopt_VertexDecoder* decoder, const unsigned char* data, size_t size);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_getVertexDecoderReady(const struct meshopt_VertexDecoder* decoder);
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_finishVertexDecoder(struct meshopt_VertexDecoder* decoder);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_destroyVertexDecoder(struct meshopt_VertexDecoder* decoder);
+
 /**
  * Vertex buffer filters
  * These functions can be used to filter output of meshopt_decodeVertexBuffer in-place.
@@ -282,6 +376,37 @@ MESHOPTIMIZER_EXPERIMENTAL void meshopt_decodeFilterOct(void* buffer, size_t ver
 MESHOPTIMIZER_EXPERIMENTAL void meshopt_decodeFilterQuat(void* buffer, size_t vertex_count, size_t vertex_size);
 MESHOPTIMIZER_EXPERIMENTAL void meshopt_decodeFilterExp(void* buffer, size_t vertex_count, size_t vertex_size);
 
+typedef void (*meshopt_FilterCallback)(void* buffer, size_t vertex_count, size_t vertex_size);
+
+/**
+ * Experimental: Vertex buffer decoder with a filter
+ * Decodes vertex data like meshopt_decodeVertexBuffer and applies filter to each block of vertices while it's in the decoder's scratch memory, before it's copied to destination, which avoids a second pass over destination memory
+ * Returns 0 if decoding was successful, and an error code otherwise; the results are identical to meshopt_decodeVertexBuffer followed by filter.
+ *
+ * filter is typically one of meshopt_decodeFilterOct/Quat/Exp; it's called with vertex_size and a pointer to scratch memory for each block, so it must process vertices independently. filter can be NULL.
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeVertexBufferFiltered(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size, meshopt_FilterCallback filter);
+
+enum meshopt_SimdLevel
+{
+	/* SIMD kernels are not used */
+	meshopt_SimdScalar = 0,
+	/* SSE2 on x86 (used by vertex filters, meshlet codec and cluster bounds); NEON and WebAssembly SIMD also use this level */
+	meshopt_SimdBaseline = 1,
+	/* SSSE3, used by the vertex codec */
+	meshopt_SimdSSSE3 = 2,
+	meshopt_SimdAVX2 = 3,
+	/* AVX-512 VBMI2 */
+	meshopt_SimdAVX512 = 4
+};
+
+/**
+ * Experimental: Returns SIMD instruction set used by SIMD kernels in the current process as one of meshopt_SimdLevel values, for diagnostics
+ * SIMD kernels are selected once per process based on CPU features; each function uses the kernels for the highest level that it supports and that doesn't exceed the result.
+ * NEON and WebAssembly SIMD are always enabled at compile time and return meshopt_SimdBaseline.
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_getSimdLevel(void);
+
 /**
  * Experimental: Mesh simplifier
  * Reduces the number of triangles in the mesh, attempting to preserve mesh appearance as much as possible
@@ -298,6 +423,59 @@ MESHOPTIMIZER_EXPERIMENTAL void meshopt_decodeFilterExp(void* buffer, size_t ver
  */
 MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* result_error);
 
+/**
+ * Experimental: Mesh simplifier with attribute metric and vertex locking
+ * The algorithm works the same as meshopt_simplify, but also takes vertex attributes (normals, texture coordinates, colors) into account when ranking collapses.
+ * Each collapse minimizes the combined error of positions and attributes, which reduces texture swimming and shading artifacts at the same triangle count.
+ * Vertices can be locked to keep them in the result, for example to keep borders between separately simplified parts of a mesh (like streamed tiles) crack-free.
+ *
+ * vertex_attributes should have attribute_count floats for each vertex
+ * attribute_weights should have attribute_count floats in total; the weights determine the relative priority of attributes between each other and wrt position. The recommended weight range is [1e-3..1e-1], assuming attribute data is in [0..1] range.
+ * attribute_count must be <= 16
+ * target_error and result_error combine position and attribute error; attribute error is measured as the weighted attribute difference
+ * vertex_lock can be NULL; when it's not NULL, it should have a value for each vertex; 1 means the vertex can't be moved or removed, which also applies to all other vertices with the same position
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyWithAttributes(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, float* result_error);
+
+/**
+ * Experimental: Mesh simplifier for LOD chains
+ * Generates lod_count levels of detail in a single incremental run; each level continues simplification from the previous one, reusing adjacency, quadrics and vertex classification.
+ * Levels are nested: every level references the original vertex buffer and only uses vertices that are referenced by the previous level, so all levels can share one vertex buffer.
+ * Returns the total number of indices written to destination; level i is stored after levels 0..i-1, and lod_index_counts[i] receives its index count.
+ *
+ * destination must contain enough space for all levels, worst case is index_count * lod_count elements
+ * target_index_counts and target_errors should have lod_count elements, with targets decreasing from level to level; a level that can't be simplified further is identical to the previous one
+ * result_errors can be NULL; when it's not NULL, it should have lod_count elements and will contain the resulting (relative) error of each level
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyLodChain(unsigned int* destination, size_t* lod_index_counts, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const size_t* target_index_counts, const float* target_errors, size_t lod_count, float* result_errors);
+
+/**
+ * Experimental: Reusable mesh simplifier context
+ * Caches the mesh analysis (adjacency, position remap, vertex classification, quadrics) for one index/position buffer pair so that repeated simplification queries only pay for the collapse passes.
+ * meshopt_simplifyWithContext produces the same result as meshopt_simplify with the same source data and parameters; the source buffers are copied and don't need to outlive the context.
+ * The context must be destroyed with meshopt_destroySimplifierContext; queries on the same context must not run concurrently.
+ *
+ * destination must contain enough space for the source index buffer (since optimization is iterative, this means index_count elements - *not* target_index_count!)
+ */
+struct meshopt_SimplifierContext;
+
+MESHOPTIMIZER_EXPERIMENTAL struct meshopt_SimplifierContext* meshopt_createSimplifierContext(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyWithContext(struct meshopt_SimplifierContext* context, unsigned int* destination, size_t target_index_count, float target_error, float* result_error);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_destroySimplifierContext(struct meshopt_SimplifierContext* context);
+
+/**
+ * Experimental: Out-of-core mesh simplifier
+ * Simplifies meshes that are too large to simplify in one go, keeping temporary memory approximately within memory_budget bytes.
+ * The mesh is partitioned into spatially coherent batches of triangles (using Morton order of a uniform grid) that are simplified independently with vertices on the batch borders locked; this repeats with a shifted grid until the remaining mesh fits into the budget, after which it's simplified as a whole to reach the target.
+ * Source buffers are only read sequentially or through indices, so they can be memory mapped; destination can be the same as indices.
+ * Returns the number of indices after simplification; if the budget is too small for the borders between batches to be simplified, the result may have more indices than requested.
+ *
+ * destination must contain enough space for the source index buffer (index_count elements)
+ * memory_budget assumes that meshes have at most one vertex per triangle, which is typical for meshes with few attribute seams
+ * memory_budget also needs to cover a fixed cost of 13-18 bytes per vertex that are used to find batch borders; smaller budgets are exceeded, as every grid cell is then simplified as a separate batch
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyOutOfCore(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* result_error, size_t memory_budget);
+
 /**
  * Experimental: Mesh simplifier (sloppy)
  * Reduces the number of triangles in the mesh, sacrificing mesh apperance for simplification performance
@@ -313,6 +491,17 @@ MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplify(unsigned int* destination, co
  */
 MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifySloppy(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* result_error);
 
+/**
+ * Experimental: Parallel sloppy mesh simplifier
+ * Simplifies the mesh like meshopt_simplifySloppy, splitting position normalization and every step of the grid size search into jobs that run via dispatch (see meshopt_DispatchCallback); the results are identical to meshopt_simplifySloppy.
+ * Grid sizes are still probed one after another, and building the cell table, accumulating cell quadrics and filtering duplicate triangles are performed serially.
+ * The serial steps bound the achievable latency: on a 1M triangle mesh they alone take ~50 ms, so this function does not reach interactive (<10 ms) simplification times for meshes of that size.
+ *
+ * destination must contain enough space for the target index buffer, worst case is index_count elements (*not* target_index_count)!
+ * dispatch can be NULL, in which case the mesh is simplified serially on the calling thread
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifySloppyParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* result_error, meshopt_DispatchCallback dispatch, void* context);
+
 /**
  * Experimental: Point cloud simplifier
  * Reduces the number of points in the cloud to reach the given target
@@ -333,6 +522,17 @@ MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyPoints(unsigned int* destinati
  */
 MESHOPTIMIZER_EXPERIMENTAL float meshopt_simplifyScale(const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
 
+/**
+ * Experimental: Hausdorff distance estimator
+ * Returns a conservative bound of the one-sided Hausdorff distance from the surface of the first mesh to the surface of the second mesh, i.e. the largest distance from any point on the first mesh to the nearest point on the second mesh.
+ * The distance is relative to the mesh extents, same as the error returned by meshopt_simplify, and can be converted to absolute distance with meshopt_simplifyScale.
+ * The result is never smaller than the exact distance and exceeds it by at most ~3% (or 1e-5 for nearly identical surfaces); FLT_MAX is returned when the second mesh is empty.
+ * To measure how far a simplified mesh deviates from the source, pass the simplified indices first; the other order detects parts of the source that were removed, and the larger of the two is the symmetric Hausdorff distance.
+ *
+ * indices and target_indices must refer to the same vertex buffer, e.g. the source and the output of meshopt_simplify
+ */
+MESHOPTIMIZER_EXPERIMENTAL float meshopt_computeHausdorffDistance(const unsigned int* indices, size_t index_count, const unsigned int* target_indices, size_t target_index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
+
 /**
  * Mesh stripifier
  * Converts a previously vertex cache optimized triangle list to triangle strip, stitching strips using restart index or degenerate triangles
@@ -429,6 +629,69 @@ MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildMeshlets(struct meshopt_Meshlet*
 MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildMeshletsScan(struct meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, size_t vertex_count, size_t max_vertices, size_t max_triangles);
 MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildMeshletsBound(size_t index_count, size_t max_vertices, size_t max_triangles);
 
+/**
+ * Experimental: Parallel meshlet builder
+ * Splits the mesh into meshlets like meshopt_buildMeshlets, but first sorts triangles spatially (see meshopt_spatialSortTriangles) and splits them into partitions of up to 16K triangles (a multiple of max_triangles) that are clusterized in jobs that run via dispatch (see meshopt_DispatchCallback).
+ * Meshlets never cross partition boundaries, so the result is slightly less efficient than that of meshopt_buildMeshlets; the results don't depend on the number of threads.
+ *
+ * meshlets must contain enough space for all meshlets, worst case size can be computed with meshopt_buildMeshletsParallelBound; it can exceed meshopt_buildMeshletsBound by up to one meshlet per partition
+ * meshlet_vertices and meshlet_triangles must contain enough space for max_meshlets * max_vertices and max_meshlets * max_triangles * 3 elements
+ * dispatch can be NULL, in which case all partitions are clusterized serially on the calling thread
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildMeshletsParallel(struct meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight, meshopt_DispatchCallback dispatch, void* context);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildMeshletsParallelBound(size_t index_count, size_t max_vertices, size_t max_triangles);
+
+/**
+ * Experimental: Spatial meshlet builder
+ * Splits the mesh into meshlets that are optimized for ray tracing, where each meshlet is used to build a bottom-level acceleration structure or a cluster within it.
+ * Instead of maximizing vertex reuse, the mesh is split recursively using the surface area heuristic, which minimizes the total surface area of meshlet bounding boxes (and with it, expected traversal cost).
+ * The result uses the same layout as meshopt_buildMeshlets; meshlet_aabbs receives the bounding box of each meshlet (min xyz, max xyz) and can be NULL.
+ *
+ * meshlets must contain enough space for all meshlets, worst case size can be computed with meshopt_buildMeshletsSpatialBound
+ * meshlet_vertices and meshlet_triangles must contain enough space for max_meshlets * max_vertices and max_meshlets * max_triangles * 3 elements
+ * meshlet_aabbs must contain enough space for max_meshlets * 6 floats
+ * max_triangles can go up to 1024, but since meshlets are still limited to 255 vertices, meshlets with more than ~500 triangles are only possible with significant vertex reuse
+ * min_triangles should be at most max_triangles / 2; meshlets are only split below min_triangles when they exceed max_vertices
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildMeshletsSpatial(struct meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, float* meshlet_aabbs, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t min_triangles, size_t max_triangles);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildMeshletsSpatialBound(size_t index_count, size_t max_vertices, size_t min_triangles);
+
+/**
+ * Experimental: Meshlet optimizer
+ * Reorders meshlet triangles to maximize vertex reuse between consecutive triangles, and then reorders meshlet vertices in the order of first use.
+ * This improves locality of vertex accesses within the mesh shader and makes meshlet data more compressible (see meshopt_encodeMeshlet); the set of triangles and their winding is preserved.
+ * The function doesn't allocate memory and only touches the data of one meshlet, so it's safe to run it for multiple meshlets in parallel.
+ *
+ * meshlet_vertices and meshlet_triangles must refer to the vertex and triangle data of one meshlet; when meshopt_buildMeshlets* is used, these need to be offset by meshlet vertex_offset and triangle_offset
+ * triangle_count and vertex_count must not exceed implementation limits (vertex_count <= 255, triangle_count <= 1024)
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_optimizeMeshlet(unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, size_t triangle_count, size_t vertex_count);
+
+/**
+ * Experimental: Meshlet encoder
+ * Encodes meshlet vertex references and micro index buffer into an array of bytes that is generally smaller than the source data and is fast to decode.
+ * Vertex references are delta-encoded, so meshlets that reference a compact range of vertices (e.g. after meshopt_optimizeVertexFetch) compress better.
+ * Triangles compress best when local vertex indices are assigned in the order of first use, which is the case for the output of meshlet builders.
+ * Returns encoded data size on success, 0 on error; the only error condition is if buffer doesn't have enough space (encoded data always has a header, so even empty meshlets encode to a non-zero size)
+ * Vertex and triangle counts are not stored in the encoded data and need to be stored separately (e.g. in meshopt_Meshlet).
+ *
+ * buffer must contain enough space for the encoded meshlet; you can use meshopt_encodeMeshletBound to compute worst case size
+ * triangles should contain triangle_count * 3 local vertex indices
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeMeshlet(unsigned char* buffer, size_t buffer_size, const unsigned int* vertices, size_t vertex_count, const unsigned char* triangles, size_t triangle_count);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeMeshletBound(size_t max_vertices, size_t max_triangles);
+
+/**
+ * Experimental: Meshlet decoder
+ * Decodes meshlet data from an array of bytes generated by meshopt_encodeMeshlet
+ * Returns 0 if decoding was successful, and an error code otherwise
+ * The decoder is safe to use for untrusted input, but it may produce garbage data (e.g. out of range indices).
+ *
+ * vertices must contain enough space for vertex_count elements
+ * triangles must contain enough space for triangle_count * 3 elements
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeMeshlet(unsigned int* vertices, size_t vertex_count, unsigned char* triangles, size_t triangle_count, const unsigned char* buffer, size_t buffer_size);
+
 struct meshopt_Bounds
 {
 	/* bounding sphere, useful for frustum and occlusion culling */
@@ -469,6 +732,59 @@ struct meshopt_Bounds
 MESHOPTIMIZER_EXPERIMENTAL struct meshopt_Bounds meshopt_computeClusterBounds(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
 MESHOPTIMIZER_EXPERIMENTAL struct meshopt_Bounds meshopt_computeMeshletBounds(const unsigned int* meshlet_vertices, const unsigned char* meshlet_triangles, size_t triangle_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
 
+/**
+ * Experimental: Batched cluster bounds generator
+ * Computes bounds for all meshlets like meshopt_computeMeshletBounds, splitting the meshlets into jobs of 256 that run via dispatch (see meshopt_DispatchCallback).
+ * The results may differ from meshopt_computeMeshletBounds by a few ulps, since the bounding sphere is computed once per unique meshlet vertex instead of once per triangle corner.
+ *
+ * bounds must contain enough space for meshlet_count elements
+ * meshlets should have at most 1024 triangles each (which covers meshlets produced by meshopt_buildMeshletsSpatial), and meshlet_vertices/meshlet_triangles should be indexed by meshlet offsets as produced by meshopt_buildMeshlets
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_computeMeshletBoundsBatch(struct meshopt_Bounds* bounds, const struct meshopt_Meshlet* meshlets, size_t meshlet_count, const unsigned int* meshlet_vertices, const unsigned char* meshlet_triangles, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, meshopt_DispatchCallback dispatch, void* context);
+
+struct meshopt_LodCluster
+{
+	/* offsets within cluster_vertices and cluster_triangles arrays with cluster data, same as meshopt_Meshlet */
+	unsigned int vertex_offset;
+	unsigned int triangle_offset;
+
+	/* number of vertices and triangles used in the cluster */
+	unsigned int vertex_count;
+	unsigned int triangle_count;
+
+	/* level of detail; 0 for clusters of the source mesh */
+	unsigned int level;
+
+	/* group that produced this cluster by simplification (~0u for level 0) and group that this cluster was simplified in (~0u if there is none) */
+	unsigned int group;
+	unsigned int parent_group;
+
+	/* bounding sphere and simplification error of the group that produced this cluster; error is 0 for level 0 */
+	float center[3];
+	float radius;
+	float error;
+
+	/* bounding sphere and simplification error of the group that this cluster was simplified in; parent_error is FLT_MAX if there is none */
+	float parent_center[3];
+	float parent_radius;
+	float parent_error;
+};
+
+/**
+ * Experimental: Cluster LOD hierarchy builder
+ * Splits the mesh into clusters (same as meshopt_buildMeshlets), and then repeatedly groups adjacent clusters, simplifies each group to half of its triangles with the group border locked and splits the result into new clusters.
+ * The result is a DAG of clusters that all reference the source vertex buffer; any cut through the DAG forms a crack-free mesh.
+ * For runtime selection, a cluster should be rendered when its error is acceptable and its parent error is not, with errors projected using the corresponding spheres; errors are in the same units as positions and never decrease from child to parent.
+ * Returns the number of clusters; if the capacity is exceeded, groups that don't fit are not simplified further so the hierarchy has fewer levels.
+ *
+ * clusters must contain enough space for cluster_capacity elements; capacity must be at least meshopt_buildMeshletsBound(index_count, max_vertices, max_triangles), and meshopt_buildClusterLodBound gives the recommended capacity
+ * cluster_vertices must contain enough space for cluster_capacity * max_vertices elements
+ * cluster_triangles must contain enough space for cluster_capacity * max_triangles * 3 elements
+ * max_vertices and max_triangles have the same limits as in meshopt_buildMeshlets
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildClusterLod(struct meshopt_LodCluster* clusters, unsigned int* cluster_vertices, unsigned char* cluster_triangles, size_t cluster_capacity, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildClusterLodBound(size_t index_count, size_t max_vertices, size_t max_triangles);
+
 /**
  * Experimental: Spatial sorter
  * Generates a remap table that can be used to reorder points for spatial locality.
@@ -577,8 +893,18 @@ inline int meshopt_decodeIndexSequence(T* destination, size_t index_count, const
 template <typename T>
 inline size_t meshopt_simplify(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* result_error = 0);
 template <typename T>
+inline size_t meshopt_simplifyWithAttributes(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, float* result_error = 0);
+template <typename T>
+inline size_t meshopt_simplifyLodChain(T* destination, size_t* lod_index_counts, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const size_t* target_index_counts, const float* target_errors, size_t lod_count, float* result_errors = 0);
+template <typename T>
+inline size_t meshopt_simplifyOutOfCore(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* result_error, size_t memory_budget);
+template <typename T>
 inline size_t meshopt_simplifySloppy(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* result_error = 0);
 template <typename T>
+inline size_t meshopt_simplifySloppyParallel(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* result_error, meshopt_DispatchCallback dispatch, void* context);
+template <typename T>
+inline float meshopt_computeHausdorffDistance(const T* indices, size_t index_count, const T* target_indices, size_t target_index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
+template <typename T>
 inline size_t meshopt_stripify(T* destination, const T* indices, size_t index_count, size_t vertex_count, T restart_index);
 template <typename T>
 inline size_t meshopt_unstripify(T* destination, const T* indices, size_t index_count, T restart_index);
@@ -593,6 +919,12 @@ inline size_t meshopt_buildMeshlets(meshopt_Meshlet* meshlets, unsigned int* mes
 template <typename T>
 inline size_t meshopt_buildMeshletsScan(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const T* indices, size_t index_count, size_t vertex_count, size_t max_vertices, size_t max_triangles);
 template <typename T>
+inline size_t meshopt_buildMeshletsParallel(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight, meshopt_DispatchCallback dispatch, void* context);
+template <typename T>
+inline size_t meshopt_buildMeshletsSpatial(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, float* meshlet_aabbs, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t min_triangles, size_t max_triangles);
+template <typename T>
+inline size_t meshopt_buildClusterLod(meshopt_LodCluster* clusters, unsigned int* cluster_vertices, unsigned char* cluster_triangles, size_t cluster_capacity, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles);
+template <typename T>
 inline meshopt_Bounds meshopt_computeClusterBounds(const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
 template <typename T>
 inline void meshopt_spatialSortTriangles(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
@@ -918,6 +1250,33 @@ inline size_t meshopt_simplify(T* destination, const T* indices, size_t index_co
 	return meshopt_simplify(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, target_index_count, target_error, result_error);
 }
 
+template <typename T>
+inline size_t meshopt_simplifyWithAttributes(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, float* result_error)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, index_count);
+
+	return meshopt_simplifyWithAttributes(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, vertex_attributes, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, target_index_count, target_error, result_error);
+}
+
+template <typename T>
+inline size_t meshopt_simplifyLodChain(T* destination, size_t* lod_index_counts, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const size_t* target_index_counts, const float* target_errors, size_t lod_count, float* result_errors)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, index_count * lod_count);
+
+	return meshopt_simplifyLodChain(out.data, lod_index_counts, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, target_index_counts, target_errors, lod_count, result_errors);
+}
+
+template <typename T>
+inline size_t meshopt_simplifyOutOfCore(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* result_error, size_t memory_budget)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, index_count);
+
+	return meshopt_simplifyOutOfCore(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, target_index_count, target_error, result_error, memory_budget);
+}
+
 template <typename T>
 inline size_t meshopt_simplifySloppy(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* result_error)
 {
@@ -927,6 +1286,24 @@ inline size_t meshopt_simplifySloppy(T* destination, const T* indices, size_t in
 	return meshopt_simplifySloppy(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, target_index_count, target_error, result_error);
 }
 
+template <typename T>
+inline size_t meshopt_simplifySloppyParallel(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* result_error, meshopt_DispatchCallback dispatch, void* context)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, index_count);
+
+	return meshopt_simplifySloppyParallel(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, target_index_count, target_error, result_error, dispatch, context);
+}
+
+template <typename T>
+inline float meshopt_computeHausdorffDistance(const T* indices, size_t index_count, const T* target_indices, size_t target_index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> target(0, target_indices, target_index_count);
+
+	return meshopt_computeHausdorffDistance(in.data, index_count, target.data, target_index_count, vertex_positions, vertex_count, vertex_positions_stride);
+}
+
 template <typename T>
 inline size_t meshopt_stripify(T* destination, const T* indices, size_t index_count, size_t vertex_count, T restart_index)
 {
@@ -985,6 +1362,30 @@ inline size_t meshopt_buildMeshletsScan(meshopt_Meshlet* meshlets, unsigned int*
 	return meshopt_buildMeshletsScan(meshlets, meshlet_vertices, meshlet_triangles, in.data, index_count, vertex_count, max_vertices, max_triangles);
 }
 
+template <typename T>
+inline size_t meshopt_buildMeshletsParallel(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight, meshopt_DispatchCallback dispatch, void* context)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+
+	return meshopt_buildMeshletsParallel(meshlets, meshlet_vertices, meshlet_triangles, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, max_vertices, max_triangles, cone_weight, dispatch, context);
+}
+
+template <typename T>
+inline size_t meshopt_buildMeshletsSpatial(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, float* meshlet_aabbs, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t min_triangles, size_t max_triangles)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+
+	return meshopt_buildMeshletsSpatial(meshlets, meshlet_vertices, meshlet_triangles, meshlet_aabbs, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, max_vertices, min_triangles, max_triangles);
+}
+
+template <typename T>
+inline size_t meshopt_buildClusterLod(meshopt_LodCluster* clusters, unsigned int* cluster_vertices, unsigned char* cluster_triangles, size_t cluster_capacity, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+
+	return meshopt_buildClusterLod(clusters, cluster_vertices, cluster_triangles, cluster_capacity, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, max_vertices, max_triangles);
+}
+
 template <typename T>
 inline meshopt_Bounds meshopt_computeClusterBounds(const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
 {
@@ -0,0 +1,115 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+// Internal header that auto-detects SIMD ISA that can be used on the target platform
+// Source files that include it undefine all SIMD_* macros at the end, so this file intentionally doesn't have an include guard
+#ifndef MESHOPTIMIZER_NO_SIMD
+
+// GCC 4.9+ and clang 3.8+ support targeting SIMD ISA from individual functions
+#if (defined(__clang__) && __clang_major__ * 100 + __clang_minor__ >= 308) || (defined(__GNUC__) && __GNUC__ * 100 + __GNUC_MINOR__ >= 409)
+#define SIMD_TARGET_ATTRIBUTE
+#endif
+
+// SSE2 kernels can be enabled unconditionally through compiler settings; SSE2 is always available on x64
+#if defined(__SSE2__)
+#define SIMD_SSE
+#endif
+
+// MSVC supports compiling SSE2 code regardless of compile options; we assume all 32-bit CPUs support SSE2
+#if !defined(SIMD_SSE) && defined(_MSC_VER) && !defined(__clang__) && (defined(_M_IX86) || defined(_M_X64))
+#define SIMD_SSE
+#endif
+
+// On 32-bit x86 we target SSE2 from individual functions and use a cpuid-based scalar fallback
+#if !defined(SIMD_SSE) && defined(SIMD_TARGET_ATTRIBUTE) && defined(__i386__)
+#define SIMD_SSE
+#define SIMD_FALLBACK
+#define SIMD_TARGET __attribute__((target("sse2")))
+#endif
+
+// SSSE3 kernels (vertex codec) can be enabled unconditionally through compiler settings
+#if defined(SIMD_SSE) && (defined(__AVX__) || defined(__SSSE3__))
+#define SIMD_SSSE3
+#endif
+
+// MSVC supports compiling SSSE3 code regardless of compile options, and GCC/clang can target SSSE3 from individual functions; we use a cpuid-based scalar fallback
+#if defined(SIMD_SSE) && !defined(SIMD_SSSE3) && ((defined(_MSC_VER) && !defined(__clang__)) || defined(SIMD_TARGET_ATTRIBUTE))
+#define SIMD_SSSE3
+#define SIMD_FALLBACK_SSSE3
+#ifdef SIMD_TARGET_ATTRIBUTE
+#define SIMD_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+#endif
+
+// GCC/clang define these when NEON support is available
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define SIMD_NEON
+#endif
+
+// On MSVC, we assume that ARM builds always target NEON-capable devices
+#if !defined(SIMD_NEON) && defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
+#define SIMD_NEON
+#endif
+
+// When targeting Wasm SIMD we can't use runtime cpuid checks so we unconditionally enable SIMD
+#if defined(__wasm_simd128__)
+#define SIMD_WASM
+#endif
+
+// AVX2 implementation is selected at runtime based on cpuid on compilers that support targeting SIMD ISA from individual functions
+#if defined(SIMD_SSSE3) && (defined(SIMD_TARGET_ATTRIBUTE) || (defined(_MSC_VER) && _MSC_VER >= 1700)) && (defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__))
+#define SIMD_AVX2
+#endif
+
+// An experimental implementation using AVX512 VBMI2 instructions; it's selected at runtime based on cpuid when the compiler can target AVX512 from individual functions
+#if defined(SIMD_AVX2) && ((defined(__AVX512VBMI2__) && defined(__AVX512VBMI__) && defined(__AVX512VL__) && defined(__POPCNT__)) || (defined(__clang__) && ((!defined(__apple_build_version__) && __clang_major__ >= 8) || __clang_major__ >= 11)) || (defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 8) || (defined(_MSC_VER) && _MSC_VER >= 1920))
+#define SIMD_AVX
+#endif
+
+#if defined(SIMD_AVX2) && defined(__GNUC__)
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#endif
+
+#if defined(SIMD_AVX) && defined(__GNUC__)
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vl,avx512vbmi,avx512vbmi2,avx2,popcnt")))
+#endif
+
+#endif // !MESHOPTIMIZER_NO_SIMD
+
+#ifndef SIMD_TARGET
+#define SIMD_TARGET
+#endif
+
+#ifndef SIMD_TARGET_SSSE3
+#define SIMD_TARGET_SSSE3
+#endif
+
+#ifndef SIMD_TARGET_AVX2
+#define SIMD_TARGET_AVX2
+#endif
+
+#ifndef SIMD_TARGET_AVX512
+#define SIMD_TARGET_AVX512
+#endif
+
+#ifdef SIMD_SSE
+#include <emmintrin.h>
+#endif
+
+#ifdef SIMD_SSSE3
+#include <tmmintrin.h>
+#endif
+
+#if defined(SIMD_AVX) || defined(SIMD_AVX2)
+#include <immintrin.h>
+#endif
+
+#ifdef SIMD_NEON
+#if defined(_MSC_VER) && defined(_M_ARM64)
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
+#ifdef SIMD_WASM
+#include <wasm_simd128.h>
+#endif
@@ -6,6 +6,10 @@
 #include <math.h>
 #include <string.h>
 
+#include <new>
+
+#include "internal.h"
+
 #ifndef TRACE
 #define TRACE 0
 #endif
@@ -26,6 +30,7 @@
 // Peter Lindstrom. Out-of-Core Simplification of Large Polygonal Models. 2000
 // Matthias Teschner, Bruno Heidelberger, Matthias Mueller, Danat Pomeranets, Markus Gross. Optimized Spatial Hashing for Collision Detection of Deformable Objects. 2003
 // Peter Van Sandt, Yannis Chronis, Jignesh M. Patel. Efficiently Searching In-Memory Sorted Arrays: Revenge of the Interpolation Search? 2019
+// Hugues Hoppe. New Quadric Metric for Simplifying Meshes with Appearance Attributes. 1999
 namespace meshopt
 {
 
@@ -252,7 +257,7 @@ static bool hasEdge(const EdgeAdjacency& adjacency, unsigned int a, unsigned int
 	return false;
 }
 
-static void classifyVertices(unsigned char* result, unsigned int* loop, unsigned int* loopback, size_t vertex_count, const EdgeAdjacency& adjacency, const unsigned int* remap, const unsigned int* wedge)
+static void classifyVertices(unsigned char* result, unsigned int* loop, unsigned int* loopback, size_t vertex_count, const EdgeAdjacency& adjacency, const unsigned int* remap, const unsigned int* wedge, const unsigned char* vertex_lock)
 {
 	memset(loop, -1, vertex_count * sizeof(unsigned int));
 	memset(loopback, -1, vertex_count * sizeof(unsigned int));
@@ -345,6 +350,20 @@ static void classifyVertices(unsigned char* result, unsigned int* loop, unsigned
 				result[i] = Kind_Locked;
 				TRACESTATS(3);
 			}
+
+			// locking any vertex locks the position, which covers all vertices in the wedge ring
+			if (vertex_lock && result[i] != Kind_Locked)
+			{
+				unsigned int w = unsigned(i);
+
+				do
+				{
+					if (vertex_lock[w])
+						result[i] = Kind_Locked;
+
+					w = wedge[w];
+				} while (w != i);
+			}
 		}
 		else
 		{
@@ -413,6 +432,23 @@ static float rescalePositions(Vector3* result, const float* vertex_positions_dat
 	return extent;
 }
 
+static void rescaleAttributes(float* result, const float* vertex_attributes_data, size_t vertex_count, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count)
+{
+	size_t vertex_attributes_stride_float = vertex_attributes_stride / sizeof(float);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		for (size_t k = 0; k < attribute_count; ++k)
+		{
+			float a = vertex_attributes_data[i * vertex_attributes_stride_float + k];
+
+			result[i * attribute_count + k] = a * attribute_weights[k];
+		}
+	}
+}
+
+const size_t kMaxAttributes = 16;
+
 struct Quadric
 {
 	float a00, a11, a22;
@@ -421,6 +457,11 @@ struct Quadric
 	float w;
 };
 
+struct QuadricGrad
+{
+	float gx, gy, gz, gw;
+};
+
 struct Collapse
 {
 	unsigned int v0;
@@ -463,6 +504,17 @@ static void quadricAdd(Quadric& Q, const Quadric& R)
 	Q.w += R.w;
 }
 
+static void quadricAdd(QuadricGrad* G, const QuadricGrad* R, size_t attribute_count)
+{
+	for (size_t k = 0; k < attribute_count; ++k)
+	{
+		G[k].gx += R[k].gx;
+		G[k].gy += R[k].gy;
+		G[k].gz += R[k].gz;
+		G[k].gw += R[k].gw;
+	}
+}
+
 static float quadricError(const Quadric& Q, const Vector3& v)
 {
 	float rx = Q.b0;
@@ -491,6 +543,44 @@ static float quadricError(const Quadric& Q, const Vector3& v)
 	return fabsf(r) * s;
 }
 
+static float quadricError(const Quadric& Q, const QuadricGrad* G, size_t attribute_count, const Vector3& v, const float* va)
+{
+	float rx = Q.b0;
+	float ry = Q.b1;
+	float rz = Q.b2;
+
+	rx += Q.a10 * v.y;
+	ry += Q.a21 * v.z;
+	rz += Q.a20 * v.x;
+
+	rx *= 2;
+	ry *= 2;
+	rz *= 2;
+
+	rx += Q.a00 * v.x;
+	ry += Q.a11 * v.y;
+	rz += Q.a22 * v.z;
+
+	float r = Q.c;
+	r += rx * v.x;
+	r += ry * v.y;
+	r += rz * v.z;
+
+	// see quadricFromAttributes for the derivation; here we add the parts of (eval(pos) - attr)^2 that depend on attr
+	for (size_t k = 0; k < attribute_count; ++k)
+	{
+		float a = va[k];
+		float g = v.x * G[k].gx + v.y * G[k].gy + v.z * G[k].gz + G[k].gw;
+
+		r += a * a * Q.w;
+		r -= 2 * a * g;
+	}
+
+	float s = Q.w == 0.f ? 0.f : 1.f / Q.w;
+
+	return fabsf(r) * s;
+}
+
 static void quadricFromPlane(Quadric& Q, float a, float b, float c, float d, float w)
 {
 	float aw = a * w;
@@ -561,6 +651,80 @@ static void quadricFromTriangleEdge(Quadric& Q, const Vector3& p0, const Vector3
 	quadricFromPlane(Q, normal.x, normal.y, normal.z, -distance, length * weight);
 }
 
+static void quadricFromAttributes(Quadric& Q, QuadricGrad* G, const Vector3& p0, const Vector3& p1, const Vector3& p2, const float* va0, const float* va1, const float* va2, size_t attribute_count)
+{
+	// for each attribute we want to encode the following function into the quadric:
+	// (eval(pos) - attr)^2
+	// where eval(pos) interpolates the attribute linearly across the triangle like so:
+	// eval(pos) = pos.x * gx + pos.y * gy + pos.z * gz + gw
+	// where gx/gy/gz/gw are gradients
+	Vector3 p10 = {p1.x - p0.x, p1.y - p0.y, p1.z - p0.z};
+	Vector3 p20 = {p2.x - p0.x, p2.y - p0.y, p2.z - p0.z};
+
+	// the weight has to match the triangle weight in quadricFromTriangle
+	Vector3 normal = {p10.y * p20.z - p10.z * p20.y, p10.z * p20.x - p10.x * p20.z, p10.x * p20.y - p10.y * p20.x};
+	float area = sqrtf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+	float w = sqrtf(area);
+
+	// we compute gradients using barycentric coordinates; barycentric coordinates can be computed as follows:
+	// v = (d11 * d20 - d01 * d21) / denom
+	// w = (d00 * d21 - d01 * d20) / denom
+	// u = 1 - v - w
+	// here v0, v1 are triangle edge vectors, v2 is a vector from point to triangle corner, and dij = dot(vi, vj)
+	const Vector3& v0 = p10;
+	const Vector3& v1 = p20;
+	float d00 = v0.x * v0.x + v0.y * v0.y + v0.z * v0.z;
+	float d01 = v0.x * v1.x + v0.y * v1.y + v0.z * v1.z;
+	float d11 = v1.x * v1.x + v1.y * v1.y + v1.z * v1.z;
+	float denom = d00 * d11 - d01 * d01;
+	float denomr = denom == 0 ? 0.f : 1.f / denom;
+
+	// precompute gradient factors; these are obtained by differentiating eval(pos) = a0 * u + a1 * v + a2 * w
+	// and factoring out the terms that are shared between attributes
+	float gx1 = (d11 * v0.x - d01 * v1.x) * denomr;
+	float gx2 = (d00 * v1.x - d01 * v0.x) * denomr;
+	float gy1 = (d11 * v0.y - d01 * v1.y) * denomr;
+	float gy2 = (d00 * v1.y - d01 * v0.y) * denomr;
+	float gz1 = (d11 * v0.z - d01 * v1.z) * denomr;
+	float gz2 = (d00 * v1.z - d01 * v0.z) * denomr;
+
+	memset(&Q, 0, sizeof(Quadric));
+
+	Q.w = w;
+
+	for (size_t k = 0; k < attribute_count; ++k)
+	{
+		float a0 = va0[k], a1 = va1[k], a2 = va2[k];
+
+		// compute gradient of eval(pos) for x/y/z/w
+		float gx = gx1 * (a1 - a0) + gx2 * (a2 - a0);
+		float gy = gy1 * (a1 - a0) + gy2 * (a2 - a0);
+		float gz = gz1 * (a1 - a0) + gz2 * (a2 - a0);
+		float gw = a0 - p0.x * gx - p0.y * gy - p0.z * gz;
+
+		// quadric encodes (eval(pos) - attr)^2; the terms that only depend on pos can be accumulated in basic quadric fields
+		Q.a00 += w * (gx * gx);
+		Q.a11 += w * (gy * gy);
+		Q.a22 += w * (gz * gz);
+
+		Q.a10 += w * (gy * gx);
+		Q.a20 += w * (gz * gx);
+		Q.a21 += w * (gz * gy);
+
+		Q.b0 += w * (gx * gw);
+		Q.b1 += w * (gy * gw);
+		Q.b2 += w * (gz * gw);
+
+		Q.c += w * (gw * gw);
+
+		// the remaining terms depend on attr; these will be added during error evaluation, see quadricError
+		G[k].gx = w * gx;
+		G[k].gy = w * gy;
+		G[k].gz = w * gz;
+		G[k].gw = w * gw;
+	}
+}
+
 static void fillFaceQuadrics(Quadric* vertex_quadrics, const unsigned int* indices, size_t index_count, const Vector3* vertex_positions, const unsigned int* remap)
 {
 	for (size_t i = 0; i < index_count; i += 3)
@@ -626,6 +790,29 @@ static void fillEdgeQuadrics(Quadric* vertex_quadrics, const unsigned int* indic
 	}
 }
 
+static void fillAttributeQuadrics(Quadric* attribute_quadrics, QuadricGrad* attribute_gradients, const unsigned int* indices, size_t index_count, const Vector3* vertex_positions, const float* vertex_attributes, size_t attribute_count)
+{
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		unsigned int i0 = indices[i + 0];
+		unsigned int i1 = indices[i + 1];
+		unsigned int i2 = indices[i + 2];
+
+		Quadric QA;
+		QuadricGrad G[kMaxAttributes];
+		quadricFromAttributes(QA, G, vertex_positions[i0], vertex_positions[i1], vertex_positions[i2], &vertex_attributes[i0 * attribute_count], &vertex_attributes[i1 * attribute_count], &vertex_attributes[i2 * attribute_count], attribute_count);
+
+		// note: attribute quadrics are accumulated per vertex, not per position, since vertices on attribute seams have different attribute values
+		quadricAdd(attribute_quadrics[i0], QA);
+		quadricAdd(attribute_quadrics[i1], QA);
+		quadricAdd(attribute_quadrics[i2], QA);
+
+		quadricAdd(&attribute_gradients[i0 * attribute_count], G, attribute_count);
+		quadricAdd(&attribute_gradients[i1 * attribute_count], G, attribute_count);
+		quadricAdd(&attribute_gradients[i2 * attribute_count], G, attribute_count);
+	}
+}
+
 // does triangle ABC flip when C is replaced with D?
 static bool hasTriangleFlip(const Vector3& a, const Vector3& b, const Vector3& c, const Vector3& d)
 {
@@ -726,7 +913,24 @@ static size_t pickEdgeCollapses(Collapse* collapses, const unsigned int* indices
 	return collapse_count;
 }
 
-static void rankEdgeCollapses(Collapse* collapses, size_t collapse_count, const Vector3* vertex_positions, const Quadric* vertex_quadrics, const unsigned int* remap)
+static float getAttributeError(unsigned int i0, unsigned int i1, const Vector3* vertex_positions, const float* vertex_attributes, const Quadric* attribute_quadrics, const QuadricGrad* attribute_gradients, size_t attribute_count, const unsigned char* vertex_kind, const unsigned int* wedge)
+{
+	float error = quadricError(attribute_quadrics[i0], &attribute_gradients[i0 * attribute_count], attribute_count, vertex_positions[i1], &vertex_attributes[i1 * attribute_count]);
+
+	// seam collapses move both wedges of the source vertex, so the error of the secondary wedge needs to be included as well
+	// note: this is intentionally missing handling for Kind_Complex; we assume that complex vertices have similar attribute values
+	if (vertex_kind[i0] == Kind_Seam)
+	{
+		unsigned int s0 = wedge[i0];
+		unsigned int s1 = wedge[i1];
+
+		error += quadricError(attribute_quadrics[s0], &attribute_gradients[s0 * attribute_count], attribute_count, vertex_positions[s1], &vertex_attributes[s1 * attribute_count]);
+	}
+
+	return error;
+}
+
+static void rankEdgeCollapses(Collapse* collapses, size_t collapse_count, const Vector3* vertex_positions, const float* vertex_attributes, const Quadric* vertex_quadrics, const Quadric* attribute_quadrics, const QuadricGrad* attribute_gradients, size_t attribute_count, const unsigned int* remap, const unsigned char* vertex_kind, const unsigned int* wedge)
 {
 	for (size_t i = 0; i < collapse_count; ++i)
 	{
@@ -746,6 +950,12 @@ static void rankEdgeCollapses(Collapse* collapses, size_t collapse_count, const
 		float ei = quadricError(qi, vertex_positions[i1]);
 		float ej = quadricError(qj, vertex_positions[j1]);
 
+		if (attribute_count)
+		{
+			ei += getAttributeError(i0, i1, vertex_positions, vertex_attributes, attribute_quadrics, attribute_gradients, attribute_count, vertex_kind, wedge);
+			ej += getAttributeError(j0, j1, vertex_positions, vertex_attributes, attribute_quadrics, attribute_gradients, attribute_count, vertex_kind, wedge);
+		}
+
 		// pick edge direction with minimal error
 		c.v0 = ei <= ej ? i0 : j0;
 		c.v1 = ei <= ej ? i1 : j1;
@@ -846,7 +1056,61 @@ static void sortEdgeCollapses(unsigned int* sort_order, const Collapse* collapse
 	}
 }
 
-static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char* collapse_locked, Quadric* vertex_quadrics, const Collapse* collapses, size_t collapse_count, const unsigned int* collapse_order, const unsigned int* remap, const unsigned int* wedge, const unsigned char* vertex_kind, const Vector3* vertex_positions, const EdgeAdjacency& adjacency, size_t triangle_collapse_goal, float error_limit, float& result_error)
+// merges quadrics of i0 into i1 and remaps all vertices that move along with i0
+static void collapseEdge(unsigned int* collapse_remap, Quadric* vertex_quadrics, Quadric* attribute_quadrics, QuadricGrad* attribute_gradients, size_t attribute_count, const unsigned int* remap, const unsigned int* wedge, const unsigned char* vertex_kind, unsigned int i0, unsigned int i1)
+{
+	unsigned int r0 = remap[i0];
+	unsigned int r1 = remap[i1];
+
+	quadricAdd(vertex_quadrics[r1], vertex_quadrics[r0]);
+
+	if (attribute_count)
+	{
+		quadricAdd(attribute_quadrics[i1], attribute_quadrics[i0]);
+		quadricAdd(&attribute_gradients[i1 * attribute_count], &attribute_gradients[i0 * attribute_count], attribute_count);
+
+		// seam collapses involve two edges so we need to update attribute quadrics for both target vertices; position quadrics are shared
+		if (vertex_kind[i0] == Kind_Seam)
+		{
+			unsigned int s0 = wedge[i0];
+			unsigned int s1 = wedge[i1];
+
+			quadricAdd(attribute_quadrics[s1], attribute_quadrics[s0]);
+			quadricAdd(&attribute_gradients[s1 * attribute_count], &attribute_gradients[s0 * attribute_count], attribute_count);
+		}
+	}
+
+	if (vertex_kind[i0] == Kind_Complex)
+	{
+		unsigned int v = i0;
+
+		do
+		{
+			collapse_remap[v] = r1;
+			v = wedge[v];
+		} while (v != i0);
+	}
+	else if (vertex_kind[i0] == Kind_Seam)
+	{
+		// remap v0 to v1 and seam pair of v0 to seam pair of v1
+		unsigned int s0 = wedge[i0];
+		unsigned int s1 = wedge[i1];
+
+		assert(s0 != i0 && s1 != i1);
+		assert(wedge[s0] == i0 && wedge[s1] == i1);
+
+		collapse_remap[i0] = i1;
+		collapse_remap[s0] = s1;
+	}
+	else
+	{
+		assert(wedge[i0] == i0);
+
+		collapse_remap[i0] = i1;
+	}
+}
+
+static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char* collapse_locked, Quadric* vertex_quadrics, Quadric* attribute_quadrics, QuadricGrad* attribute_gradients, size_t attribute_count, const Collapse* collapses, size_t collapse_count, const unsigned int* collapse_order, const unsigned int* remap, const unsigned int* wedge, const unsigned char* vertex_kind, const Vector3* vertex_positions, const EdgeAdjacency& adjacency, size_t triangle_collapse_goal, float error_limit, float& result_error)
 {
 	size_t edge_collapses = 0;
 	size_t triangle_collapses = 0;
@@ -907,36 +1171,7 @@ static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char*
 		assert(collapse_remap[r0] == r0);
 		assert(collapse_remap[r1] == r1);
 
-		quadricAdd(vertex_quadrics[r1], vertex_quadrics[r0]);
-
-		if (vertex_kind[i0] == Kind_Complex)
-		{
-			unsigned int v = i0;
-
-			do
-			{
-				collapse_remap[v] = r1;
-				v = wedge[v];
-			} while (v != i0);
-		}
-		else if (vertex_kind[i0] == Kind_Seam)
-		{
-			// remap v0 to v1 and seam pair of v0 to seam pair of v1
-			unsigned int s0 = wedge[i0];
-			unsigned int s1 = wedge[i1];
-
-			assert(s0 != i0 && s1 != i1);
-			assert(wedge[s0] == i0 && wedge[s1] == i1);
-
-			collapse_remap[i0] = i1;
-			collapse_remap[s0] = s1;
-		}
-		else
-		{
-			assert(wedge[i0] == i0);
-
-			collapse_remap[i0] = i1;
-		}
+		collapseEdge(collapse_remap, vertex_quadrics, attribute_quadrics, attribute_gradients, attribute_count, remap, wedge, vertex_kind, i0, i1);
 
 		collapse_locked[r0] = 1;
 		collapse_locked[r1] = 1;
@@ -1255,31 +1490,200 @@ static float interpolate(float y, float x0, float y0, float x1, float y1, float
 	return x1 + num / den;
 }
 
-} // namespace meshopt
+// parallel sloppy simplification splits the input into fixed-size ranges so that the results don't depend on the number of threads
+const size_t kSimplifyJobTriangles = 4096;
+const size_t kSimplifyJobVertices = 16384;
 
-#ifndef NDEBUG
-unsigned char* meshopt_simplifyDebugKind = 0;
-unsigned int* meshopt_simplifyDebugLoop = 0;
-unsigned int* meshopt_simplifyDebugLoopBack = 0;
-#endif
+struct SloppyJobs
+{
+	Vector3* vertex_positions;
+	unsigned int* vertex_ids;
+	float* job_bounds;
+	size_t* job_counts;
+
+	const float* vertex_positions_data;
+	size_t vertex_positions_stride;
+	size_t vertex_count;
+	const unsigned int* indices;
+	size_t triangle_count;
 
-size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* out_result_error)
+	int grid_size;
+	float minv[3];
+	float scale;
+};
+
+static void getJobRange(size_t& begin, size_t& end, size_t job_index, size_t job_size, size_t count)
 {
-	using namespace meshopt;
+	begin = job_index * job_size;
+	end = begin + job_size < count ? begin + job_size : count;
+}
 
-	assert(index_count % 3 == 0);
-	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
-	assert(vertex_positions_stride % sizeof(float) == 0);
-	assert(target_index_count <= index_count);
+static void computeBoundsJob(void* job_data, size_t job_index)
+{
+	const SloppyJobs& jobs = *static_cast<const SloppyJobs*>(job_data);
 
-	meshopt_Allocator allocator;
+	size_t begin, end;
+	getJobRange(begin, end, job_index, kSimplifyJobVertices, jobs.vertex_count);
+
+	size_t vertex_stride_float = jobs.vertex_positions_stride / sizeof(float);
+
+	float* minv = &jobs.job_bounds[job_index * 6 + 0];
+	float* maxv = &jobs.job_bounds[job_index * 6 + 3];
+
+	minv[0] = minv[1] = minv[2] = FLT_MAX;
+	maxv[0] = maxv[1] = maxv[2] = -FLT_MAX;
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		const float* v = jobs.vertex_positions_data + i * vertex_stride_float;
+
+		jobs.vertex_positions[i].x = v[0];
+		jobs.vertex_positions[i].y = v[1];
+		jobs.vertex_positions[i].z = v[2];
+
+		for (int j = 0; j < 3; ++j)
+		{
+			float vj = v[j];
+
+			minv[j] = minv[j] > vj ? vj : minv[j];
+			maxv[j] = maxv[j] < vj ? vj : maxv[j];
+		}
+	}
+}
+
+static void normalizePositionsJob(void* job_data, size_t job_index)
+{
+	const SloppyJobs& jobs = *static_cast<const SloppyJobs*>(job_data);
+
+	size_t begin, end;
+	getJobRange(begin, end, job_index, kSimplifyJobVertices, jobs.vertex_count);
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		Vector3& v = jobs.vertex_positions[i];
+
+		v.x = (v.x - jobs.minv[0]) * jobs.scale;
+		v.y = (v.y - jobs.minv[1]) * jobs.scale;
+		v.z = (v.z - jobs.minv[2]) * jobs.scale;
+	}
+}
+
+static void computeVertexIdsJob(void* job_data, size_t job_index)
+{
+	const SloppyJobs& jobs = *static_cast<const SloppyJobs*>(job_data);
+
+	size_t begin, end;
+	getJobRange(begin, end, job_index, kSimplifyJobVertices, jobs.vertex_count);
+
+	computeVertexIds(jobs.vertex_ids + begin, jobs.vertex_positions + begin, end - begin, jobs.grid_size);
+}
+
+static void countTrianglesJob(void* job_data, size_t job_index)
+{
+	const SloppyJobs& jobs = *static_cast<const SloppyJobs*>(job_data);
+
+	size_t begin, end;
+	getJobRange(begin, end, job_index, kSimplifyJobTriangles, jobs.triangle_count);
+
+	jobs.job_counts[job_index] = countTriangles(jobs.vertex_ids, jobs.indices + begin * 3, (end - begin) * 3);
+}
+
+static void rescalePositionsParallel(SloppyJobs& jobs, meshopt_DispatchCallback dispatch, void* context)
+{
+	size_t job_count = (jobs.vertex_count + kSimplifyJobVertices - 1) / kSimplifyJobVertices;
+
+	dispatchJobs(dispatch, context, computeBoundsJob, &jobs, job_count);
+
+	float minv[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+	float maxv[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+	for (size_t i = 0; i < job_count; ++i)
+		for (int j = 0; j < 3; ++j)
+		{
+			minv[j] = minv[j] > jobs.job_bounds[i * 6 + j] ? jobs.job_bounds[i * 6 + j] : minv[j];
+			maxv[j] = maxv[j] < jobs.job_bounds[i * 6 + 3 + j] ? jobs.job_bounds[i * 6 + 3 + j] : maxv[j];
+		}
+
+	// same as rescalePositions; min/max don't depend on the order of reduction so the results are identical
+	float extent = 0.f;
+
+	extent = (maxv[0] - minv[0]) < extent ? extent : (maxv[0] - minv[0]);
+	extent = (maxv[1] - minv[1]) < extent ? extent : (maxv[1] - minv[1]);
+	extent = (maxv[2] - minv[2]) < extent ? extent : (maxv[2] - minv[2]);
+
+	jobs.minv[0] = minv[0];
+	jobs.minv[1] = minv[1];
+	jobs.minv[2] = minv[2];
+	jobs.scale = extent == 0 ? 0.f : 1.f / extent;
+
+	dispatchJobs(dispatch, context, normalizePositionsJob, &jobs, job_count);
+}
+
+static void computeVertexIdsParallel(SloppyJobs& jobs, int grid_size, meshopt_DispatchCallback dispatch, void* context)
+{
+	jobs.grid_size = grid_size;
+
+	dispatchJobs(dispatch, context, computeVertexIdsJob, &jobs, (jobs.vertex_count + kSimplifyJobVertices - 1) / kSimplifyJobVertices);
+}
+
+static size_t countTrianglesParallel(SloppyJobs& jobs, meshopt_DispatchCallback dispatch, void* context)
+{
+	size_t job_count = (jobs.triangle_count + kSimplifyJobTriangles - 1) / kSimplifyJobTriangles;
+
+	dispatchJobs(dispatch, context, countTrianglesJob, &jobs, job_count);
+
+	size_t result = 0;
+
+	for (size_t i = 0; i < job_count; ++i)
+		result += jobs.job_counts[i];
+
+	return result;
+}
+
+static size_t countGridTriangles(SloppyJobs& jobs, unsigned int* vertex_ids, const Vector3* vertex_positions, size_t vertex_count, const unsigned int* indices, size_t index_count, int grid_size, meshopt_DispatchCallback dispatch, void* context)
+{
+	if (dispatch)
+	{
+		computeVertexIdsParallel(jobs, grid_size, dispatch, context);
+		return countTrianglesParallel(jobs, dispatch, context);
+	}
+	else
+	{
+		computeVertexIds(vertex_ids, vertex_positions, vertex_count, grid_size);
+		return countTriangles(vertex_ids, indices, index_count);
+	}
+}
 
-	unsigned int* result = destination;
+struct SimplifierState
+{
+	EdgeAdjacency adjacency;
+
+	unsigned int* remap;
+	unsigned int* wedge;
+	unsigned char* vertex_kind;
+	unsigned int* loop;
+	unsigned int* loopback;
+
+	Vector3* vertex_positions;
+	Quadric* vertex_quadrics;
+
+	float* vertex_attributes;
+	Quadric* attribute_quadrics;
+	QuadricGrad* attribute_gradients;
+	size_t attribute_count;
+
+	Collapse* edge_collapses;
+	unsigned int* collapse_order;
+	unsigned int* collapse_remap;
+	unsigned char* collapse_locked;
+};
 
+// returns the position extent that errors are normalized by
+static float prepareSimplifier(SimplifierState& state, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, meshopt_Allocator& allocator)
+{
 	// build adjacency information
-	EdgeAdjacency adjacency = {};
-	prepareEdgeAdjacency(adjacency, index_count, vertex_count, allocator);
-	updateEdgeAdjacency(adjacency, indices, index_count, vertex_count, NULL);
+	prepareEdgeAdjacency(state.adjacency, index_count, vertex_count, allocator);
+	updateEdgeAdjacency(state.adjacency, indices, index_count, vertex_count, NULL);
 
 	// build position remap that maps each vertex to the one with identical position
 	unsigned int* remap = allocator.allocate<unsigned int>(vertex_count);
@@ -1290,7 +1694,7 @@ size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices,
 	unsigned char* vertex_kind = allocator.allocate<unsigned char>(vertex_count);
 	unsigned int* loop = allocator.allocate<unsigned int>(vertex_count);
 	unsigned int* loopback = allocator.allocate<unsigned int>(vertex_count);
-	classifyVertices(vertex_kind, loop, loopback, vertex_count, adjacency, remap, wedge);
+	classifyVertices(vertex_kind, loop, loopback, vertex_count, state.adjacency, remap, wedge, vertex_lock);
 
 #if TRACE
 	size_t unique_positions = 0;
@@ -1308,7 +1712,7 @@ size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices,
 #endif
 
 	Vector3* vertex_positions = allocator.allocate<Vector3>(vertex_count);
-	rescalePositions(vertex_positions, vertex_positions_data, vertex_count, vertex_positions_stride);
+	float vertex_scale = rescalePositions(vertex_positions, vertex_positions_data, vertex_count, vertex_positions_stride);
 
 	Quadric* vertex_quadrics = allocator.allocate<Quadric>(vertex_count);
 	memset(vertex_quadrics, 0, vertex_count * sizeof(Quadric));
@@ -1316,96 +1720,1394 @@ size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices,
 	fillFaceQuadrics(vertex_quadrics, indices, index_count, vertex_positions, remap);
 	fillEdgeQuadrics(vertex_quadrics, indices, index_count, vertex_positions, remap, vertex_kind, loop, loopback);
 
-	if (result != indices)
-		memcpy(result, indices, index_count * sizeof(unsigned int));
+	float* vertex_attributes = NULL;
+	Quadric* attribute_quadrics = NULL;
+	QuadricGrad* attribute_gradients = NULL;
+
+	if (attribute_count)
+	{
+		vertex_attributes = allocator.allocate<float>(vertex_count * attribute_count);
+		rescaleAttributes(vertex_attributes, vertex_attributes_data, vertex_count, vertex_attributes_stride, attribute_weights, attribute_count);
+
+		attribute_quadrics = allocator.allocate<Quadric>(vertex_count);
+		memset(attribute_quadrics, 0, vertex_count * sizeof(Quadric));
+
+		attribute_gradients = allocator.allocate<QuadricGrad>(vertex_count * attribute_count);
+		memset(attribute_gradients, 0, vertex_count * attribute_count * sizeof(QuadricGrad));
+
+		fillAttributeQuadrics(attribute_quadrics, attribute_gradients, indices, index_count, vertex_positions, vertex_attributes, attribute_count);
+	}
+
+	state.remap = remap;
+	state.wedge = wedge;
+	state.vertex_kind = vertex_kind;
+	state.loop = loop;
+	state.loopback = loopback;
+	state.vertex_positions = vertex_positions;
+	state.vertex_quadrics = vertex_quadrics;
+	state.vertex_attributes = vertex_attributes;
+	state.attribute_quadrics = attribute_quadrics;
+	state.attribute_gradients = attribute_gradients;
+	state.attribute_count = attribute_count;
+
+	return vertex_scale;
+}
+
+// scratch buffers for collapse passes (see simplifyLevels)
+static void prepareCollapsePasses(SimplifierState& state, size_t index_count, size_t vertex_count, meshopt_Allocator& allocator)
+{
+	state.edge_collapses = allocator.allocate<Collapse>(index_count);
+	state.collapse_order = allocator.allocate<unsigned int>(index_count);
+	state.collapse_remap = allocator.allocate<unsigned int>(vertex_count);
+	state.collapse_locked = allocator.allocate<unsigned char>(vertex_count);
+}
+
+// result initially contains index_count source indices; each requested level continues from the previous one
+static size_t simplifyLevels(SimplifierState& state, unsigned int* destination, size_t* lod_index_counts, unsigned int* result, size_t index_count, size_t vertex_count, const size_t* target_index_counts, const float* target_errors, size_t lod_count, float* out_result_errors)
+{
+	unsigned int* remap = state.remap;
+	unsigned int* wedge = state.wedge;
+	unsigned char* vertex_kind = state.vertex_kind;
+	unsigned int* loop = state.loop;
+	unsigned int* loopback = state.loopback;
+	const Vector3* vertex_positions = state.vertex_positions;
+	Quadric* vertex_quadrics = state.vertex_quadrics;
+	const float* vertex_attributes = state.vertex_attributes;
+	Quadric* attribute_quadrics = state.attribute_quadrics;
+	QuadricGrad* attribute_gradients = state.attribute_gradients;
+	size_t attribute_count = state.attribute_count;
+
+	Collapse* edge_collapses = state.edge_collapses;
+	unsigned int* collapse_order = state.collapse_order;
+	unsigned int* collapse_remap = state.collapse_remap;
+	unsigned char* collapse_locked = state.collapse_locked;
 
 #if TRACE
 	size_t pass_count = 0;
 #endif
 
-	Collapse* edge_collapses = allocator.allocate<Collapse>(index_count);
-	unsigned int* collapse_order = allocator.allocate<unsigned int>(index_count);
-	unsigned int* collapse_remap = allocator.allocate<unsigned int>(vertex_count);
-	unsigned char* collapse_locked = allocator.allocate<unsigned char>(vertex_count);
-
 	size_t result_count = index_count;
 	float result_error = 0;
+	size_t result_offset = 0;
 
-	// target_error input is linear; we need to adjust it to match quadricError units
-	float error_limit = target_error * target_error;
-
-	while (result_count > target_index_count)
+	for (size_t lod = 0; lod < lod_count; ++lod)
 	{
-		// note: throughout the simplification process adjacency structure reflects welded topology for result-in-progress
-		updateEdgeAdjacency(adjacency, result, result_count, vertex_count, remap);
+		size_t target_index_count = target_index_counts[lod];
 
-		size_t edge_collapse_count = pickEdgeCollapses(edge_collapses, result, result_count, remap, vertex_kind, loop);
+		// target_error input is linear; we need to adjust it to match quadricError units
+		float error_limit = target_errors[lod] * target_errors[lod];
 
-		// no edges can be collapsed any more due to topology restrictions
-		if (edge_collapse_count == 0)
-			break;
+		while (result_count > target_index_count)
+		{
+			// note: throughout the simplification process adjacency structure reflects welded topology for result-in-progress
+			updateEdgeAdjacency(state.adjacency, result, result_count, vertex_count, remap);
+
+			size_t edge_collapse_count = pickEdgeCollapses(edge_collapses, result, result_count, remap, vertex_kind, loop);
+
+			// no edges can be collapsed any more due to topology restrictions
+			if (edge_collapse_count == 0)
+				break;
 
-		rankEdgeCollapses(edge_collapses, edge_collapse_count, vertex_positions, vertex_quadrics, remap);
+			rankEdgeCollapses(edge_collapses, edge_collapse_count, vertex_positions, vertex_attributes, vertex_quadrics, attribute_quadrics, attribute_gradients, attribute_count, remap, vertex_kind, wedge);
 
 #if TRACE > 1
-		dumpEdgeCollapses(edge_collapses, edge_collapse_count, vertex_kind);
+			dumpEdgeCollapses(edge_collapses, edge_collapse_count, vertex_kind);
 #endif
 
-		sortEdgeCollapses(collapse_order, edge_collapses, edge_collapse_count);
+			sortEdgeCollapses(collapse_order, edge_collapses, edge_collapse_count);
 
-		size_t triangle_collapse_goal = (result_count - target_index_count) / 3;
+			size_t triangle_collapse_goal = (result_count - target_index_count) / 3;
 
-		for (size_t i = 0; i < vertex_count; ++i)
-			collapse_remap[i] = unsigned(i);
+			for (size_t i = 0; i < vertex_count; ++i)
+				collapse_remap[i] = unsigned(i);
 
-		memset(collapse_locked, 0, vertex_count);
+			memset(collapse_locked, 0, vertex_count);
 
 #if TRACE
-		printf("pass %d: ", int(pass_count++));
+			printf("pass %d: ", int(pass_count++));
 #endif
 
-		size_t collapses = performEdgeCollapses(collapse_remap, collapse_locked, vertex_quadrics, edge_collapses, edge_collapse_count, collapse_order, remap, wedge, vertex_kind, vertex_positions, adjacency, triangle_collapse_goal, error_limit, result_error);
+			size_t collapses = performEdgeCollapses(collapse_remap, collapse_locked, vertex_quadrics, attribute_quadrics, attribute_gradients, attribute_count, edge_collapses, edge_collapse_count, collapse_order, remap, wedge, vertex_kind, vertex_positions, state.adjacency, triangle_collapse_goal, error_limit, result_error);
 
-		// no edges can be collapsed any more due to hitting the error limit or triangle collapse limit
-		if (collapses == 0)
-			break;
+			// no edges can be collapsed any more due to hitting the error limit or triangle collapse limit
+			if (collapses == 0)
+				break;
 
-		remapEdgeLoops(loop, vertex_count, collapse_remap);
-		remapEdgeLoops(loopback, vertex_count, collapse_remap);
+			remapEdgeLoops(loop, vertex_count, collapse_remap);
+			remapEdgeLoops(loopback, vertex_count, collapse_remap);
 
-		size_t new_count = remapIndexBuffer(result, result_count, collapse_remap);
-		assert(new_count < result_count);
+			size_t new_count = remapIndexBuffer(result, result_count, collapse_remap);
+			assert(new_count < result_count);
 
-		result_count = new_count;
-	}
+			result_count = new_count;
+		}
 
 #if TRACE
-	printf("result: %d triangles, error: %e; total %d passes\n", int(result_count), sqrtf(result_error), int(pass_count));
+		printf("result: %d triangles, error: %e; total %d passes\n", int(result_count), sqrtf(result_error), int(pass_count));
 #endif
 
+		// each level continues from the state of the previous one, so levels are nested and reference a shared vertex set
+		if (lod_count > 1)
+			memcpy(destination + result_offset, result, result_count * sizeof(unsigned int));
+
+		if (lod_index_counts)
+			lod_index_counts[lod] = result_count;
+
+		// result_error is quadratic; we need to remap it back to linear
+		if (out_result_errors)
+			out_result_errors[lod] = sqrtf(result_error);
+
+		result_offset += result_count;
+	}
+
+	return result_offset;
+}
+
+// simplifies a mesh with tightly packed positions and locked vertices in place; errors are absolute (not normalized by mesh extents)
+static size_t simplifySubset(unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, float& result_error)
+{
+	meshopt_Allocator allocator;
+
+	SimplifierState state = {};
+	float vertex_scale = prepareSimplifier(state, indices, index_count, vertex_positions, vertex_count, sizeof(float) * 3, NULL, 0, NULL, 0, vertex_lock, allocator);
+	prepareCollapsePasses(state, index_count, vertex_count, allocator);
+
+	float error_limit = vertex_scale == 0 ? target_error : target_error / vertex_scale;
+	float error = 0;
+
+	size_t result = simplifyLevels(state, indices, NULL, indices, index_count, vertex_count, &target_index_count, &error_limit, 1, &error);
+
+	result_error = vertex_scale == 0 ? error : error * vertex_scale;
+
+	return result;
+}
+
+const int kOutOfCoreGridBits = 6;
+const int kOutOfCoreMaxRounds = 8;
+
+// marks positions that are used by more than one batch in position_owner; unused positions are marked with ~0u
+const unsigned int kOutOfCoreShared = ~0u - 1;
+
+struct OutOfCoreGrid
+{
+	float minv[3];
+	float scale;
+	float offset;
+	int bits;
+};
+
+static unsigned int getTriangleCell(const OutOfCoreGrid& grid, const unsigned int* triangle, const float* vertex_positions_data, size_t vertex_stride_float)
+{
+	const float* v0 = vertex_positions_data + triangle[0] * vertex_stride_float;
+	const float* v1 = vertex_positions_data + triangle[1] * vertex_stride_float;
+	const float* v2 = vertex_positions_data + triangle[2] * vertex_stride_float;
+
+	int cellmax = (1 << grid.bits) - 1;
+	unsigned int cell[3];
+
+	for (int k = 0; k < 3; ++k)
+	{
+		float c = (v0[k] + v1[k] + v2[k]) * (1.f / 3.f);
+		int q = int((c - grid.minv[k]) * grid.scale + grid.offset);
+
+		cell[k] = unsigned(q < 0 ? 0 : (q > cellmax ? cellmax : q));
+	}
+
+	// cells are enumerated in Morton order so that consecutive cell ranges are spatially compact
+	return part1By2(cell[0]) | (part1By2(cell[1]) << 1) | (part1By2(cell[2]) << 2);
+}
+
+static size_t getBatchMemory(size_t triangle_count)
+{
+	// upper bound for memory used by simplifyBatch, assuming that the batch has at most one vertex per triangle
+	// per triangle: local indices, local to global vertex map, index hash table (up to 2.5x entries with a local index each)
+	size_t triangle_memory = sizeof(unsigned int) * (3 + 3 + 3 * 5) + 3 * (sizeof(EdgeAdjacency::Edge) + sizeof(Collapse) + sizeof(unsigned int));
+	// per vertex: positions, lock, and simplifier state (see prepareSimplifier)
+	size_t vertex_memory = sizeof(float) * 3 + 1 + sizeof(unsigned int) * 9 + 2 + sizeof(Vector3) + sizeof(Quadric);
+
+	return triangle_count * (triangle_memory + vertex_memory);
+}
+
+// simplifies batch_count indices from batch, locking vertices with positions that are marked as shared by position_owner (if it's not NULL)
+// the result is written to destination, which may overlap the beginning of the batch; returns the number of written indices
+static size_t simplifyBatch(unsigned int* destination, const unsigned int* batch, size_t batch_count, const unsigned int* position_remap, const unsigned int* position_owner, const float* vertex_positions_data, size_t vertex_positions_stride, float vertex_scale, size_t target_index_count, float target_error, float& result_error)
+{
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+
+	meshopt_Allocator allocator;
+
+	unsigned int* batch_indices = allocator.allocate<unsigned int>(batch_count);
+	unsigned int* batch_vertices = allocator.allocate<unsigned int>(batch_count);
+
+	// maps global vertex index to the local one; local indices are stored after the table
+	size_t id_table_size = hashBuckets2(batch_count);
+	unsigned int* id_table = allocator.allocate<unsigned int>(id_table_size * 2);
+	memset(id_table, -1, id_table_size * sizeof(unsigned int));
+
+	IdHasher id_hasher;
+
+	size_t vertex_count = 0;
+
+	for (size_t i = 0; i < batch_count; ++i)
+	{
+		unsigned int* entry = hashLookup2(id_table, id_table_size, id_hasher, batch[i], ~0u);
+
+		if (*entry == ~0u)
+		{
+			*entry = batch[i];
+			entry[id_table_size] = unsigned(vertex_count);
+			batch_vertices[vertex_count++] = batch[i];
+		}
+
+		batch_indices[i] = entry[id_table_size];
+	}
+
+	float* positions = allocator.allocate<float>(vertex_count * 3);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+		memcpy(positions + i * 3, vertex_positions_data + batch_vertices[i] * vertex_stride_float, sizeof(float) * 3);
+
+	// lock vertices with positions shared with other batches so that the batch border stays intact
+	unsigned char* lock = allocator.allocate<unsigned char>(vertex_count);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+		lock[i] = position_owner && position_owner[position_remap[batch_vertices[i]]] == kOutOfCoreShared;
+
+	// errors are relative to the extents of the entire mesh so that the error limit is consistent across batches
+	float batch_error = 0;
+	size_t result_count = simplifySubset(batch_indices, batch_count, positions, vertex_count, lock, target_index_count, target_error * vertex_scale, batch_error);
+
+	batch_error = vertex_scale == 0 ? 0.f : batch_error / vertex_scale;
+	result_error = result_error < batch_error ? batch_error : result_error;
+
+	for (size_t i = 0; i < result_count; ++i)
+		destination[i] = batch_vertices[batch_indices[i]];
+
+	return result_count;
+}
+
+static void markPositionOwner(unsigned int* position_owner, const unsigned int* position_remap, const unsigned int* triangle, unsigned int batch)
+{
+	for (int k = 0; k < 3; ++k)
+	{
+		unsigned int& owner = position_owner[position_remap[triangle[k]]];
+
+		owner = (owner == ~0u || owner == batch) ? batch : kOutOfCoreShared;
+	}
+}
+
+const size_t kClusterLodGroupSize = 8;
+const float kClusterLodMinReduction = 0.85f;
+
+struct ClusterAdjacency
+{
+	// active clusters that reference each position
+	unsigned int* counts;
+	unsigned int* offsets;
+	unsigned int* data;
+};
+
+static void buildClusterAdjacency(ClusterAdjacency& adjacency, const unsigned int* active, size_t active_count, const meshopt_LodCluster* clusters, const unsigned int* cluster_vertices, const unsigned int* remap, size_t vertex_count)
+{
+	memset(adjacency.counts, 0, vertex_count * sizeof(unsigned int));
+
+	for (size_t i = 0; i < active_count; ++i)
+	{
+		const meshopt_LodCluster& cluster = clusters[active[i]];
+
+		for (size_t j = 0; j < cluster.vertex_count; ++j)
+			adjacency.counts[remap[cluster_vertices[cluster.vertex_offset + j]]]++;
+	}
+
+	unsigned int offset = 0;
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		adjacency.offsets[i] = offset;
+		offset += adjacency.counts[i];
+	}
+
+	for (size_t i = 0; i < active_count; ++i)
+	{
+		const meshopt_LodCluster& cluster = clusters[active[i]];
+
+		for (size_t j = 0; j < cluster.vertex_count; ++j)
+			adjacency.data[adjacency.offsets[remap[cluster_vertices[cluster.vertex_offset + j]]]++] = unsigned(i);
+	}
+
+	// fix offsets that have been disturbed by the previous pass
+	for (size_t i = 0; i < vertex_count; ++i)
+		adjacency.offsets[i] -= adjacency.counts[i];
+}
+
+// groups active clusters greedily; each group grows by the cluster that shares the most positions with it
+static size_t groupClusters(unsigned int* group_offsets, unsigned int* group_clusters, unsigned int* cluster_group, unsigned int* scores, unsigned int* touched, const unsigned int* active, size_t active_count, const meshopt_LodCluster* clusters, const unsigned int* cluster_vertices, const unsigned int* remap, const ClusterAdjacency& adjacency)
+{
+	memset(cluster_group, -1, active_count * sizeof(unsigned int));
+	memset(scores, 0, active_count * sizeof(unsigned int));
+
+	size_t group_count = 0;
+	size_t group_offset = 0;
+
+	for (size_t seed = 0; seed < active_count; ++seed)
+	{
+		if (cluster_group[seed] != ~0u)
+			continue;
+
+		size_t group_size = 0;
+		size_t touched_count = 0;
+		unsigned int next = unsigned(seed);
+
+		while (next != ~0u)
+		{
+			cluster_group[next] = unsigned(group_count);
+			group_clusters[group_offset + group_size++] = next;
+
+			if (group_size == kClusterLodGroupSize)
+				break;
+
+			// accumulate the number of shared positions for the neighbors of the new cluster
+			const meshopt_LodCluster& cluster = clusters[active[next]];
+
+			for (size_t i = 0; i < cluster.vertex_count; ++i)
+			{
+				unsigned int v = remap[cluster_vertices[cluster.vertex_offset + i]];
+				const unsigned int* neighbors = adjacency.data + adjacency.offsets[v];
+
+				for (size_t j = 0; j < adjacency.counts[v]; ++j)
+				{
+					unsigned int neighbor = neighbors[j];
+
+					if (cluster_group[neighbor] != ~0u)
+						continue;
+
+					if (scores[neighbor] == 0)
+						touched[touched_count++] = neighbor;
+
+					scores[neighbor]++;
+				}
+			}
+
+			next = ~0u;
+
+			for (size_t i = 0; i < touched_count; ++i)
+			{
+				unsigned int neighbor = touched[i];
+
+				if (cluster_group[neighbor] == ~0u && (next == ~0u || scores[neighbor] > scores[next]))
+					next = neighbor;
+			}
+		}
+
+		for (size_t i = 0; i < touched_count; ++i)
+			scores[touched[i]] = 0;
+
+		group_offsets[group_count++] = unsigned(group_offset);
+		group_offset += group_size;
+	}
+
+	group_offsets[group_count] = unsigned(group_offset);
+
+	return group_count;
+}
+
+// bounding sphere that contains the spheres of all clusters in the group; nesting spheres keeps projected errors monotonic
+static void mergeClusterSpheres(float center[3], float& radius, const meshopt_LodCluster* clusters, const unsigned int* active, const unsigned int* group, size_t group_size)
+{
+	center[0] = center[1] = center[2] = 0.f;
+	radius = 0.f;
+
+	for (size_t i = 0; i < group_size; ++i)
+		for (int k = 0; k < 3; ++k)
+			center[k] += clusters[active[group[i]]].center[k] / float(group_size);
+
+	for (size_t i = 0; i < group_size; ++i)
+	{
+		const meshopt_LodCluster& cluster = clusters[active[group[i]]];
+
+		float dx = cluster.center[0] - center[0], dy = cluster.center[1] - center[1], dz = cluster.center[2] - center[2];
+		float r = sqrtf(dx * dx + dy * dy + dz * dz) + cluster.radius;
+
+		radius = radius < r ? r : radius;
+	}
+}
+
+// copies meshlets to the output, remapping meshlet vertices through vertex_map (if not NULL)
+static size_t appendClusters(meshopt_LodCluster* clusters, unsigned int* cluster_vertices, unsigned char* cluster_triangles, size_t cluster_count, size_t& vertex_offset, size_t& triangle_offset, const meshopt_Meshlet* meshlets, const unsigned int* meshlet_vertices, const unsigned char* meshlet_triangles, size_t meshlet_count, const unsigned int* vertex_map)
+{
+	for (size_t i = 0; i < meshlet_count; ++i)
+	{
+		const meshopt_Meshlet& meshlet = meshlets[i];
+		meshopt_LodCluster& cluster = clusters[cluster_count + i];
+
+		memset(&cluster, 0, sizeof(cluster));
+
+		cluster.vertex_offset = unsigned(vertex_offset);
+		cluster.triangle_offset = unsigned(triangle_offset);
+		cluster.vertex_count = meshlet.vertex_count;
+		cluster.triangle_count = meshlet.triangle_count;
+		cluster.group = ~0u;
+		cluster.parent_group = ~0u;
+		cluster.parent_error = FLT_MAX;
+
+		for (size_t j = 0; j < meshlet.vertex_count; ++j)
+		{
+			unsigned int v = meshlet_vertices[meshlet.vertex_offset + j];
+			cluster_vertices[vertex_offset + j] = vertex_map ? vertex_map[v] : v;
+		}
+
+		// triangle data is 4b aligned and zero padded, same as meshopt_buildMeshlets
+		size_t triangle_size = (meshlet.triangle_count * 3 + 3) & ~3;
+		memcpy(cluster_triangles + triangle_offset, meshlet_triangles + meshlet.triangle_offset, triangle_size);
+
+		vertex_offset += meshlet.vertex_count;
+		triangle_offset += triangle_size;
+	}
+
+	return cluster_count + meshlet_count;
+}
+
+// Hausdorff distance is estimated with branch and bound: triangles are subdivided until the upper bound of the distance over each piece is within tolerance of the best lower bound
+const size_t kDistanceLeafSize = 4;
+const int kDistanceMaxDepth = 16;
+const float kDistanceTolerance = 1.f / 32;
+const float kDistanceMinTolerance = 1e-5f;
+
+struct DistanceNode
+{
+	float bmin[3];
+	float bmax[3];
+
+	// leaves: count = number of triangles starting from offset
+	// branches: count = 0, left subtree = skip 1, right subtree = offset
+	unsigned int offset;
+	unsigned int count;
+};
+
+static size_t distancePartition(unsigned int* order, size_t count, const Vector3* centroids, int axis, float pivot)
+{
+	size_t m = 0;
+
+	// invariant: elements in range [0, m) are < pivot, elements in range [m, i) are >= pivot
+	for (size_t i = 0; i < count; ++i)
+	{
+		float v = (&centroids[order[i]].x)[axis];
+
+		unsigned int t = order[m];
+		order[m] = order[i];
+		order[i] = t;
+
+		m += v < pivot;
+	}
+
+	return m;
+}
+
+static size_t distanceBuild(size_t offset, DistanceNode* nodes, const Vector3* corners, const Vector3* centroids, unsigned int* order, size_t first, size_t count)
+{
+	DistanceNode& node = nodes[offset];
+
+	float cmin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+	float cmax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+	for (int k = 0; k < 3; ++k)
+	{
+		node.bmin[k] = FLT_MAX;
+		node.bmax[k] = -FLT_MAX;
+	}
+
+	for (size_t i = first; i < first + count; ++i)
+	{
+		const Vector3* tri = &corners[order[i] * 3];
+
+		for (int j = 0; j < 3; ++j)
+			for (int k = 0; k < 3; ++k)
+			{
+				float v = (&tri[j].x)[k];
+
+				node.bmin[k] = node.bmin[k] > v ? v : node.bmin[k];
+				node.bmax[k] = node.bmax[k] < v ? v : node.bmax[k];
+			}
+
+		for (int k = 0; k < 3; ++k)
+		{
+			float v = (&centroids[order[i]].x)[k];
+
+			cmin[k] = cmin[k] > v ? v : cmin[k];
+			cmax[k] = cmax[k] < v ? v : cmax[k];
+		}
+	}
+
+	// split along the axis with the largest centroid extent
+	int axis = (cmax[0] - cmin[0] >= cmax[1] - cmin[1] && cmax[0] - cmin[0] >= cmax[2] - cmin[2]) ? 0 : (cmax[1] - cmin[1] >= cmax[2] - cmin[2]) ? 1 : 2;
+	size_t middle = count <= kDistanceLeafSize ? 0 : distancePartition(order + first, count, centroids, axis, (cmin[axis] + cmax[axis]) * 0.5f);
+
+	// when the partition is degenerate simply consolidate the triangles into a single leaf
+	if (middle == 0 || middle == count)
+	{
+		node.offset = unsigned(first);
+		node.count = unsigned(count);
+
+		return offset + 1;
+	}
+
+	size_t next_offset = distanceBuild(offset + 1, nodes, corners, centroids, order, first, middle);
+
+	node.offset = unsigned(next_offset);
+	node.count = 0;
+
+	return distanceBuild(next_offset, nodes, corners, centroids, order, first + middle, count - middle);
+}
+
+static float getBoxDistance2(const DistanceNode& node, const Vector3& p)
+{
+	float result = 0;
+
+	for (int k = 0; k < 3; ++k)
+	{
+		float v = (&p.x)[k];
+		float d = v < node.bmin[k] ? node.bmin[k] - v : v > node.bmax[k] ? v - node.bmax[k] : 0.f;
+
+		result += d * d;
+	}
+
+	return result;
+}
+
+static float getTriangleDistance2(const Vector3& p, const Vector3& a, const Vector3& b, const Vector3& c)
+{
+	// closest point on triangle, see "Real-Time Collision Detection" 5.1.5
+	Vector3 ab = {b.x - a.x, b.y - a.y, b.z - a.z};
+	Vector3 ac = {c.x - a.x, c.y - a.y, c.z - a.z};
+	Vector3 ap = {p.x - a.x, p.y - a.y, p.z - a.z};
+	Vector3 bp = {p.x - b.x, p.y - b.y, p.z - b.z};
+	Vector3 cp = {p.x - c.x, p.y - c.y, p.z - c.z};
+
+	float d1 = ab.x * ap.x + ab.y * ap.y + ab.z * ap.z;
+	float d2 = ac.x * ap.x + ac.y * ap.y + ac.z * ap.z;
+	float d3 = ab.x * bp.x + ab.y * bp.y + ab.z * bp.z;
+	float d4 = ac.x * bp.x + ac.y * bp.y + ac.z * bp.z;
+	float d5 = ab.x * cp.x + ab.y * cp.y + ab.z * cp.z;
+	float d6 = ac.x * cp.x + ac.y * cp.y + ac.z * cp.z;
+
+	float va = d3 * d6 - d5 * d4;
+	float vb = d5 * d2 - d1 * d6;
+	float vc = d1 * d4 - d3 * d2;
+
+	float v = 0, w = 0;
+
+	if (d1 <= 0 && d2 <= 0)
+		v = 0, w = 0;
+	else if (d3 >= 0 && d4 <= d3)
+		v = 1, w = 0;
+	else if (d6 >= 0 && d5 <= d6)
+		v = 0, w = 1;
+	else if (vc <= 0 && d1 >= 0 && d3 <= 0)
+		v = d1 - d3 > 0 ? d1 / (d1 - d3) : 0, w = 0;
+	else if (vb <= 0 && d2 >= 0 && d6 <= 0)
+		v = 0, w = d2 - d6 > 0 ? d2 / (d2 - d6) : 0;
+	else if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0)
+		w = (d4 - d3) + (d5 - d6) > 0 ? (d4 - d3) / ((d4 - d3) + (d5 - d6)) : 0, v = 1 - w;
+	else if (va + vb + vc > 0)
+		v = vb / (va + vb + vc), w = vc / (va + vb + vc);
+
+	Vector3 q = {a.x + ab.x * v + ac.x * w, a.y + ab.y * v + ac.y * w, a.z + ab.z * v + ac.z * w};
+
+	return (p.x - q.x) * (p.x - q.x) + (p.y - q.y) * (p.y - q.y) + (p.z - q.z) * (p.z - q.z);
+}
+
+static void distanceNearest(const DistanceNode* nodes, size_t root, const Vector3* triangles, const Vector3& p, float& limit2, unsigned int& result)
+{
+	const DistanceNode& node = nodes[root];
+
+	if (node.count)
+	{
+		for (size_t i = node.offset; i < node.offset + node.count; ++i)
+		{
+			float d2 = getTriangleDistance2(p, triangles[i * 3 + 0], triangles[i * 3 + 1], triangles[i * 3 + 2]);
+
+			if (d2 < limit2)
+			{
+				limit2 = d2;
+				result = unsigned(i);
+			}
+		}
+	}
+	else
+	{
+		// process the closer child first so that the other one is more likely to be culled
+		size_t first = root + 1, second = node.offset;
+		float first2 = getBoxDistance2(nodes[first], p), second2 = getBoxDistance2(nodes[second], p);
+
+		if (first2 > second2)
+		{
+			size_t t = first;
+			first = second, second = t;
+			float t2 = first2;
+			first2 = second2, second2 = t2;
+		}
+
+		if (first2 < limit2)
+			distanceNearest(nodes, first, triangles, p, limit2, result);
+
+		if (second2 < limit2)
+			distanceNearest(nodes, second, triangles, p, limit2, result);
+	}
+}
+
+struct DistanceSample
+{
+	Vector3 p;
+	float distance;
+	unsigned int nearest;
+};
+
+static float getDistance(const Vector3& a, const Vector3& b)
+{
+	return sqrtf((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z));
+}
+
+static float getNearestDistance(const DistanceNode* nodes, const Vector3* triangles, const Vector3& p, float limit, unsigned int& nearest)
+{
+	// limit is a known upper bound; when no closer triangle is found, nearest is kept as is and the bound is returned
+	float limit2 = limit * limit;
+
+	distanceNearest(nodes, 0, triangles, p, limit2, nearest);
+
+	return sqrtf(limit2);
+}
+
+static float getSampleBound(const DistanceSample* s, const Vector3* triangles, unsigned int candidate, float threshold)
+{
+	float result = FLT_MAX;
+
+	// distance to the surface is 1-Lipschitz, and the farthest point of the triangle from a corner is another corner
+	for (int i = 0; i < 3; ++i)
+	{
+		float e1 = getDistance(s[i].p, s[(i + 1) % 3].p);
+		float e2 = getDistance(s[i].p, s[(i + 2) % 3].p);
+		float bound = s[i].distance + (e1 > e2 ? e1 : e2);
+
+		result = result > bound ? bound : result;
+	}
+
+	// every point of the triangle is within circumradius of one of the corners
+	Vector3 e1 = {s[1].p.x - s[0].p.x, s[1].p.y - s[0].p.y, s[1].p.z - s[0].p.z};
+	Vector3 e2 = {s[2].p.x - s[0].p.x, s[2].p.y - s[0].p.y, s[2].p.z - s[0].p.z};
+	Vector3 n = {e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x};
+
+	float n2 = n.x * n.x + n.y * n.y + n.z * n.z;
+
+	if (n2 > 0)
+	{
+		float d01 = e1.x * e1.x + e1.y * e1.y + e1.z * e1.z;
+		float d02 = e2.x * e2.x + e2.y * e2.y + e2.z * e2.z;
+		float d12 = getDistance(s[1].p, s[2].p);
+
+		float radius = sqrtf(d01 * d02 / (4 * n2)) * d12;
+		float dmax = s[0].distance > s[1].distance ? s[0].distance : s[1].distance;
+		float bound = (dmax > s[2].distance ? dmax : s[2].distance) + radius;
+
+		result = result > bound ? bound : result;
+	}
+
+	// the caller only needs to know that the bound is below the threshold
+	if (result <= threshold)
+		return result;
+
+	// distance to a single triangle is convex, so its maximum over the triangle is reached at a corner
+	unsigned int candidates[4] = {s[0].nearest, s[1].nearest, s[2].nearest, candidate};
+
+	for (int i = 0; i < 4; ++i)
+	{
+		unsigned int t = candidates[i];
+
+		if (t == ~0u || (i > 0 && t == candidates[0]) || (i > 1 && t == candidates[1]) || (i > 2 && t == candidates[2]))
+			continue;
+
+		const Vector3* tri = &triangles[t * 3];
+		float bound = 0;
+
+		for (int j = 0; j < 3 && bound < result; ++j)
+		{
+			float d = sqrtf(getTriangleDistance2(s[j].p, tri[0], tri[1], tri[2]));
+			bound = bound < d ? d : bound;
+		}
+
+		result = result > bound ? bound : result;
+	}
+
+	return result;
+}
+
+static float sampleCentroids(unsigned int* candidates, const unsigned int* indices, size_t index_count, const DistanceSample* vertex_samples, const DistanceNode* nodes, const Vector3* triangles)
+{
+	float result = 0;
+
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		const DistanceSample& s0 = vertex_samples[indices[i + 0]];
+		const DistanceSample& s1 = vertex_samples[indices[i + 1]];
+		const DistanceSample& s2 = vertex_samples[indices[i + 2]];
+
+		Vector3 centroid = {(s0.p.x + s1.p.x + s2.p.x) / 3, (s0.p.y + s1.p.y + s2.p.y) / 3, (s0.p.z + s1.p.z + s2.p.z) / 3};
+
+		unsigned int candidate = s0.nearest;
+		float distance = getNearestDistance(nodes, triangles, centroid, s0.distance + getDistance(centroid, s0.p), candidate);
+
+		candidates[i / 3] = candidate;
+		result = result < distance ? distance : result;
+	}
+
+	return result;
+}
+
+static float measureDistance(const unsigned int* indices, size_t index_count, const DistanceSample* vertex_samples, const unsigned int* candidates, const DistanceNode* nodes, const Vector3* triangles, float lower)
+{
+	float upper = lower;
+
+	// depth-first subdivision needs to keep 3 siblings per level
+	DistanceSample stack[(kDistanceMaxDepth * 3 + 1) * 3];
+	int depths[kDistanceMaxDepth * 3 + 1];
+
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		stack[0] = vertex_samples[indices[i + 0]];
+		stack[1] = vertex_samples[indices[i + 1]];
+		stack[2] = vertex_samples[indices[i + 2]];
+		depths[0] = 0;
+
+		unsigned int candidate = candidates[i / 3];
+
+		size_t stack_size = 1;
+
+		while (stack_size)
+		{
+			stack_size--;
+
+			DistanceSample s[3] = {stack[stack_size * 3 + 0], stack[stack_size * 3 + 1], stack[stack_size * 3 + 2]};
+			int depth = depths[stack_size];
+
+			float tolerance = lower * kDistanceTolerance < kDistanceMinTolerance ? kDistanceMinTolerance : lower * kDistanceTolerance;
+			float bound = getSampleBound(s, triangles, depth == 0 ? candidate : ~0u, lower + tolerance);
+
+			if (bound <= lower + tolerance || depth == kDistanceMaxDepth)
+			{
+				upper = upper < bound ? bound : upper;
+				continue;
+			}
+
+			// split the triangle into 4 and sample the edge midpoints
+			DistanceSample m[3];
+
+			for (int k = 0; k < 3; ++k)
+			{
+				const DistanceSample& s0 = s[k];
+				const DistanceSample& s1 = s[(k + 1) % 3];
+
+				Vector3 p = {(s0.p.x + s1.p.x) * 0.5f, (s0.p.y + s1.p.y) * 0.5f, (s0.p.z + s1.p.z) * 0.5f};
+				float limit = (s0.distance < s1.distance ? s0.distance : s1.distance) + getDistance(s0.p, s1.p) * 0.5f;
+
+				m[k].p = p;
+				m[k].nearest = s0.distance < s1.distance ? s0.nearest : s1.nearest;
+				m[k].distance = getNearestDistance(nodes, triangles, p, limit, m[k].nearest);
+
+				lower = lower < m[k].distance ? m[k].distance : lower;
+			}
+
+			DistanceSample children[4][3] = {
+			    {s[0], m[0], m[2]},
+			    {m[0], s[1], m[1]},
+			    {m[2], m[1], s[2]},
+			    {m[0], m[1], m[2]},
+			};
+
+			for (int k = 0; k < 4; ++k)
+			{
+				assert(stack_size < kDistanceMaxDepth * 3 + 1);
+
+				stack[stack_size * 3 + 0] = children[k][0];
+				stack[stack_size * 3 + 1] = children[k][1];
+				stack[stack_size * 3 + 2] = children[k][2];
+				depths[stack_size] = depth + 1;
+				stack_size++;
+			}
+		}
+	}
+
+	return upper;
+}
+
+} // namespace meshopt
+
+#ifndef NDEBUG
+unsigned char* meshopt_simplifyDebugKind = 0;
+unsigned int* meshopt_simplifyDebugLoop = 0;
+unsigned int* meshopt_simplifyDebugLoopBack = 0;
+#endif
+
+static size_t simplifyEdge(unsigned int* destination, size_t* lod_index_counts, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, const size_t* target_index_counts, const float* target_errors, size_t lod_count, float* out_result_errors)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(attribute_count <= kMaxAttributes);
+	assert(lod_count > 0);
+
+	for (size_t lod = 0; lod < lod_count; ++lod)
+		assert(target_index_counts[lod] <= index_count);
+
+	meshopt_Allocator allocator;
+
+	// when multiple levels are requested, the result-in-progress is kept in a separate buffer and each level is copied to destination
+	unsigned int* result = lod_count > 1 ? allocator.allocate<unsigned int>(index_count) : destination;
+
+	SimplifierState state = {};
+	prepareSimplifier(state, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, vertex_attributes_data, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, allocator);
+	prepareCollapsePasses(state, index_count, vertex_count, allocator);
+
+	if (result != indices)
+		memcpy(result, indices, index_count * sizeof(unsigned int));
+
+	size_t result_offset = simplifyLevels(state, destination, lod_index_counts, result, index_count, vertex_count, target_index_counts, target_errors, lod_count, out_result_errors);
+
 #if TRACE > 1
-	dumpLockedCollapses(result, result_count, vertex_kind);
+	dumpLockedCollapses(result, lod_index_counts ? lod_index_counts[lod_count - 1] : result_offset, state.vertex_kind);
 #endif
 
-#ifndef NDEBUG
-	if (meshopt_simplifyDebugKind)
-		memcpy(meshopt_simplifyDebugKind, vertex_kind, vertex_count);
+#ifndef NDEBUG
+	if (meshopt_simplifyDebugKind)
+		memcpy(meshopt_simplifyDebugKind, state.vertex_kind, vertex_count);
+
+	if (meshopt_simplifyDebugLoop)
+		memcpy(meshopt_simplifyDebugLoop, state.loop, vertex_count * sizeof(unsigned int));
+
+	if (meshopt_simplifyDebugLoopBack)
+		memcpy(meshopt_simplifyDebugLoopBack, state.loopback, vertex_count * sizeof(unsigned int));
+#endif
+
+	return result_offset;
+}
+
+size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* out_result_error)
+{
+	return simplifyEdge(destination, NULL, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, NULL, 0, NULL, 0, NULL, &target_index_count, &target_error, 1, out_result_error);
+}
+
+size_t meshopt_simplifyWithAttributes(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, float* out_result_error)
+{
+	using namespace meshopt;
+
+	assert(vertex_attributes_stride >= attribute_count * sizeof(float) && vertex_attributes_stride <= 256);
+	assert(vertex_attributes_stride % sizeof(float) == 0);
+	assert(attribute_count <= kMaxAttributes);
+
+	return simplifyEdge(destination, NULL, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, vertex_attributes_data, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, &target_index_count, &target_error, 1, out_result_error);
+}
+
+size_t meshopt_simplifyLodChain(unsigned int* destination, size_t* lod_index_counts, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const size_t* target_index_counts, const float* target_errors, size_t lod_count, float* out_result_errors)
+{
+	return simplifyEdge(destination, lod_index_counts, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, NULL, 0, NULL, 0, NULL, target_index_counts, target_errors, lod_count, out_result_errors);
+}
+
+struct meshopt_SimplifierContext
+{
+	meshopt_Allocator allocator;
+	meshopt::SimplifierState state;
+
+	unsigned int* indices;
+	size_t index_count;
+	size_t vertex_count;
+
+	// initial contents of the state that collapse passes modify
+	unsigned int* loop;
+	unsigned int* loopback;
+	meshopt::Quadric* vertex_quadrics;
+};
+
+meshopt_SimplifierContext* meshopt_createSimplifierContext(const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+
+	meshopt_SimplifierContext* context = new (meshopt_Allocator::Storage::allocate(sizeof(meshopt_SimplifierContext))) meshopt_SimplifierContext();
+	meshopt_Allocator& allocator = context->allocator;
+
+	SimplifierState state = {};
+	prepareSimplifier(state, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, NULL, 0, NULL, 0, NULL, allocator);
+	prepareCollapsePasses(state, index_count, vertex_count, allocator);
+
+	context->state = state;
+	context->index_count = index_count;
+	context->vertex_count = vertex_count;
+
+	context->indices = allocator.allocate<unsigned int>(index_count);
+	memcpy(context->indices, indices, index_count * sizeof(unsigned int));
+
+	context->loop = allocator.allocate<unsigned int>(vertex_count);
+	memcpy(context->loop, state.loop, vertex_count * sizeof(unsigned int));
+
+	context->loopback = allocator.allocate<unsigned int>(vertex_count);
+	memcpy(context->loopback, state.loopback, vertex_count * sizeof(unsigned int));
+
+	context->vertex_quadrics = allocator.allocate<Quadric>(vertex_count);
+	memcpy(context->vertex_quadrics, state.vertex_quadrics, vertex_count * sizeof(Quadric));
+
+	return context;
+}
+
+size_t meshopt_simplifyWithContext(meshopt_SimplifierContext* context, unsigned int* destination, size_t target_index_count, float target_error, float* out_result_error)
+{
+	using namespace meshopt;
+
+	assert(context);
+	assert(target_index_count <= context->index_count);
+
+	SimplifierState& state = context->state;
+	size_t index_count = context->index_count;
+	size_t vertex_count = context->vertex_count;
+
+	// collapse passes merge quadrics and rewire edge loops, so each query starts from the initial copies
+	memcpy(state.loop, context->loop, vertex_count * sizeof(unsigned int));
+	memcpy(state.loopback, context->loopback, vertex_count * sizeof(unsigned int));
+	memcpy(state.vertex_quadrics, context->vertex_quadrics, vertex_count * sizeof(Quadric));
+
+	memcpy(destination, context->indices, index_count * sizeof(unsigned int));
+
+	return simplifyLevels(state, destination, NULL, destination, index_count, vertex_count, &target_index_count, &target_error, 1, out_result_error);
+}
+
+void meshopt_destroySimplifierContext(meshopt_SimplifierContext* context)
+{
+	if (!context)
+		return;
+
+	context->~meshopt_SimplifierContext();
+	meshopt_Allocator::Storage::deallocate(context);
+}
+
+size_t meshopt_simplifyOutOfCore(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* out_result_error, size_t memory_budget)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(target_index_count <= index_count);
+
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+
+	meshopt_Allocator allocator;
+
+	// errors are normalized by the extents of the entire mesh, same as meshopt_simplify
+	OutOfCoreGrid grid = {};
+	float maxv[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+	grid.minv[0] = grid.minv[1] = grid.minv[2] = FLT_MAX;
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		const float* v = vertex_positions_data + i * vertex_stride_float;
+
+		for (int j = 0; j < 3; ++j)
+		{
+			grid.minv[j] = grid.minv[j] > v[j] ? v[j] : grid.minv[j];
+			maxv[j] = maxv[j] < v[j] ? v[j] : maxv[j];
+		}
+	}
 
-	if (meshopt_simplifyDebugLoop)
-		memcpy(meshopt_simplifyDebugLoop, loop, vertex_count * sizeof(unsigned int));
+	float vertex_scale = 0.f;
 
-	if (meshopt_simplifyDebugLoopBack)
-		memcpy(meshopt_simplifyDebugLoopBack, loopback, vertex_count * sizeof(unsigned int));
-#endif
+	for (int j = 0; j < 3; ++j)
+		vertex_scale = (maxv[j] - grid.minv[j]) < vertex_scale ? vertex_scale : (maxv[j] - grid.minv[j]);
+
+	// pick the grid resolution so that the cell tables (histogram, batch offsets and batch cursors) only take a small fraction of the budget
+	grid.bits = kOutOfCoreGridBits;
+
+	while (grid.bits > 1 && (3 * sizeof(unsigned int) << (grid.bits * 3)) > memory_budget / 8)
+		grid.bits--;
+
+	unsigned int cell_count = 1u << (grid.bits * 3);
+
+	// cell_batch holds the triangle count of each cell until cells are grouped into batches, and the batch index afterwards
+	unsigned int* cell_batch = allocator.allocate<unsigned int>(cell_count);
+	unsigned int* batch_offsets = allocator.allocate<unsigned int>(cell_count + 1);
+	unsigned int* batch_next = allocator.allocate<unsigned int>(cell_count);
+
+	grid.scale = vertex_scale == 0 ? 0.f : float(1 << grid.bits) / vertex_scale;
+
+	// batch borders are found through positions, so that vertices on attribute seams are locked as well
+	unsigned int* position_remap = allocator.allocate<unsigned int>(vertex_count);
+	unsigned int* position_owner = allocator.allocate<unsigned int>(vertex_count);
+
+	size_t table_size = hashBuckets2(vertex_count);
+
+	{
+		meshopt_Allocator table_allocator;
+
+		PositionHasher hasher = {vertex_positions_data, vertex_stride_float};
+
+		unsigned int* table = table_allocator.allocate<unsigned int>(table_size);
+		memset(table, -1, table_size * sizeof(unsigned int));
+
+		for (size_t i = 0; i < vertex_count; ++i)
+		{
+			unsigned int* entry = hashLookup2(table, table_size, hasher, unsigned(i), ~0u);
+
+			if (*entry == ~0u)
+				*entry = unsigned(i);
+
+			position_remap[i] = *entry;
+		}
+	}
+
+	// the position table is freed before batches are processed, but it's counted so that the peak stays within the budget as well
+	size_t fixed_memory = (cell_count * 3 + 1) * sizeof(unsigned int) + (vertex_count * 2 + table_size) * sizeof(unsigned int);
+	size_t budget_triangles = memory_budget > fixed_memory ? (memory_budget - fixed_memory) / getBatchMemory(1) : 0;
+
+	// budgets below the fixed cost can't be honored; every grid cell then becomes a separate batch, which minimizes the memory used by batches
+	budget_triangles = budget_triangles == 0 ? 1 : budget_triangles;
+
+	if (destination != indices)
+		memcpy(destination, indices, index_count * sizeof(unsigned int));
+
+	size_t result_count = index_count;
+	float result_error = 0;
+
+	for (int round = 0;; ++round)
+	{
+		// once the remaining mesh fits into the budget, simplify it as a whole to reach the target and clean up batch borders
+		if (result_count / 3 <= budget_triangles)
+		{
+			result_count = simplifyBatch(destination, destination, result_count, position_remap, NULL, vertex_positions_data, vertex_positions_stride, vertex_scale, target_index_count, target_error, result_error);
+			break;
+		}
+
+		if (round == kOutOfCoreMaxRounds || result_count <= target_index_count)
+			break;
+
+		// shift the grid by half a cell on odd rounds so that the borders locked in the previous round can be simplified
+		grid.offset = (round & 1) ? 0.5f : 0.f;
+
+		memset(cell_batch, 0, cell_count * sizeof(unsigned int));
+
+		for (size_t i = 0; i < result_count; i += 3)
+			cell_batch[getTriangleCell(grid, destination + i, vertex_positions_data, vertex_stride_float)]++;
+
+		// group consecutive cells into batches that fit into the budget; cells that are larger than the budget are processed on their own
+		unsigned int batch_count = 0;
+		unsigned int batch_offset = 0;
+
+		for (unsigned int cell_begin = 0; cell_begin < cell_count;)
+		{
+			size_t batch_triangles = cell_batch[cell_begin];
+			unsigned int cell_end = cell_begin + 1;
+
+			while (cell_end < cell_count && batch_triangles + cell_batch[cell_end] <= budget_triangles)
+				batch_triangles += cell_batch[cell_end++];
+
+			for (unsigned int cell = cell_begin; cell < cell_end; ++cell)
+				cell_batch[cell] = batch_count;
+
+			batch_offsets[batch_count] = batch_offset;
+			batch_next[batch_count] = batch_offset;
+			batch_count++;
+
+			batch_offset += unsigned(batch_triangles);
+			cell_begin = cell_end;
+		}
+
+		batch_offsets[batch_count] = batch_offset;
+		assert(batch_offset * 3 == result_count);
+
+		// move triangles to their batches in place, in a single pass that also finds positions shared by several batches
+		memset(position_owner, -1, vertex_count * sizeof(unsigned int));
+
+		for (unsigned int batch = 0; batch < batch_count; ++batch)
+		{
+			while (batch_next[batch] < batch_offsets[batch + 1])
+			{
+				unsigned int* triangle = destination + batch_next[batch] * 3;
+				unsigned int target = cell_batch[getTriangleCell(grid, triangle, vertex_positions_data, vertex_stride_float)];
+
+				// triangles that are swapped into the current slot are classified on the next iteration
+				if (target != batch)
+				{
+					unsigned int* slot = destination + batch_next[target]++ * 3;
+
+					for (int k = 0; k < 3; ++k)
+					{
+						unsigned int t = slot[k];
+						slot[k] = triangle[k];
+						triangle[k] = t;
+					}
+
+					triangle = slot;
+				}
+				else
+				{
+					batch_next[batch]++;
+				}
+
+				markPositionOwner(position_owner, position_remap, triangle, target);
+			}
+		}
+
+		// intermediate rounds only need to reduce the mesh enough for it to fit into the budget; the rest of the reduction is done on the whole mesh which gives better quality
+		double round_ratio = double(budget_triangles) / double(result_count / 3) * 0.5;
+		round_ratio = round_ratio < double(target_index_count) / double(result_count) ? double(target_index_count) / double(result_count) : round_ratio;
+
+		// batches are simplified in order and compacted along the way; results never overtake the batch that is being read
+		size_t write = 0;
+
+		for (unsigned int batch = 0; batch < batch_count; ++batch)
+		{
+			size_t batch_triangles = batch_offsets[batch + 1] - batch_offsets[batch];
+
+			if (batch_triangles)
+			{
+				size_t batch_target = size_t(double(batch_triangles) * round_ratio) * 3;
+
+				write += simplifyBatch(destination + write, destination + batch_offsets[batch] * 3, batch_triangles * 3, position_remap, position_owner, vertex_positions_data, vertex_positions_stride, vertex_scale, batch_target, target_error, result_error);
+			}
+		}
+
+		bool progress = write < result_count;
+
+		result_count = write;
+
+		if (!progress)
+			break;
+	}
 
-	// result_error is quadratic; we need to remap it back to linear
 	if (out_result_error)
-		*out_result_error = sqrtf(result_error);
+		*out_result_error = result_error;
 
 	return result_count;
 }
 
-size_t meshopt_simplifySloppy(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* out_result_error)
+size_t meshopt_buildClusterLodBound(size_t index_count, size_t max_vertices, size_t max_triangles)
+{
+	// each level has about half of the triangles of the previous one; extra space covers partially filled clusters that each group produces
+	size_t result = 0;
+
+	for (size_t count = index_count / 3; count > 0; count /= 2)
+		result += meshopt_buildMeshletsBound(count * 3, max_vertices, max_triangles);
+
+	return result + result / 4;
+}
+
+size_t meshopt_buildClusterLod(meshopt_LodCluster* clusters, unsigned int* cluster_vertices, unsigned char* cluster_triangles, size_t cluster_capacity, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(max_triangles % 4 == 0);
+
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+
+	meshopt_Allocator allocator;
+
+	// vertices with identical positions are treated as one when grouping clusters and locking group borders
+	unsigned int* remap = allocator.allocate<unsigned int>(vertex_count);
+	unsigned int* wedge = allocator.allocate<unsigned int>(vertex_count);
+	buildPositionRemap(remap, wedge, vertex_positions_data, vertex_count, vertex_positions_stride, allocator);
+
+	// scratch meshlet storage, used for the source mesh and then reused for each simplified group
+	size_t group_max_indices = kClusterLodGroupSize * max_triangles * 3;
+	size_t group_max_vertices = kClusterLodGroupSize * max_vertices;
+	size_t scratch_count = meshopt_buildMeshletsBound(index_count > group_max_indices ? index_count : group_max_indices, max_vertices, max_triangles);
+
+	meshopt_Meshlet* meshlets = allocator.allocate<meshopt_Meshlet>(scratch_count);
+	unsigned int* meshlet_vertices = allocator.allocate<unsigned int>(scratch_count * max_vertices);
+	unsigned char* meshlet_triangles = allocator.allocate<unsigned char>(scratch_count * max_triangles * 3);
+
+	size_t meshlet_count = meshopt_buildMeshlets(meshlets, meshlet_vertices, meshlet_triangles, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, max_vertices, max_triangles, 0.f);
+	assert(meshlet_count <= cluster_capacity);
+
+	size_t vertex_offset = 0;
+	size_t triangle_offset = 0;
+	size_t cluster_count = appendClusters(clusters, cluster_vertices, cluster_triangles, 0, vertex_offset, triangle_offset, meshlets, meshlet_vertices, meshlet_triangles, meshlet_count, NULL);
+
+	for (size_t i = 0; i < cluster_count; ++i)
+	{
+		meshopt_LodCluster& cluster = clusters[i];
+		meshopt_Bounds bounds = meshopt_computeMeshletBounds(&cluster_vertices[cluster.vertex_offset], &cluster_triangles[cluster.triangle_offset], cluster.triangle_count, vertex_positions_data, vertex_count, vertex_positions_stride);
+
+		memcpy(cluster.center, bounds.center, sizeof(float) * 3);
+		cluster.radius = bounds.radius;
+		memcpy(cluster.parent_center, bounds.center, sizeof(float) * 3);
+		cluster.parent_radius = bounds.radius;
+	}
+
+	// active clusters form the current cut of the DAG: clusters that haven't been simplified yet
+	unsigned int* active = allocator.allocate<unsigned int>(cluster_capacity);
+	unsigned int* next_active = allocator.allocate<unsigned int>(cluster_capacity);
+	size_t active_count = cluster_count;
+
+	for (size_t i = 0; i < active_count; ++i)
+		active[i] = unsigned(i);
+
+	ClusterAdjacency adjacency = {};
+	adjacency.counts = allocator.allocate<unsigned int>(vertex_count);
+	adjacency.offsets = allocator.allocate<unsigned int>(vertex_count);
+	adjacency.data = allocator.allocate<unsigned int>(cluster_capacity * max_vertices);
+
+	unsigned int* group_offsets = allocator.allocate<unsigned int>(cluster_capacity + 1);
+	unsigned int* group_clusters = allocator.allocate<unsigned int>(cluster_capacity);
+	unsigned int* cluster_group = allocator.allocate<unsigned int>(cluster_capacity);
+	unsigned int* scores = allocator.allocate<unsigned int>(cluster_capacity);
+	unsigned int* touched = allocator.allocate<unsigned int>(cluster_capacity);
+
+	// each group is simplified as a separate mesh with compact vertex indices; id_table maps source vertices to group vertices, which are stored after the table
+	unsigned int* group_indices = allocator.allocate<unsigned int>(group_max_indices);
+	unsigned int* group_vertices = allocator.allocate<unsigned int>(group_max_vertices);
+	float* group_positions = allocator.allocate<float>(group_max_vertices * 3);
+	unsigned char* group_lock = allocator.allocate<unsigned char>(group_max_vertices);
+
+	size_t id_table_size = hashBuckets2(group_max_vertices);
+	unsigned int* id_table = allocator.allocate<unsigned int>(id_table_size * 2);
+
+	IdHasher id_hasher;
+	unsigned int group_id = 0;
+
+	while (active_count > 1)
+	{
+		buildClusterAdjacency(adjacency, active, active_count, clusters, cluster_vertices, remap, vertex_count);
+
+		size_t group_count = groupClusters(group_offsets, group_clusters, cluster_group, scores, touched, active, active_count, clusters, cluster_vertices, remap, adjacency);
+		size_t next_count = 0;
+		bool progress = false;
+
+		for (size_t g = 0; g < group_count; ++g)
+		{
+			const unsigned int* group = group_clusters + group_offsets[g];
+			size_t group_size = group_offsets[g + 1] - group_offsets[g];
+
+			memset(id_table, -1, id_table_size * sizeof(unsigned int));
+
+			size_t group_index_count = 0;
+			size_t group_vertex_count = 0;
+
+			for (size_t i = 0; i < group_size; ++i)
+			{
+				const meshopt_LodCluster& cluster = clusters[active[group[i]]];
+
+				for (size_t j = 0; j < cluster.triangle_count * 3; ++j)
+				{
+					unsigned int v = cluster_vertices[cluster.vertex_offset + cluster_triangles[cluster.triangle_offset + j]];
+					unsigned int* entry = hashLookup2(id_table, id_table_size, id_hasher, v, ~0u);
+
+					if (*entry == ~0u)
+					{
+						*entry = v;
+						entry[id_table_size] = unsigned(group_vertex_count);
+						group_vertices[group_vertex_count++] = v;
+					}
+
+					group_indices[group_index_count++] = entry[id_table_size];
+				}
+			}
+
+			// lock positions shared with other active clusters so that the group border matches its neighbors
+			for (size_t i = 0; i < group_vertex_count; ++i)
+			{
+				unsigned int v = remap[group_vertices[i]];
+				const unsigned int* neighbors = adjacency.data + adjacency.offsets[v];
+
+				group_lock[i] = 0;
+
+				for (size_t j = 0; j < adjacency.counts[v]; ++j)
+					if (cluster_group[neighbors[j]] != g)
+						group_lock[i] = 1;
+
+				memcpy(group_positions + i * 3, vertex_positions_data + group_vertices[i] * vertex_stride_float, sizeof(float) * 3);
+			}
+
+			// simplify to half of the triangles without an error limit; the resulting error is recorded in the clusters instead
+			float group_error = 0;
+			size_t result_count = simplifySubset(group_indices, group_index_count, group_positions, group_vertex_count, group_lock, group_index_count / 6 * 3, FLT_MAX, group_error);
+
+			size_t group_meshlet_count = 0;
+
+			if (result_count > 0 && float(result_count) <= float(group_index_count) * kClusterLodMinReduction)
+				group_meshlet_count = meshopt_buildMeshlets(meshlets, meshlet_vertices, meshlet_triangles, group_indices, result_count, group_positions, group_vertex_count, sizeof(float) * 3, max_vertices, max_triangles, 0.f);
+
+			// groups that can't be simplified enough, or don't fit into the output, stay active and can be regrouped on the next level
+			if (group_meshlet_count == 0 || cluster_count + group_meshlet_count > cluster_capacity)
+			{
+				for (size_t i = 0; i < group_size; ++i)
+					next_active[next_count++] = active[group[i]];
+
+				continue;
+			}
+
+			float center[3], radius;
+			mergeClusterSpheres(center, radius, clusters, active, group, group_size);
+
+			// group error includes the error of its clusters so that the error never decreases with coarser levels
+			unsigned int level = 0;
+
+			for (size_t i = 0; i < group_size; ++i)
+			{
+				const meshopt_LodCluster& cluster = clusters[active[group[i]]];
+
+				group_error = group_error < cluster.error ? cluster.error : group_error;
+				level = level < cluster.level + 1 ? cluster.level + 1 : level;
+			}
+
+			for (size_t i = 0; i < group_size; ++i)
+			{
+				meshopt_LodCluster& cluster = clusters[active[group[i]]];
+
+				memcpy(cluster.parent_center, center, sizeof(float) * 3);
+				cluster.parent_radius = radius;
+				cluster.parent_error = group_error;
+				cluster.parent_group = group_id;
+			}
+
+			size_t group_begin = cluster_count;
+			cluster_count = appendClusters(clusters, cluster_vertices, cluster_triangles, cluster_count, vertex_offset, triangle_offset, meshlets, meshlet_vertices, meshlet_triangles, group_meshlet_count, group_vertices);
+
+			for (size_t i = group_begin; i < cluster_count; ++i)
+			{
+				meshopt_LodCluster& cluster = clusters[i];
+
+				cluster.level = level;
+				cluster.group = group_id;
+				memcpy(cluster.center, center, sizeof(float) * 3);
+				cluster.radius = radius;
+				cluster.error = group_error;
+				memcpy(cluster.parent_center, center, sizeof(float) * 3);
+				cluster.parent_radius = radius;
+
+				next_active[next_count++] = unsigned(i);
+			}
+
+			group_id++;
+			progress = true;
+		}
+
+		if (!progress)
+			break;
+
+		unsigned int* temp = active;
+		active = next_active;
+		next_active = temp;
+		active_count = next_count;
+	}
+
+	return cluster_count;
+}
+
+static size_t simplifySloppy(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* out_result_error, meshopt_DispatchCallback dispatch, void* context)
 {
 	using namespace meshopt;
 
@@ -1420,7 +3122,31 @@ size_t meshopt_simplifySloppy(unsigned int* destination, const unsigned int* ind
 	meshopt_Allocator allocator;
 
 	Vector3* vertex_positions = allocator.allocate<Vector3>(vertex_count);
-	rescalePositions(vertex_positions, vertex_positions_data, vertex_count, vertex_positions_stride);
+	unsigned int* vertex_ids = allocator.allocate<unsigned int>(vertex_count);
+
+	SloppyJobs jobs = {};
+
+	if (dispatch)
+	{
+		size_t vertex_jobs = (vertex_count + kSimplifyJobVertices - 1) / kSimplifyJobVertices;
+		size_t triangle_jobs = (index_count / 3 + kSimplifyJobTriangles - 1) / kSimplifyJobTriangles;
+
+		jobs.vertex_positions = vertex_positions;
+		jobs.vertex_ids = vertex_ids;
+		jobs.job_bounds = allocator.allocate<float>(vertex_jobs * 6);
+		jobs.job_counts = allocator.allocate<size_t>(triangle_jobs);
+		jobs.vertex_positions_data = vertex_positions_data;
+		jobs.vertex_positions_stride = vertex_positions_stride;
+		jobs.vertex_count = vertex_count;
+		jobs.indices = indices;
+		jobs.triangle_count = index_count / 3;
+
+		rescalePositionsParallel(jobs, dispatch, context);
+	}
+	else
+	{
+		rescalePositions(vertex_positions, vertex_positions_data, vertex_count, vertex_positions_stride);
+	}
 
 	// find the optimal grid size using guided binary search
 #if TRACE
@@ -1428,8 +3154,6 @@ size_t meshopt_simplifySloppy(unsigned int* destination, const unsigned int* ind
 	printf("target: %d cells, %d triangles\n", int(target_cell_count), int(target_index_count / 3));
 #endif
 
-	unsigned int* vertex_ids = allocator.allocate<unsigned int>(vertex_count);
-
 	const int kInterpolationPasses = 5;
 
 	// invariant: # of triangles in min_grid <= target_count
@@ -1440,10 +3164,7 @@ size_t meshopt_simplifySloppy(unsigned int* destination, const unsigned int* ind
 
 	// when we're error-limited, we compute the triangle count for the min. size; this accelerates convergence and provides the correct answer when we can't use a larger grid
 	if (min_grid > 1)
-	{
-		computeVertexIds(vertex_ids, vertex_positions, vertex_count, min_grid);
-		min_triangles = countTriangles(vertex_ids, indices, index_count);
-	}
+		min_triangles = countGridTriangles(jobs, vertex_ids, vertex_positions, vertex_count, indices, index_count, min_grid, dispatch, context);
 
 	// instead of starting in the middle, let's guess as to what the answer might be! triangle count usually grows as a square of grid size...
 	int next_grid_size = int(sqrtf(float(target_cell_count)) + 0.5f);
@@ -1457,8 +3178,7 @@ size_t meshopt_simplifySloppy(unsigned int* destination, const unsigned int* ind
 		int grid_size = next_grid_size;
 		grid_size = (grid_size <= min_grid) ? min_grid + 1 : (grid_size >= max_grid) ? max_grid - 1 : grid_size;
 
-		computeVertexIds(vertex_ids, vertex_positions, vertex_count, grid_size);
-		size_t triangles = countTriangles(vertex_ids, indices, index_count);
+		size_t triangles = countGridTriangles(jobs, vertex_ids, vertex_positions, vertex_count, indices, index_count, grid_size, dispatch, context);
 
 #if TRACE
 		printf("pass %d (%s): grid size %d, triangles %d, %s\n",
@@ -1499,7 +3219,11 @@ size_t meshopt_simplifySloppy(unsigned int* destination, const unsigned int* ind
 
 	unsigned int* vertex_cells = allocator.allocate<unsigned int>(vertex_count);
 
-	computeVertexIds(vertex_ids, vertex_positions, vertex_count, min_grid);
+	if (dispatch)
+		computeVertexIdsParallel(jobs, min_grid, dispatch, context);
+	else
+		computeVertexIds(vertex_ids, vertex_positions, vertex_count, min_grid);
+
 	size_t cell_count = fillVertexCells(table, table_size, vertex_cells, vertex_ids, vertex_count);
 
 	// build a quadric for each target cell
@@ -1537,6 +3261,16 @@ size_t meshopt_simplifySloppy(unsigned int* destination, const unsigned int* ind
 	return write;
 }
 
+size_t meshopt_simplifySloppy(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* out_result_error)
+{
+	return simplifySloppy(destination, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, target_index_count, target_error, out_result_error, NULL, NULL);
+}
+
+size_t meshopt_simplifySloppyParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* out_result_error, meshopt_DispatchCallback dispatch, void* context)
+{
+	return simplifySloppy(destination, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, target_index_count, target_error, out_result_error, dispatch, context);
+}
+
 size_t meshopt_simplifyPoints(unsigned int* destination, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_vertex_count)
 {
 	using namespace meshopt;
@@ -1660,3 +3394,110 @@ float meshopt_simplifyScale(const float* vertex_positions, size_t vertex_count,
 
 	return extent;
 }
+
+float meshopt_computeHausdorffDistance(const unsigned int* indices, size_t index_count, const unsigned int* target_indices, size_t target_index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(target_index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+
+	if (index_count == 0)
+		return 0.f;
+
+	if (target_index_count == 0)
+		return FLT_MAX;
+
+	meshopt_Allocator allocator;
+
+	// distances are measured in the same normalized space as the simplifier error
+	Vector3* vertex_positions = allocator.allocate<Vector3>(vertex_count);
+	rescalePositions(vertex_positions, vertex_positions_data, vertex_count, vertex_positions_stride);
+
+	size_t target_count = target_index_count / 3;
+
+	// build a bounding volume hierarchy over the target triangles
+	Vector3* corners = allocator.allocate<Vector3>(target_index_count);
+	Vector3* centroids = allocator.allocate<Vector3>(target_count);
+	unsigned int* order = allocator.allocate<unsigned int>(target_count);
+
+	for (size_t i = 0; i < target_count; ++i)
+	{
+		Vector3 a = vertex_positions[target_indices[i * 3 + 0]];
+		Vector3 b = vertex_positions[target_indices[i * 3 + 1]];
+		Vector3 c = vertex_positions[target_indices[i * 3 + 2]];
+
+		// getTriangleDistance2 handles degenerate triangles correctly as long as the first edge isn't collapsed
+		if (a.x == b.x && a.y == b.y && a.z == b.z)
+		{
+			Vector3 t = a;
+			a = b, b = c, c = t;
+		}
+
+		corners[i * 3 + 0] = a;
+		corners[i * 3 + 1] = b;
+		corners[i * 3 + 2] = c;
+
+		centroids[i].x = (a.x + b.x + c.x) / 3;
+		centroids[i].y = (a.y + b.y + c.y) / 3;
+		centroids[i].z = (a.z + b.z + c.z) / 3;
+
+		order[i] = unsigned(i);
+	}
+
+	DistanceNode* nodes = allocator.allocate<DistanceNode>(target_count * 2);
+	distanceBuild(0, nodes, corners, centroids, order, 0, target_count);
+
+	// store triangles in leaf order to improve locality of queries
+	Vector3* triangles = allocator.allocate<Vector3>(target_index_count);
+	unsigned int* triangle_slots = allocator.allocate<unsigned int>(target_count);
+
+	for (size_t i = 0; i < target_count; ++i)
+	{
+		triangles[i * 3 + 0] = corners[order[i] * 3 + 0];
+		triangles[i * 3 + 1] = corners[order[i] * 3 + 1];
+		triangles[i * 3 + 2] = corners[order[i] * 3 + 2];
+
+		triangle_slots[order[i]] = unsigned(i);
+	}
+
+	// vertices of target triangles are on the target surface; other vertices need a query
+	DistanceSample* vertex_samples = allocator.allocate<DistanceSample>(vertex_count);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		vertex_samples[i].p = vertex_positions[i];
+		vertex_samples[i].distance = -1.f;
+		vertex_samples[i].nearest = ~0u;
+	}
+
+	for (size_t i = 0; i < target_index_count; ++i)
+	{
+		vertex_samples[target_indices[i]].distance = 0.f;
+		vertex_samples[target_indices[i]].nearest = triangle_slots[i / 3];
+	}
+
+	float lower = 0.f;
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		DistanceSample& s = vertex_samples[indices[i]];
+
+		if (s.distance < 0)
+		{
+			s.distance = getNearestDistance(nodes, triangles, s.p, FLT_MAX, s.nearest);
+			lower = lower < s.distance ? s.distance : lower;
+		}
+	}
+
+	// the triangle nearest to the centroid is a good candidate for the entire triangle, and an exact match when the triangle is in the target mesh
+	// sampling all centroids before subdivision also gives a lower bound that is close to the final distance, which limits subdivision depth
+	unsigned int* candidates = allocator.allocate<unsigned int>(index_count / 3);
+
+	float centroid_lower = sampleCentroids(candidates, indices, index_count, vertex_samples, nodes, triangles);
+	lower = lower < centroid_lower ? centroid_lower : lower;
+
+	return measureDistance(indices, index_count, vertex_samples, candidates, nodes, triangles, lower);
+}
@@ -4,59 +4,10 @@
 #include <assert.h>
 #include <string.h>
 
-// The block below auto-detects SIMD ISA that can be used on the target platform
-#ifndef MESHOPTIMIZER_NO_SIMD
+#include "internal.h"
+#include "simd.h"
 
-// The SIMD implementation requires SSSE3, which can be enabled unconditionally through compiler settings
-#if defined(__AVX__) || defined(__SSSE3__)
-#define SIMD_SSE
-#endif
-
-// An experimental implementation using AVX512 instructions; it's only enabled when AVX512 is enabled through compiler settings
-#if defined(__AVX512VBMI2__) && defined(__AVX512VBMI__) && defined(__AVX512VL__) && defined(__POPCNT__)
-#undef SIMD_SSE
-#define SIMD_AVX
-#endif
-
-// MSVC supports compiling SSSE3 code regardless of compile options; we use a cpuid-based scalar fallback
-#if !defined(SIMD_SSE) && !defined(SIMD_AVX) && defined(_MSC_VER) && !defined(__clang__) && (defined(_M_IX86) || defined(_M_X64))
-#define SIMD_SSE
-#define SIMD_FALLBACK
-#endif
-
-// GCC 4.9+ and clang 3.8+ support targeting SIMD ISA from individual functions; we use a cpuid-based scalar fallback
-#if !defined(SIMD_SSE) && !defined(SIMD_AVX) && ((defined(__clang__) && __clang_major__ * 100 + __clang_minor__ >= 308) || (defined(__GNUC__) && __GNUC__ * 100 + __GNUC_MINOR__ >= 409)) && (defined(__i386__) || defined(__x86_64__))
-#define SIMD_SSE
-#define SIMD_FALLBACK
-#define SIMD_TARGET __attribute__((target("ssse3")))
-#endif
-
-// GCC/clang define these when NEON support is available
-#if defined(__ARM_NEON__) || defined(__ARM_NEON)
-#define SIMD_NEON
-#endif
-
-// On MSVC, we assume that ARM builds always target NEON-capable devices
-#if !defined(SIMD_NEON) && defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
-#define SIMD_NEON
-#endif
-
-// When targeting Wasm SIMD we can't use runtime cpuid checks so we unconditionally enable SIMD
-#if defined(__wasm_simd128__)
-#define SIMD_WASM
-#endif
-
-#ifndef SIMD_TARGET
-#define SIMD_TARGET
-#endif
-
-#endif // !MESHOPTIMIZER_NO_SIMD
-
-#ifdef SIMD_SSE
-#include <tmmintrin.h>
-#endif
-
-#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
+#if defined(SIMD_FALLBACK) || defined(SIMD_FALLBACK_SSSE3) || defined(SIMD_AVX2)
 #ifdef _MSC_VER
 #include <intrin.h> // __cpuid
 #else
@@ -64,22 +15,6 @@
 #endif
 #endif
 
-#ifdef SIMD_AVX
-#include <immintrin.h>
-#endif
-
-#ifdef SIMD_NEON
-#if defined(_MSC_VER) && defined(_M_ARM64)
-#include <arm64_neon.h>
-#else
-#include <arm_neon.h>
-#endif
-#endif
-
-#ifdef SIMD_WASM
-#include <wasm_simd128.h>
-#endif
-
 #ifdef SIMD_WASM
 #define wasmx_splat_v32x4(v, i) wasm_v32x4_shuffle(v, v, i, i, i, i)
 #define wasmx_unpacklo_v8x16(a, b) wasm_v8x16_shuffle(a, b, 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23)
@@ -102,6 +37,7 @@ const size_t kVertexBlockMaxSize = 256;
 const size_t kByteGroupSize = 16;
 const size_t kByteGroupDecodeLimit = 24;
 const size_t kTailMaxSize = 32;
+const size_t kVertexBlockOffsetSize = 4;
 
 static size_t getVertexBlockSize(size_t vertex_size)
 {
@@ -125,6 +61,18 @@ inline unsigned char unzigzag8(unsigned char v)
 	return -(v & 1) ^ (v >> 1);
 }
 
+static void writeVertexBlock(unsigned char* vertex_data, unsigned char* transposed, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256], meshopt_FilterCallback filter)
+{
+	// the decoder only needs unfiltered data from last_vertex, so the filter runs after it's saved and before the block is copied to destination
+	memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
+
+	if (filter)
+		filter(transposed, vertex_count, vertex_size);
+
+	memcpy(vertex_data, transposed, vertex_count * vertex_size);
+}
+
+#if defined(SIMD_FALLBACK_SSSE3) || !defined(SIMD_SSSE3)
 static bool encodeBytesGroupZero(const unsigned char* buffer)
 {
 	for (size_t i = 0; i < kByteGroupSize; ++i)
@@ -285,8 +233,9 @@ static unsigned char* encodeVertexBlock(unsigned char* data, unsigned char* data
 
 	return data;
 }
+#endif
 
-#if defined(SIMD_FALLBACK) || (!defined(SIMD_SSE) && !defined(SIMD_NEON) && !defined(SIMD_AVX))
+#if defined(SIMD_FALLBACK_SSSE3) || (!defined(SIMD_SSSE3) && !defined(SIMD_NEON))
 static const unsigned char* decodeBytesGroup(const unsigned char* data, unsigned char* buffer, int bitslog2)
 {
 #define READ() byte = *data++
@@ -365,7 +314,7 @@ static const unsigned char* decodeBytes(const unsigned char* data, const unsigne
 	return data;
 }
 
-static const unsigned char* decodeVertexBlock(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256])
+static const unsigned char* decodeVertexBlock(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256], meshopt_FilterCallback filter)
 {
 	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
 
@@ -395,15 +344,13 @@ static const unsigned char* decodeVertexBlock(const unsigned char* data, const u
 		}
 	}
 
-	memcpy(vertex_data, transposed, vertex_count * vertex_size);
-
-	memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
+	writeVertexBlock(vertex_data, transposed, vertex_count, vertex_size, last_vertex, filter);
 
 	return data;
 }
 #endif
 
-#if defined(SIMD_SSE) || defined(SIMD_NEON) || defined(SIMD_WASM)
+#if defined(SIMD_SSSE3) || defined(SIMD_NEON) || defined(SIMD_WASM)
 static unsigned char kDecodeBytesGroupShuffle[256][8];
 static unsigned char kDecodeBytesGroupCount[256];
 
@@ -435,8 +382,8 @@ decodeBytesGroupBuildTables()
 static bool gDecodeBytesGroupInitialized = decodeBytesGroupBuildTables();
 #endif
 
-#ifdef SIMD_SSE
-SIMD_TARGET
+#ifdef SIMD_SSSE3
+SIMD_TARGET_SSSE3
 static __m128i decodeShuffleMask(unsigned char mask0, unsigned char mask1)
 {
 	__m128i sm0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&kDecodeBytesGroupShuffle[mask0]));
@@ -448,7 +395,7 @@ static __m128i decodeShuffleMask(unsigned char mask0, unsigned char mask1)
 	return _mm_unpacklo_epi64(sm0, sm1r);
 }
 
-SIMD_TARGET
+SIMD_TARGET_SSSE3
 static const unsigned char* decodeBytesGroupSimd(const unsigned char* data, unsigned char* buffer, int bitslog2)
 {
 	switch (bitslog2)
@@ -530,14 +477,8 @@ static const unsigned char* decodeBytesGroupSimd(const unsigned char* data, unsi
 #endif
 
 #ifdef SIMD_AVX
-static const __m128i decodeBytesGroupConfig[] = {
-    _mm_set1_epi8(3),
-    _mm_set1_epi8(15),
-    _mm_setr_epi8(6, 4, 2, 0, 14, 12, 10, 8, 22, 20, 18, 16, 30, 28, 26, 24),
-    _mm_setr_epi8(4, 0, 12, 8, 20, 16, 28, 24, 36, 32, 44, 40, 52, 48, 60, 56),
-};
-
-static const unsigned char* decodeBytesGroupSimd(const unsigned char* data, unsigned char* buffer, int bitslog2)
+SIMD_TARGET_AVX512
+static const unsigned char* decodeBytesGroupAvx512(const unsigned char* data, unsigned char* buffer, int bitslog2)
 {
 	switch (bitslog2)
 	{
@@ -558,11 +499,12 @@ static const unsigned char* decodeBytesGroupSimd(const unsigned char* data, unsi
 		__m128i selb = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
 		__m128i rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(skip));
 
-		__m128i sent = decodeBytesGroupConfig[bitslog2 - 1];
-		__m128i ctrl = decodeBytesGroupConfig[bitslog2 + 1];
+		__m128i sent = (bitslog2 == 1) ? _mm_set1_epi8(3) : _mm_set1_epi8(15);
+		__m128i ctrl = (bitslog2 == 1) ? _mm_setr_epi8(6, 4, 2, 0, 14, 12, 10, 8, 22, 20, 18, 16, 30, 28, 26, 24) : _mm_setr_epi8(4, 0, 12, 8, 20, 16, 28, 24, 36, 32, 44, 40, 52, 48, 60, 56);
 
 		__m128i selw = _mm_shuffle_epi32(selb, 0x44);
-		__m128i sel = _mm_and_si128(sent, _mm_multishift_epi64_epi8(ctrl, selw));
+		// note: maskz form is equivalent to _mm_multishift_epi64_epi8 but avoids a spurious uninitialized warning in gcc
+		__m128i sel = _mm_and_si128(sent, _mm_maskz_multishift_epi64_epi8(0xffff, ctrl, selw));
 		__mmask16 mask16 = _mm_cmp_epi8_mask(sel, sent, _MM_CMPINT_EQ);
 
 		__m128i result = _mm_mask_expand_epi8(sel, mask16, rest);
@@ -693,7 +635,7 @@ static const unsigned char* decodeBytesGroupSimd(const unsigned char* data, unsi
 #endif
 
 #ifdef SIMD_WASM
-SIMD_TARGET
+SIMD_TARGET_SSSE3
 static v128_t decodeShuffleMask(unsigned char mask0, unsigned char mask1)
 {
 	v128_t sm0 = wasm_v128_load(&kDecodeBytesGroupShuffle[mask0]);
@@ -707,7 +649,7 @@ static v128_t decodeShuffleMask(unsigned char mask0, unsigned char mask1)
 	return wasmx_unpacklo_v64x2(sm0, sm1r);
 }
 
-SIMD_TARGET
+SIMD_TARGET_SSSE3
 static void wasmMoveMask(v128_t mask, unsigned char& mask0, unsigned char& mask1)
 {
 	// magic constant found using z3 SMT assuming mask has 8 groups of 0xff or 0x00
@@ -718,7 +660,7 @@ static void wasmMoveMask(v128_t mask, unsigned char& mask0, unsigned char& mask1
 	mask1 = uint8_t((wasm_i64x2_extract_lane(mask, 1) * magic) >> 56);
 }
 
-SIMD_TARGET
+SIMD_TARGET_SSSE3
 static const unsigned char* decodeBytesGroupSimd(const unsigned char* data, unsigned char* buffer, int bitslog2)
 {
 	unsigned char byte, enc, encv;
@@ -796,8 +738,8 @@ static const unsigned char* decodeBytesGroupSimd(const unsigned char* data, unsi
 }
 #endif
 
-#if defined(SIMD_SSE) || defined(SIMD_AVX)
-SIMD_TARGET
+#ifdef SIMD_SSSE3
+SIMD_TARGET_SSSE3
 static void transpose8(__m128i& x0, __m128i& x1, __m128i& x2, __m128i& x3)
 {
 	__m128i t0 = _mm_unpacklo_epi8(x0, x1);
@@ -811,7 +753,7 @@ static void transpose8(__m128i& x0, __m128i& x1, __m128i& x2, __m128i& x3)
 	x3 = _mm_unpackhi_epi16(t1, t3);
 }
 
-SIMD_TARGET
+SIMD_TARGET_SSSE3
 static __m128i unzigzag8(__m128i v)
 {
 	__m128i xl = _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(v, _mm_set1_epi8(1)));
@@ -846,7 +788,7 @@ static uint8x16_t unzigzag8(uint8x16_t v)
 #endif
 
 #ifdef SIMD_WASM
-SIMD_TARGET
+SIMD_TARGET_SSSE3
 static void transpose8(v128_t& x0, v128_t& x1, v128_t& x2, v128_t& x3)
 {
 	v128_t t0 = wasmx_unpacklo_v8x16(x0, x1);
@@ -860,7 +802,7 @@ static void transpose8(v128_t& x0, v128_t& x1, v128_t& x2, v128_t& x3)
 	x3 = wasmx_unpackhi_v16x8(t1, t3);
 }
 
-SIMD_TARGET
+SIMD_TARGET_SSSE3
 static v128_t unzigzag8(v128_t v)
 {
 	v128_t xl = wasm_i8x16_neg(wasm_v128_and(v, wasm_i8x16_splat(1)));
@@ -870,8 +812,8 @@ static v128_t unzigzag8(v128_t v)
 }
 #endif
 
-#if defined(SIMD_SSE) || defined(SIMD_AVX) || defined(SIMD_NEON) || defined(SIMD_WASM)
-SIMD_TARGET
+#if defined(SIMD_SSSE3) || defined(SIMD_NEON) || defined(SIMD_WASM)
+SIMD_TARGET_SSSE3
 static const unsigned char* decodeBytesSimd(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size)
 {
 	assert(buffer_size % kByteGroupSize == 0);
@@ -917,8 +859,8 @@ static const unsigned char* decodeBytesSimd(const unsigned char* data, const uns
 	return data;
 }
 
-SIMD_TARGET
-static const unsigned char* decodeVertexBlockSimd(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256])
+SIMD_TARGET_SSSE3
+static const unsigned char* decodeVertexBlockSimd(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256], meshopt_FilterCallback filter)
 {
 	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
 
@@ -936,7 +878,7 @@ static const unsigned char* decodeVertexBlockSimd(const unsigned char* data, con
 				return 0;
 		}
 
-#if defined(SIMD_SSE) || defined(SIMD_AVX)
+#ifdef SIMD_SSSE3
 #define TEMP __m128i
 #define PREP() __m128i pi = _mm_cvtsi32_si128(*reinterpret_cast<const int*>(last_vertex + k))
 #define LOAD(i) __m128i r##i = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + i * vertex_count_aligned))
@@ -1008,186 +950,1721 @@ static const unsigned char* decodeVertexBlockSimd(const unsigned char* data, con
 		}
 	}
 
-	memcpy(vertex_data, transposed, vertex_count * vertex_size);
-
-	memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
+	writeVertexBlock(vertex_data, transposed, vertex_count, vertex_size, last_vertex, filter);
 
 	return data;
 }
 #endif
 
-#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
-static unsigned int getCpuFeatures()
+#ifdef SIMD_SSSE3
+static unsigned char kEncodeBytesGroupShuffle[256][8];
+
+static bool encodeBytesGroupBuildTables()
 {
-	int cpuinfo[4] = {};
-#ifdef _MSC_VER
-	__cpuid(cpuinfo, 1);
-#else
-	__cpuid(1, cpuinfo[0], cpuinfo[1], cpuinfo[2], cpuinfo[3]);
-#endif
-	return cpuinfo[2];
-}
+	for (int mask = 0; mask < 256; ++mask)
+	{
+		unsigned char shuffle[8] = {};
+		unsigned char count = 0;
 
-unsigned int cpuid = getCpuFeatures();
-#endif
+		for (int i = 0; i < 8; ++i)
+			if (mask & (1 << i))
+				shuffle[count++] = (unsigned char)(i);
 
-} // namespace meshopt
+		memcpy(kEncodeBytesGroupShuffle[mask], shuffle, 8);
+	}
 
-size_t meshopt_encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size)
+	return true;
+}
+
+static bool gEncodeBytesGroupInitialized = encodeBytesGroupBuildTables();
+
+static int encodeBytesGroupSelect(bool zero, unsigned char mask2_0, unsigned char mask2_1, unsigned char mask4_0, unsigned char mask4_1)
 {
-	using namespace meshopt;
+	// same selection order as the scalar encoder: 8 bits are used unless 0, 2 or 4 bits are strictly smaller
+	size_t best_size = kByteGroupSize;
+	int best_bitslog2 = 3;
 
-	assert(vertex_size > 0 && vertex_size <= 256);
-	assert(vertex_size % 4 == 0);
+	if (zero)
+	{
+		best_size = 0;
+		best_bitslog2 = 0;
+	}
 
-	const unsigned char* vertex_data = static_cast<const unsigned char*>(vertices);
+	size_t size2 = 4 + kDecodeBytesGroupCount[mask2_0] + kDecodeBytesGroupCount[mask2_1];
 
-	unsigned char* data = buffer;
-	unsigned char* data_end = buffer + buffer_size;
+	if (size2 < best_size)
+	{
+		best_size = size2;
+		best_bitslog2 = 1;
+	}
 
-	if (size_t(data_end - data) < 1 + vertex_size)
-		return 0;
+	size_t size4 = 8 + kDecodeBytesGroupCount[mask4_0] + kDecodeBytesGroupCount[mask4_1];
 
-	int version = gEncodeVertexVersion;
+	if (size4 < best_size)
+	{
+		best_size = size4;
+		best_bitslog2 = 2;
+	}
 
-	*data++ = (unsigned char)(kVertexHeader | version);
+	return best_bitslog2;
+}
+#endif
 
-	unsigned char first_vertex[256] = {};
-	if (vertex_count > 0)
-		memcpy(first_vertex, vertex_data, vertex_size);
+#ifdef SIMD_SSSE3
+SIMD_TARGET_SSSE3
+static unsigned char* encodeBytesGroupSentinels(unsigned char* data, __m128i v, unsigned char mask0, unsigned char mask1)
+{
+	// compact bytes that didn't fit into the fixed portion; each half writes 8 bytes but advances by the number of selected bytes
+	__m128i sm0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&kEncodeBytesGroupShuffle[mask0]));
+	__m128i sm1 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&kEncodeBytesGroupShuffle[mask1]));
 
-	unsigned char last_vertex[256] = {};
-	memcpy(last_vertex, first_vertex, vertex_size);
+	__m128i sm1r = _mm_add_epi8(sm1, _mm_set1_epi8(8));
 
-	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(data), _mm_shuffle_epi8(v, sm0));
+	data += kDecodeBytesGroupCount[mask0];
 
-	size_t vertex_offset = 0;
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(data), _mm_shuffle_epi8(v, sm1r));
+	data += kDecodeBytesGroupCount[mask1];
 
-	while (vertex_offset < vertex_count)
+	return data;
+}
+
+SIMD_TARGET_SSSE3
+static unsigned char* encodeBytesGroupSimd(unsigned char* data, const unsigned char* buffer, int& bitslog2)
+{
+#ifdef __GNUC__
+	typedef int __attribute__((aligned(1))) unaligned_int;
+#else
+	typedef int unaligned_int;
+#endif
+
+	__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer));
+
+	int mask0 = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128()));
+	int mask2 = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(3)), v));
+	int mask4 = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(15)), v));
+
+	bitslog2 = encodeBytesGroupSelect(mask0 == 0xffff, (unsigned char)(mask2 & 255), (unsigned char)(mask2 >> 8), (unsigned char)(mask4 & 255), (unsigned char)(mask4 >> 8));
+
+	switch (bitslog2)
 	{
-		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+	case 0:
+		return data;
 
-		data = encodeVertexBlock(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
-		if (!data)
-			return 0;
+	case 1:
+	{
+		// combine 2-bit values into nibbles (first value in high bits) and then nibbles into bytes
+		__m128i enc = _mm_min_epu8(v, _mm_set1_epi8(3));
+		__m128i enc4 = _mm_maddubs_epi16(enc, _mm_set1_epi16(0x0104));
+		__m128i enc8 = _mm_madd_epi16(enc4, _mm_set1_epi32(0x00010010));
+		__m128i sel = _mm_shuffle_epi8(enc8, _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
 
-		vertex_offset += block_size;
+		*reinterpret_cast<unaligned_int*>(data) = _mm_cvtsi128_si32(sel);
+
+		return encodeBytesGroupSentinels(data + 4, v, (unsigned char)(mask2 & 255), (unsigned char)(mask2 >> 8));
 	}
 
-	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+	case 2:
+	{
+		__m128i enc = _mm_min_epu8(v, _mm_set1_epi8(15));
+		__m128i enc8 = _mm_maddubs_epi16(enc, _mm_set1_epi16(0x0110));
+		__m128i sel = _mm_packus_epi16(enc8, enc8);
 
-	if (size_t(data_end - data) < tail_size)
-		return 0;
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(data), sel);
 
-	// write first vertex to the end of the stream and pad it to 32 bytes; this is important to simplify bounds checks in decoder
-	if (vertex_size < kTailMaxSize)
-	{
-		memset(data, 0, kTailMaxSize - vertex_size);
-		data += kTailMaxSize - vertex_size;
+		return encodeBytesGroupSentinels(data + 8, v, (unsigned char)(mask4 & 255), (unsigned char)(mask4 >> 8));
 	}
 
-	memcpy(data, first_vertex, vertex_size);
-	data += vertex_size;
+	case 3:
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data), v);
 
-	assert(data >= buffer + tail_size);
-	assert(data <= buffer + buffer_size);
+		return data + 16;
 
-	return data - buffer;
+	default:
+		assert(!"Unexpected bit length"); // unreachable since bitslog2 is a 2-bit value
+		return data;
+	}
 }
 
-size_t meshopt_encodeVertexBufferBound(size_t vertex_count, size_t vertex_size)
+SIMD_TARGET_SSSE3
+static void encodeDeltas4Simd(unsigned char* buffer, size_t buffer_stride, const unsigned int* column)
 {
-	using namespace meshopt;
+	// column[0] is the previous vertex, column[1..16] are the 16 vertices to encode
+	__m128i shuf = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
 
-	assert(vertex_size > 0 && vertex_size <= 256);
-	assert(vertex_size % 4 == 0);
+	__m128i r[4];
 
-	size_t vertex_block_size = getVertexBlockSize(vertex_size);
-	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+	for (int j = 0; j < 4; ++j)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + 1 + j * 4));
+		__m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + j * 4));
 
-	size_t vertex_block_header_size = (vertex_block_size / kByteGroupSize + 3) / 4;
-	size_t vertex_block_data_size = vertex_block_size;
+		__m128i d = _mm_sub_epi8(v, p);
+		__m128i zz = _mm_xor_si128(_mm_add_epi8(d, d), _mm_cmpgt_epi8(_mm_setzero_si128(), d));
 
-	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+		r[j] = _mm_shuffle_epi8(zz, shuf);
+	}
 
-	return 1 + vertex_block_count * vertex_size * (vertex_block_header_size + vertex_block_data_size) + tail_size;
+	// 4x4 transpose of 32-bit elements; each element now contains one byte of 4 consecutive vertices
+	__m128i t0 = _mm_unpacklo_epi32(r[0], r[1]);
+	__m128i t1 = _mm_unpackhi_epi32(r[0], r[1]);
+	__m128i t2 = _mm_unpacklo_epi32(r[2], r[3]);
+	__m128i t3 = _mm_unpackhi_epi32(r[2], r[3]);
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + buffer_stride * 0), _mm_unpacklo_epi64(t0, t2));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + buffer_stride * 1), _mm_unpackhi_epi64(t0, t2));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + buffer_stride * 2), _mm_unpacklo_epi64(t1, t3));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + buffer_stride * 3), _mm_unpackhi_epi64(t1, t3));
 }
+#endif
 
-void meshopt_encodeVertexVersion(int version)
+#ifdef SIMD_SSSE3
+SIMD_TARGET_SSSE3
+static unsigned char* encodeBytesSimd(unsigned char* data, unsigned char* data_end, const unsigned char* buffer, size_t buffer_size)
 {
-	assert(unsigned(version) <= 0);
+	assert(buffer_size % kByteGroupSize == 0);
+	assert(kByteGroupSize == 16);
 
-	meshopt::gEncodeVertexVersion = version;
+	unsigned char* header = data;
+
+	// round number of groups to 4 to get number of header bytes
+	size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+
+	if (size_t(data_end - data) < header_size)
+		return 0;
+
+	data += header_size;
+
+	memset(header, 0, header_size);
+
+	for (size_t i = 0; i < buffer_size; i += kByteGroupSize)
+	{
+		// each group writes <=24b, including the unused bytes past the variable portion
+		if (size_t(data_end - data) < kByteGroupDecodeLimit)
+			return 0;
+
+		int bitslog2 = 0;
+		data = encodeBytesGroupSimd(data, buffer + i, bitslog2);
+
+		size_t header_offset = i / kByteGroupSize;
+
+		header[header_offset / 4] |= bitslog2 << ((header_offset % 4) * 2);
+	}
+
+	return data;
 }
 
-int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size)
+SIMD_TARGET_SSSE3
+static unsigned char* encodeVertexBlockSimd(unsigned char* data, unsigned char* data_end, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256])
 {
-	using namespace meshopt;
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
 
-	assert(vertex_size > 0 && vertex_size <= 256);
-	assert(vertex_size % 4 == 0);
+	unsigned int column[kVertexBlockMaxSize + 1];
+	unsigned char buffer[kVertexBlockMaxSize * 4];
 
-	const unsigned char* (*decode)(const unsigned char*, const unsigned char*, unsigned char*, size_t, size_t, unsigned char[256]) = 0;
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
 
-#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
-	decode = (cpuid & (1 << 9)) ? decodeVertexBlockSimd : decodeVertexBlock;
-#elif defined(SIMD_SSE) || defined(SIMD_AVX) || defined(SIMD_NEON) || defined(SIMD_WASM)
-	decode = decodeVertexBlockSimd;
-#else
-	decode = decodeVertexBlock;
+	for (size_t k = 0; k < vertex_size; k += 4)
+	{
+		// gather 4 bytes of each vertex, preceded by the previous vertex
+		memcpy(&column[0], last_vertex + k, 4);
+
+		for (size_t i = 0; i < vertex_count; ++i)
+			memcpy(&column[i + 1], vertex_data + i * vertex_size + k, 4);
+
+		// we encode elements we didn't fill when rounding to kByteGroupSize; repeating the last vertex makes their deltas zero
+		for (size_t i = vertex_count; i < vertex_count_aligned; ++i)
+			column[i + 1] = column[vertex_count];
+
+		for (size_t i = 0; i < vertex_count_aligned; i += 16)
+			encodeDeltas4Simd(buffer + i, vertex_count_aligned, column + i);
+
+		for (size_t j = 0; j < 4; ++j)
+		{
+			data = encodeBytesSimd(data, data_end, buffer + j * vertex_count_aligned, vertex_count_aligned);
+			if (!data)
+				return 0;
+		}
+	}
+
+	memcpy(last_vertex, &vertex_data[vertex_size * (vertex_count - 1)], vertex_size);
+
+	return data;
+}
 #endif
 
-#if defined(SIMD_SSE) || defined(SIMD_NEON) || defined(SIMD_WASM)
-	assert(gDecodeBytesGroupInitialized);
-	(void)gDecodeBytesGroupInitialized;
+#ifdef SIMD_AVX2
+SIMD_TARGET_AVX2
+static const unsigned char* decodeBytesGroupPairAvx2(const unsigned char* data, unsigned char* buffer, int bitslog2)
+{
+#ifdef __GNUC__
+	typedef int __attribute__((aligned(1))) unaligned_int;
+#else
+	typedef int unaligned_int;
 #endif
 
-	unsigned char* vertex_data = static_cast<unsigned char*>(destination);
+	switch (bitslog2)
+	{
+	case 0:
+	{
+		__m256i result = _mm256_setzero_si256();
 
-	const unsigned char* data = buffer;
-	const unsigned char* data_end = buffer + buffer_size;
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer), result);
 
-	if (size_t(data_end - data) < 1 + vertex_size)
-		return -2;
+		return data;
+	}
 
-	unsigned char data_header = *data++;
+	case 1:
+	{
+		// sentinel count only depends on selector bits, so we can locate the second group without waiting for the first one to decode
+		unsigned int s0 = *reinterpret_cast<const unaligned_int*>(data);
+		const unsigned char* data1 = data + 4 + _mm_popcnt_u32(s0 & (s0 >> 1) & 0x55555555);
+		unsigned int s1 = *reinterpret_cast<const unaligned_int*>(data1);
 
-	if ((data_header & 0xf0) != kVertexHeader)
-		return -1;
+		__m256i sel2 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_cvtsi32_si128(s0)), _mm_cvtsi32_si128(s1), 1);
+		__m256i rest = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4))), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data1 + 4)), 1);
 
-	int version = data_header & 0x0f;
-	if (version > 0)
-		return -1;
+		__m256i sel22 = _mm256_unpacklo_epi8(_mm256_srli_epi16(sel2, 4), sel2);
+		__m256i sel2222 = _mm256_unpacklo_epi8(_mm256_srli_epi16(sel22, 2), sel22);
+		__m256i sel = _mm256_and_si256(sel2222, _mm256_set1_epi8(3));
 
-	unsigned char last_vertex[256];
-	memcpy(last_vertex, data_end - vertex_size, vertex_size);
+		__m256i mask = _mm256_cmpeq_epi8(sel, _mm256_set1_epi8(3));
+		unsigned int mask32 = _mm256_movemask_epi8(mask);
 
-	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+		__m256i shuf = _mm256_inserti128_si256(_mm256_castsi128_si256(decodeShuffleMask((unsigned char)(mask32), (unsigned char)(mask32 >> 8))), decodeShuffleMask((unsigned char)(mask32 >> 16), (unsigned char)(mask32 >> 24)), 1);
 
-	size_t vertex_offset = 0;
+		__m256i result = _mm256_or_si256(_mm256_shuffle_epi8(rest, shuf), _mm256_andnot_si256(mask, sel));
 
-	while (vertex_offset < vertex_count)
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer), result);
+
+		return data1 + 4 + _mm_popcnt_u32(mask32 >> 16);
+	}
+
+	case 2:
 	{
-		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+		unsigned int s0a = reinterpret_cast<const unaligned_int*>(data)[0];
+		unsigned int s0b = reinterpret_cast<const unaligned_int*>(data)[1];
+		const unsigned char* data1 = data + 8 + _mm_popcnt_u32((s0a & (s0a >> 1) & (s0a >> 2) & (s0a >> 3) & 0x11111111) | ((s0b & (s0b >> 1) & (s0b >> 2) & (s0b >> 3) & 0x11111111) << 1));
 
-		data = decode(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
-		if (!data)
-			return -2;
+		__m256i sel4 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(data))), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data1)), 1);
+		__m256i rest = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 8))), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data1 + 8)), 1);
 
-		vertex_offset += block_size;
+		__m256i sel44 = _mm256_unpacklo_epi8(_mm256_srli_epi16(sel4, 4), sel4);
+		__m256i sel = _mm256_and_si256(sel44, _mm256_set1_epi8(15));
+
+		__m256i mask = _mm256_cmpeq_epi8(sel, _mm256_set1_epi8(15));
+		unsigned int mask32 = _mm256_movemask_epi8(mask);
+
+		__m256i shuf = _mm256_inserti128_si256(_mm256_castsi128_si256(decodeShuffleMask((unsigned char)(mask32), (unsigned char)(mask32 >> 8))), decodeShuffleMask((unsigned char)(mask32 >> 16), (unsigned char)(mask32 >> 24)), 1);
+
+		__m256i result = _mm256_or_si256(_mm256_shuffle_epi8(rest, shuf), _mm256_andnot_si256(mask, sel));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer), result);
+
+		return data1 + 8 + _mm_popcnt_u32(mask32 >> 16);
 	}
 
-	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+	case 3:
+	{
+		__m256i result = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
 
-	if (size_t(data_end - data) != tail_size)
-		return -3;
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer), result);
 
-	return 0;
+		return data + 32;
+	}
+
+	default:
+		assert(!"Unexpected bit length"); // unreachable since bitslog2 is a 2-bit value
+		return data;
+	}
 }
 
-#undef SIMD_NEON
-#undef SIMD_SSE
-#undef SIMD_AVX
-#undef SIMD_WASM
+SIMD_TARGET_AVX2
+static const unsigned char* decodeBytesAvx2(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size)
+{
+	assert(buffer_size % kByteGroupSize == 0);
+	assert(kByteGroupSize == 16);
+
+	const unsigned char* header = data;
+
+	// round number of groups to 4 to get number of header bytes
+	size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+
+	if (size_t(data_end - data) < header_size)
+		return 0;
+
+	data += header_size;
+
+	size_t i = 0;
+
+	// fast-path: process 4 groups at a time, do a shared bounds check - each group reads <=24b
+	// adjacent groups that share the encoding mode are decoded together using 256-bit registers
+	for (; i + kByteGroupSize * 4 <= buffer_size && size_t(data_end - data) >= kByteGroupDecodeLimit * 4; i += kByteGroupSize * 4)
+	{
+		size_t header_offset = i / kByteGroupSize;
+		unsigned char header_byte = header[header_offset / 4];
+
+		int m0 = (header_byte >> 0) & 3, m1 = (header_byte >> 2) & 3;
+		int m2 = (header_byte >> 4) & 3, m3 = (header_byte >> 6) & 3;
+
+		if (m0 == m1)
+			data = decodeBytesGroupPairAvx2(data, buffer + i + kByteGroupSize * 0, m0);
+		else
+		{
+			data = decodeBytesGroupSimd(data, buffer + i + kByteGroupSize * 0, m0);
+			data = decodeBytesGroupSimd(data, buffer + i + kByteGroupSize * 1, m1);
+		}
+
+		if (m2 == m3)
+			data = decodeBytesGroupPairAvx2(data, buffer + i + kByteGroupSize * 2, m2);
+		else
+		{
+			data = decodeBytesGroupSimd(data, buffer + i + kByteGroupSize * 2, m2);
+			data = decodeBytesGroupSimd(data, buffer + i + kByteGroupSize * 3, m3);
+		}
+	}
+
+	// slow-path: process remaining groups
+	for (; i < buffer_size; i += kByteGroupSize)
+	{
+		if (size_t(data_end - data) < kByteGroupDecodeLimit)
+			return 0;
+
+		size_t header_offset = i / kByteGroupSize;
+
+		int bitslog2 = (header[header_offset / 4] >> ((header_offset % 4) * 2)) & 3;
+
+		data = decodeBytesGroupSimd(data, buffer + i, bitslog2);
+	}
+
+	return data;
+}
+
+SIMD_TARGET_AVX2
+static void transpose8(__m256i& x0, __m256i& x1, __m256i& x2, __m256i& x3)
+{
+	__m256i t0 = _mm256_unpacklo_epi8(x0, x1);
+	__m256i t1 = _mm256_unpackhi_epi8(x0, x1);
+	__m256i t2 = _mm256_unpacklo_epi8(x2, x3);
+	__m256i t3 = _mm256_unpackhi_epi8(x2, x3);
+
+	x0 = _mm256_unpacklo_epi16(t0, t2);
+	x1 = _mm256_unpackhi_epi16(t0, t2);
+	x2 = _mm256_unpacklo_epi16(t1, t3);
+	x3 = _mm256_unpackhi_epi16(t1, t3);
+}
+
+SIMD_TARGET_AVX2
+static __m256i unzigzag8(__m256i v)
+{
+	__m256i xl = _mm256_sub_epi8(_mm256_setzero_si256(), _mm256_and_si256(v, _mm256_set1_epi8(1)));
+	__m256i xr = _mm256_and_si256(_mm256_srli_epi16(v, 1), _mm256_set1_epi8(127));
+
+	return _mm256_xor_si256(xl, xr);
+}
+
+SIMD_TARGET_AVX2
+static __m256i prefixSum4(__m256i v)
+{
+	// inclusive prefix sum of 4 bytewise vertex deltas in each 128-bit lane
+	v = _mm256_add_epi8(v, _mm256_slli_si256(v, 4));
+	v = _mm256_add_epi8(v, _mm256_slli_si256(v, 8));
+
+	return v;
+}
+
+SIMD_TARGET_AVX2
+static void save4(unsigned char* savep, size_t vertex_size, __m128i v)
+{
+	*reinterpret_cast<int*>(savep + vertex_size * 0) = _mm_cvtsi128_si32(v);
+	*reinterpret_cast<int*>(savep + vertex_size * 1) = _mm_extract_epi32(v, 1);
+	*reinterpret_cast<int*>(savep + vertex_size * 2) = _mm_extract_epi32(v, 2);
+	*reinterpret_cast<int*>(savep + vertex_size * 3) = _mm_extract_epi32(v, 3);
+}
+
+SIMD_TARGET_AVX2
+static void decodeDeltasAvx2(unsigned char* transposed, const unsigned char* buffer, size_t vertex_count_aligned, size_t vertex_size, const unsigned char last_vertex[4])
+{
+	__m256i pi = _mm256_set1_epi32(*reinterpret_cast<const int*>(last_vertex));
+
+	unsigned char* savep = transposed;
+
+	size_t j = 0;
+
+	// process 32 vertices at a time; after the transpose, lane 0 has vertices 0..15 and lane 1 has vertices 16..31
+	// instead of accumulating deltas one vertex at a time, we compute prefix sums within each register and propagate the carries
+	for (; j + 32 <= vertex_count_aligned; j += 32)
+	{
+		__m256i r0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + j + 0 * vertex_count_aligned));
+		__m256i r1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + j + 1 * vertex_count_aligned));
+		__m256i r2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + j + 2 * vertex_count_aligned));
+		__m256i r3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + j + 3 * vertex_count_aligned));
+
+		r0 = unzigzag8(r0);
+		r1 = unzigzag8(r1);
+		r2 = unzigzag8(r2);
+		r3 = unzigzag8(r3);
+
+		transpose8(r0, r1, r2, r3);
+
+		r0 = prefixSum4(r0);
+		r1 = _mm256_add_epi8(prefixSum4(r1), _mm256_shuffle_epi32(r0, 0xff));
+		r2 = _mm256_add_epi8(prefixSum4(r2), _mm256_shuffle_epi32(r1, 0xff));
+		r3 = _mm256_add_epi8(prefixSum4(r3), _mm256_shuffle_epi32(r2, 0xff));
+
+		// lane 1 needs the sum of all lane 0 deltas, lane 0 needs nothing
+		__m256i last = _mm256_shuffle_epi32(r3, 0xff);
+		__m256i carry = _mm256_add_epi8(pi, _mm256_permute2x128_si256(last, last, 0x08));
+
+		r0 = _mm256_add_epi8(r0, carry);
+		r1 = _mm256_add_epi8(r1, carry);
+		r2 = _mm256_add_epi8(r2, carry);
+		r3 = _mm256_add_epi8(r3, carry);
+
+		pi = _mm256_permute2x128_si256(_mm256_shuffle_epi32(r3, 0xff), r3, 0x11);
+
+		save4(savep + vertex_size * 0, vertex_size, _mm256_castsi256_si128(r0));
+		save4(savep + vertex_size * 4, vertex_size, _mm256_castsi256_si128(r1));
+		save4(savep + vertex_size * 8, vertex_size, _mm256_castsi256_si128(r2));
+		save4(savep + vertex_size * 12, vertex_size, _mm256_castsi256_si128(r3));
+		save4(savep + vertex_size * 16, vertex_size, _mm256_extracti128_si256(r0, 1));
+		save4(savep + vertex_size * 20, vertex_size, _mm256_extracti128_si256(r1, 1));
+		save4(savep + vertex_size * 24, vertex_size, _mm256_extracti128_si256(r2, 1));
+		save4(savep + vertex_size * 28, vertex_size, _mm256_extracti128_si256(r3, 1));
+
+		savep += vertex_size * 32;
+	}
+
+	// process remaining 16 vertices using the same scheme on 128-bit registers
+	if (j < vertex_count_aligned)
+	{
+		assert(j + 16 == vertex_count_aligned);
+
+		__m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + 0 * vertex_count_aligned));
+		__m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + 1 * vertex_count_aligned));
+		__m128i r2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + 2 * vertex_count_aligned));
+		__m128i r3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + 3 * vertex_count_aligned));
+
+		r0 = unzigzag8(r0);
+		r1 = unzigzag8(r1);
+		r2 = unzigzag8(r2);
+		r3 = unzigzag8(r3);
+
+		transpose8(r0, r1, r2, r3);
+
+		__m128i p0 = _mm256_castsi256_si128(pi);
+
+		r0 = _mm_add_epi8(r0, _mm_slli_si128(r0, 4));
+		r0 = _mm_add_epi8(r0, _mm_slli_si128(r0, 8));
+		r0 = _mm_add_epi8(r0, p0);
+		r1 = _mm_add_epi8(r1, _mm_slli_si128(r1, 4));
+		r1 = _mm_add_epi8(r1, _mm_slli_si128(r1, 8));
+		r1 = _mm_add_epi8(r1, _mm_shuffle_epi32(r0, 0xff));
+		r2 = _mm_add_epi8(r2, _mm_slli_si128(r2, 4));
+		r2 = _mm_add_epi8(r2, _mm_slli_si128(r2, 8));
+		r2 = _mm_add_epi8(r2, _mm_shuffle_epi32(r1, 0xff));
+		r3 = _mm_add_epi8(r3, _mm_slli_si128(r3, 4));
+		r3 = _mm_add_epi8(r3, _mm_slli_si128(r3, 8));
+		r3 = _mm_add_epi8(r3, _mm_shuffle_epi32(r2, 0xff));
+
+		save4(savep + vertex_size * 0, vertex_size, r0);
+		save4(savep + vertex_size * 4, vertex_size, r1);
+		save4(savep + vertex_size * 8, vertex_size, r2);
+		save4(savep + vertex_size * 12, vertex_size, r3);
+	}
+}
+
+SIMD_TARGET_AVX2
+static const unsigned char* decodeVertexBlockAvx2(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256], meshopt_FilterCallback filter)
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+
+	unsigned char buffer[kVertexBlockMaxSize * 4];
+	unsigned char transposed[kVertexBlockSizeBytes];
+
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+	for (size_t k = 0; k < vertex_size; k += 4)
+	{
+		for (size_t j = 0; j < 4; ++j)
+		{
+			data = decodeBytesAvx2(data, data_end, buffer + j * vertex_count_aligned, vertex_count_aligned);
+			if (!data)
+				return 0;
+		}
+
+		decodeDeltasAvx2(transposed + k, buffer, vertex_count_aligned, vertex_size, last_vertex + k);
+	}
+
+	writeVertexBlock(vertex_data, transposed, vertex_count, vertex_size, last_vertex, filter);
+
+	return data;
+}
+#endif
+
+#ifdef SIMD_AVX
+SIMD_TARGET_AVX512
+static const unsigned char* decodeBytesAvx512(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size)
+{
+	assert(buffer_size % kByteGroupSize == 0);
+	assert(kByteGroupSize == 16);
+
+	const unsigned char* header = data;
+
+	// round number of groups to 4 to get number of header bytes
+	size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+
+	if (size_t(data_end - data) < header_size)
+		return 0;
+
+	data += header_size;
+
+	size_t i = 0;
+
+	// fast-path: process 4 groups at a time, do a shared bounds check - each group reads <=24b
+	for (; i + kByteGroupSize * 4 <= buffer_size && size_t(data_end - data) >= kByteGroupDecodeLimit * 4; i += kByteGroupSize * 4)
+	{
+		size_t header_offset = i / kByteGroupSize;
+		unsigned char header_byte = header[header_offset / 4];
+
+		data = decodeBytesGroupAvx512(data, buffer + i + kByteGroupSize * 0, (header_byte >> 0) & 3);
+		data = decodeBytesGroupAvx512(data, buffer + i + kByteGroupSize * 1, (header_byte >> 2) & 3);
+		data = decodeBytesGroupAvx512(data, buffer + i + kByteGroupSize * 2, (header_byte >> 4) & 3);
+		data = decodeBytesGroupAvx512(data, buffer + i + kByteGroupSize * 3, (header_byte >> 6) & 3);
+	}
+
+	// slow-path: process remaining groups
+	for (; i < buffer_size; i += kByteGroupSize)
+	{
+		if (size_t(data_end - data) < kByteGroupDecodeLimit)
+			return 0;
+
+		size_t header_offset = i / kByteGroupSize;
+
+		int bitslog2 = (header[header_offset / 4] >> ((header_offset % 4) * 2)) & 3;
+
+		data = decodeBytesGroupAvx512(data, buffer + i, bitslog2);
+	}
+
+	return data;
+}
+
+SIMD_TARGET_AVX512
+static const unsigned char* decodeVertexBlockAvx512(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256], meshopt_FilterCallback filter)
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+
+	unsigned char buffer[kVertexBlockMaxSize * 4];
+	unsigned char transposed[kVertexBlockSizeBytes];
+
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+	for (size_t k = 0; k < vertex_size; k += 4)
+	{
+		for (size_t j = 0; j < 4; ++j)
+		{
+			data = decodeBytesAvx512(data, data_end, buffer + j * vertex_count_aligned, vertex_count_aligned);
+			if (!data)
+				return 0;
+		}
+
+		// AVX512 implies AVX2, so we share the delta decoding with the AVX2 kernel
+		decodeDeltasAvx2(transposed + k, buffer, vertex_count_aligned, vertex_size, last_vertex + k);
+	}
+
+	writeVertexBlock(vertex_data, transposed, vertex_count, vertex_size, last_vertex, filter);
+
+	return data;
+}
+#endif
+
+// SIMD kernels are selected once per process based on the SIMD level; see meshopt_getSimdLevel
+#if defined(SIMD_FALLBACK) || defined(SIMD_FALLBACK_SSSE3) || defined(SIMD_AVX2)
+static void getCpuInfo(int cpuinfo[4], int leaf)
+{
+#ifdef _MSC_VER
+	__cpuidex(cpuinfo, leaf, 0);
+#else
+	__cpuid_count(leaf, 0, cpuinfo[0], cpuinfo[1], cpuinfo[2], cpuinfo[3]);
+#endif
+}
+
+static unsigned int getXcr0()
+{
+#ifdef _MSC_VER
+	return unsigned(_xgetbv(0));
+#else
+	unsigned int xcr0, xcr0h;
+	__asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0h) : "c"(0));
+	(void)xcr0h;
+	return xcr0;
+#endif
+}
+
+static int getCpuFeatures()
+{
+	int cpuinfo[4] = {};
+	getCpuInfo(cpuinfo, 0);
+
+	int max_leaf = cpuinfo[0];
+
+	getCpuInfo(cpuinfo, 1);
+
+	unsigned int ecx1 = cpuinfo[2], edx1 = cpuinfo[3];
+
+	if ((edx1 & (1 << 26)) == 0)
+		return meshopt_SimdScalar;
+
+	if ((ecx1 & (1 << 9)) == 0)
+		return meshopt_SimdBaseline;
+
+	// YMM/ZMM registers can only be used when the OS saves them on context switch (OSXSAVE + XCR0)
+	if (max_leaf < 7 || (ecx1 & (1 << 27)) == 0)
+		return meshopt_SimdSSSE3;
+
+	unsigned int xcr0 = getXcr0();
+
+	getCpuInfo(cpuinfo, 7);
+
+	unsigned int ebx7 = cpuinfo[1], ecx7 = cpuinfo[2];
+
+	// AVX2 kernel also needs POPCNT
+	if ((xcr0 & 6) != 6 || (ebx7 & (1 << 5)) == 0 || (ecx1 & (1 << 23)) == 0)
+		return meshopt_SimdSSSE3;
+
+	// AVX512 kernel needs F/BW/VL/VBMI/VBMI2 and opmask/ZMM register state
+	unsigned int avx512_ebx = (1u << 16) | (1u << 30) | (1u << 31);
+	unsigned int avx512_ecx = (1u << 1) | (1u << 6);
+
+	if ((xcr0 & 0xe6) != 0xe6 || (ebx7 & avx512_ebx) != avx512_ebx || (ecx7 & avx512_ecx) != avx512_ecx)
+		return meshopt_SimdAVX2;
+
+	return meshopt_SimdAVX512;
+}
+
+int gSimdLevel = getCpuFeatures();
+#elif defined(SIMD_SSSE3)
+int gSimdLevel = meshopt_SimdSSSE3;
+#elif defined(SIMD_SSE) || defined(SIMD_NEON) || defined(SIMD_WASM)
+int gSimdLevel = meshopt_SimdBaseline;
+#else
+int gSimdLevel = meshopt_SimdScalar;
+#endif
+
+typedef unsigned char* (*EncodeVertexBlockFn)(unsigned char*, unsigned char*, const unsigned char*, size_t, size_t, unsigned char[256]);
+
+static EncodeVertexBlockFn getEncodeVertexBlock()
+{
+#if defined(SIMD_SSSE3) && defined(SIMD_FALLBACK_SSSE3)
+	return (gSimdLevel >= meshopt_SimdSSSE3) ? encodeVertexBlockSimd : encodeVertexBlock;
+#elif defined(SIMD_SSSE3)
+	return encodeVertexBlockSimd;
+#else
+	return encodeVertexBlock;
+#endif
+}
+
+typedef const unsigned char* (*DecodeVertexBlockFn)(const unsigned char*, const unsigned char*, unsigned char*, size_t, size_t, unsigned char[256], meshopt_FilterCallback);
+
+static DecodeVertexBlockFn getDecodeVertexBlock()
+{
+#ifdef SIMD_AVX
+	if (gSimdLevel >= meshopt_SimdAVX512)
+		return decodeVertexBlockAvx512;
+#endif
+
+#ifdef SIMD_AVX2
+	if (gSimdLevel >= meshopt_SimdAVX2)
+		return decodeVertexBlockAvx2;
+#endif
+
+#if defined(SIMD_SSSE3) && defined(SIMD_FALLBACK_SSSE3)
+	return (gSimdLevel >= meshopt_SimdSSSE3) ? decodeVertexBlockSimd : decodeVertexBlock;
+#elif defined(SIMD_SSSE3) || defined(SIMD_NEON) || defined(SIMD_WASM)
+	return decodeVertexBlockSimd;
+#else
+	return decodeVertexBlock;
+#endif
+}
+
+inline unsigned int countBits(unsigned int v)
+{
+	v = v - ((v >> 1) & 0x55555555);
+	v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+	return (((v + (v >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+}
+
+static const unsigned char* readFirstVertex(const unsigned char*& data, const unsigned char* data_end, int version, size_t vertex_size)
+{
+	// the caller checks that the stream has space for the header and at least one vertex
+	assert(size_t(data_end - data) >= vertex_size);
+
+	// version 0 only stores the first vertex at the end of the stream; starting from version 1, it's also stored after the header
+	if (version == 0)
+		return data_end - vertex_size;
+
+	const unsigned char* result = data;
+	data += vertex_size;
+
+	return result;
+}
+
+static const unsigned char* skipBytesGroup(const unsigned char* data, int bitslog2)
+{
+	unsigned int w0, w1;
+
+	switch (bitslog2)
+	{
+	case 0:
+		return data;
+	case 1:
+		memcpy(&w0, data, 4);
+
+		// every 2-bit value equal to 3 is a sentinel that is followed by a full byte in the variable portion
+		return data + 4 + countBits(w0 & (w0 >> 1) & 0x55555555);
+	case 2:
+		memcpy(&w0, data, 4);
+		memcpy(&w1, data + 4, 4);
+
+		// every 4-bit value equal to 15 is a sentinel that is followed by a full byte in the variable portion
+		return data + 8 + countBits(w0 & (w0 >> 1) & (w0 >> 2) & (w0 >> 3) & 0x11111111) + countBits(w1 & (w1 >> 1) & (w1 >> 2) & (w1 >> 3) & 0x11111111);
+	case 3:
+		return data + kByteGroupSize;
+	default:
+		assert(!"Unexpected bit length"); // unreachable since bitslog2 is a 2-bit value
+		return data;
+	}
+}
+
+static const unsigned char* skipBytes(const unsigned char* data, const unsigned char* data_end, size_t buffer_size)
+{
+	assert(buffer_size % kByteGroupSize == 0);
+
+	const unsigned char* header = data;
+
+	// round number of groups to 4 to get number of header bytes
+	size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+
+	if (size_t(data_end - data) < header_size)
+		return 0;
+
+	data += header_size;
+
+	// note: bounds checks must match decodeBytes exactly so that the scan rejects the same inputs as the decoder
+	for (size_t i = 0; i < buffer_size; i += kByteGroupSize)
+	{
+		if (size_t(data_end - data) < kByteGroupDecodeLimit)
+			return 0;
+
+		size_t header_offset = i / kByteGroupSize;
+
+		int bitslog2 = (header[header_offset / 4] >> ((header_offset % 4) * 2)) & 3;
+
+		data = skipBytesGroup(data, bitslog2);
+	}
+
+	return data;
+}
+
+static const unsigned char* skipVertexBlock(const unsigned char* data, const unsigned char* data_end, size_t vertex_count, size_t vertex_size)
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+	for (size_t k = 0; k < vertex_size; ++k)
+	{
+		data = skipBytes(data, data_end, vertex_count_aligned);
+		if (!data)
+			return 0;
+	}
+
+	return data;
+}
+
+static void addVertexBase(unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, const unsigned char* base)
+{
+	assert(vertex_size % 4 == 0);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		unsigned char* vertex = vertex_data + i * vertex_size;
+
+		for (size_t k = 0; k < vertex_size; k += 4)
+		{
+			unsigned int v, b;
+			memcpy(&v, vertex + k, 4);
+			memcpy(&b, base + k, 4);
+
+			// add 4 bytes at a time, making sure carries don't propagate across byte boundaries
+			v = ((v & 0x7f7f7f7f) + (b & 0x7f7f7f7f)) ^ ((v ^ b) & 0x80808080);
+
+			memcpy(vertex + k, &v, 4);
+		}
+	}
+}
+
+static void writeBlockOffset(unsigned char* data, size_t offset)
+{
+	assert(offset <= ~0u);
+
+	data[0] = (unsigned char)(offset >> 0);
+	data[1] = (unsigned char)(offset >> 8);
+	data[2] = (unsigned char)(offset >> 16);
+	data[3] = (unsigned char)(offset >> 24);
+}
+
+static size_t readBlockOffset(const unsigned char* data)
+{
+	return data[0] | (data[1] << 8) | (data[2] << 16) | (size_t(data[3]) << 24);
+}
+
+static const unsigned char* getBlockData(const unsigned char* buffer, const unsigned char* table, size_t block_index)
+{
+	size_t offset = readBlockOffset(table + block_index * kVertexBlockOffsetSize);
+
+	// block data must start after the header and end before the offset table
+	return (offset >= 1 && offset < size_t(table - buffer)) ? buffer + offset : 0;
+}
+
+const size_t kVertexBlocksPerJob = 16;
+
+struct VertexDecodeJobs
+{
+	DecodeVertexBlockFn decode;
+
+	unsigned char* vertex_data;
+	size_t vertex_count;
+	size_t vertex_size;
+	size_t vertex_block_size;
+
+	const unsigned char* buffer;
+	const unsigned char* data_end;
+	const unsigned char* first_vertex;
+
+	int version;
+	const unsigned char* table;
+
+	const unsigned char** job_data;
+	unsigned char* job_base;
+	unsigned char* job_failed;
+};
+
+static void decodeVertexJob(void* job_data, size_t job_index)
+{
+	VertexDecodeJobs& jobs = *static_cast<VertexDecodeJobs*>(job_data);
+
+	size_t vertex_size = jobs.vertex_size;
+	size_t vertex_offset = job_index * kVertexBlocksPerJob * jobs.vertex_block_size;
+	size_t vertex_end = vertex_offset + kVertexBlocksPerJob * jobs.vertex_block_size;
+	vertex_end = vertex_end < jobs.vertex_count ? vertex_end : jobs.vertex_count;
+
+	// the first job starts from the real base vertex; for version 0, others start from zero and are adjusted after all jobs finish
+	unsigned char last_vertex[256] = {};
+	if (job_index == 0)
+		memcpy(last_vertex, jobs.first_vertex, vertex_size);
+
+	const unsigned char* data = jobs.job_data[job_index];
+
+	while (vertex_offset < vertex_end)
+	{
+		size_t block_size = (vertex_offset + jobs.vertex_block_size < vertex_end) ? jobs.vertex_block_size : vertex_end - vertex_offset;
+
+		// starting from version 1, all blocks are encoded relative to the first vertex and the offset table must match block locations
+		if (jobs.version > 0)
+		{
+			if (getBlockData(jobs.buffer, jobs.table, vertex_offset / jobs.vertex_block_size) != data)
+			{
+				jobs.job_failed[job_index] = 3;
+				return;
+			}
+
+			memcpy(last_vertex, jobs.first_vertex, vertex_size);
+		}
+
+		data = jobs.decode(data, jobs.data_end, jobs.vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex, 0);
+		if (!data)
+		{
+			jobs.job_failed[job_index] = 2;
+			return;
+		}
+
+		vertex_offset += block_size;
+	}
+
+	// the last block must end where the offset table starts
+	if (jobs.version > 0 && vertex_end == jobs.vertex_count && data != jobs.table)
+		jobs.job_failed[job_index] = 3;
+}
+
+static void fixupVertexJob(void* job_data, size_t job_index)
+{
+	VertexDecodeJobs& jobs = *static_cast<VertexDecodeJobs*>(job_data);
+
+	// the first job was decoded with the real base vertex
+	if (job_index == 0)
+		return;
+
+	assert(jobs.version == 0);
+
+	size_t vertex_offset = job_index * kVertexBlocksPerJob * jobs.vertex_block_size;
+	size_t vertex_end = vertex_offset + kVertexBlocksPerJob * jobs.vertex_block_size;
+	vertex_end = vertex_end < jobs.vertex_count ? vertex_end : jobs.vertex_count;
+
+	addVertexBase(jobs.vertex_data + vertex_offset * jobs.vertex_size, vertex_end - vertex_offset, jobs.vertex_size, jobs.job_base + job_index * jobs.vertex_size);
+}
+
+// worst case encoded block size, including kByteGroupDecodeLimit bytes of lookahead after the last group; each 16-byte group takes at most 24 bytes in 4-bit mode
+const size_t kVertexBlockMaxEncodedSize = kVertexBlockSizeBytes / kByteGroupSize * 24 + kVertexBlockMaxSize + kByteGroupDecodeLimit;
+
+} // namespace meshopt
+
+struct meshopt_VertexDecoder
+{
+	unsigned char* destination;
+	size_t vertex_count;
+	size_t vertex_size;
+
+	int version;
+	int status;
+
+	// vertices decoded so far, and vertices that are final (for version 0, this only happens once the first vertex arrives at the end of the stream)
+	size_t vertex_decoded;
+	size_t vertex_ready;
+
+	// position of the block scan in pending: byte channel, group within the channel (0 if the group header hasn't been read yet) and offsets of the group header and the next group
+	size_t scan_channel;
+	size_t scan_group;
+	size_t scan_header;
+	size_t scan_offset;
+
+	size_t trailer_size;
+
+	unsigned char first_vertex[256];
+	unsigned char last_vertex[256];
+
+	// the current block always starts at the beginning of pending
+	size_t pending_size;
+	unsigned char pending[meshopt::kVertexBlockMaxEncodedSize];
+};
+
+namespace meshopt
+{
+
+static void keepVertexDecoderTail(meshopt_VertexDecoder* decoder, const unsigned char* data, size_t size)
+{
+	// after all blocks have been decoded, the only thing we need is the last vertex; the rest of the trailer is just counted
+	// note: data may point into pending, so we need to use memmove
+	const size_t capacity = 256;
+
+	decoder->trailer_size += size;
+
+	if (size >= capacity)
+	{
+		memmove(decoder->pending, data + size - capacity, capacity);
+		decoder->pending_size = capacity;
+	}
+	else
+	{
+		size_t keep = decoder->pending_size + size > capacity ? capacity - size : decoder->pending_size;
+
+		memmove(decoder->pending, decoder->pending + decoder->pending_size - keep, keep);
+		memmove(decoder->pending + keep, data, size);
+		decoder->pending_size = keep + size;
+	}
+}
+
+static bool scanVertexDecoderBlock(meshopt_VertexDecoder* decoder, size_t block_size)
+{
+	// the scan resumes where it stopped during the previous feed, so every group is only visited once regardless of chunk sizes
+	// note: bounds checks must match decodeBytes exactly, see skipBytes
+	const unsigned char* pending = decoder->pending;
+	size_t pending_size = decoder->pending_size;
+
+	size_t group_count = (block_size + kByteGroupSize - 1) / kByteGroupSize;
+	size_t header_size = (group_count + 3) / 4;
+
+	while (decoder->scan_channel < decoder->vertex_size)
+	{
+		if (decoder->scan_group == 0)
+		{
+			if (pending_size - decoder->scan_offset < header_size)
+				return false;
+
+			decoder->scan_header = decoder->scan_offset;
+			decoder->scan_offset += header_size;
+			decoder->scan_group = 1;
+		}
+
+		while (decoder->scan_group <= group_count)
+		{
+			if (pending_size - decoder->scan_offset < kByteGroupDecodeLimit)
+				return false;
+
+			size_t group = decoder->scan_group - 1;
+			int bitslog2 = (pending[decoder->scan_header + group / 4] >> ((group % 4) * 2)) & 3;
+
+			decoder->scan_offset = skipBytesGroup(pending + decoder->scan_offset, bitslog2) - pending;
+			decoder->scan_group++;
+		}
+
+		decoder->scan_channel++;
+		decoder->scan_group = 0;
+	}
+
+	return true;
+}
+
+static void consumeVertexDecoder(meshopt_VertexDecoder* decoder)
+{
+	size_t vertex_size = decoder->vertex_size;
+	size_t offset = 0;
+
+	if (decoder->version < 0)
+	{
+		if (decoder->pending_size == 0)
+			return;
+
+		unsigned char data_header = decoder->pending[0];
+
+		if ((data_header & 0xf0) != kVertexHeader || (data_header & 0x0f) > 1)
+		{
+			decoder->status = -1;
+			return;
+		}
+
+		// starting from version 1, the first vertex follows the header, so blocks can be decoded relative to it
+		int version = data_header & 0x0f;
+		size_t prefix_size = version > 0 ? 1 + vertex_size : 1;
+
+		if (decoder->pending_size < prefix_size)
+			return;
+
+		if (version > 0)
+			memcpy(decoder->first_vertex, decoder->pending + 1, vertex_size);
+
+		decoder->version = version;
+
+		// the prefix is dropped right away, so that pending only needs to fit a single block even if the first block is the largest one
+		memmove(decoder->pending, decoder->pending + prefix_size, decoder->pending_size - prefix_size);
+		decoder->pending_size -= prefix_size;
+	}
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+
+	DecodeVertexBlockFn decode = getDecodeVertexBlock();
+
+	while (decoder->vertex_decoded < decoder->vertex_count)
+	{
+		size_t vertex_offset = decoder->vertex_decoded;
+		size_t block_size = (vertex_offset + vertex_block_size < decoder->vertex_count) ? vertex_block_size : decoder->vertex_count - vertex_offset;
+
+		if (!scanVertexDecoderBlock(decoder, block_size))
+			break;
+
+		// version 0 blocks are chained and are decoded relative to zero since the first vertex is stored at the end of the stream
+		if (decoder->version > 0)
+			memcpy(decoder->last_vertex, decoder->first_vertex, vertex_size);
+
+		const unsigned char* data = decode(decoder->pending + offset, decoder->pending + decoder->pending_size, decoder->destination + vertex_offset * vertex_size, block_size, vertex_size, decoder->last_vertex, 0);
+		assert(data == decoder->pending + decoder->scan_offset);
+		(void)data;
+
+		offset = decoder->scan_offset;
+		decoder->scan_channel = 0;
+
+		decoder->vertex_decoded += block_size;
+
+		if (decoder->version > 0)
+			decoder->vertex_ready = decoder->vertex_decoded;
+	}
+
+	if (decoder->vertex_decoded < decoder->vertex_count)
+	{
+		// move the incomplete block to the beginning; the scan position within the block is preserved
+		if (offset)
+		{
+			memmove(decoder->pending, decoder->pending + offset, decoder->pending_size - offset);
+			decoder->pending_size -= offset;
+			decoder->scan_offset -= offset;
+			decoder->scan_header -= offset;
+		}
+	}
+	else
+	{
+		size_t remaining = decoder->pending_size - offset;
+
+		decoder->pending_size = 0;
+		keepVertexDecoderTail(decoder, decoder->pending + offset, remaining);
+	}
+}
+
+} // namespace meshopt
+
+size_t meshopt_encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+
+	const unsigned char* vertex_data = static_cast<const unsigned char*>(vertices);
+
+	unsigned char* data = buffer;
+	unsigned char* data_end = buffer + buffer_size;
+
+	int version = gEncodeVertexVersion;
+
+	if (size_t(data_end - data) < 1 + (version > 0 ? vertex_size : 0) + vertex_size)
+		return 0;
+
+	*data++ = (unsigned char)(kVertexHeader | version);
+
+	unsigned char first_vertex[256] = {};
+	if (vertex_count > 0)
+		memcpy(first_vertex, vertex_data, vertex_size);
+
+	// starting from version 1, the first vertex is also stored before the blocks so that streaming decoders can finalize every block as it arrives
+	if (version > 0)
+	{
+		memcpy(data, first_vertex, vertex_size);
+		data += vertex_size;
+	}
+
+	unsigned char last_vertex[256] = {};
+	memcpy(last_vertex, first_vertex, vertex_size);
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+
+	EncodeVertexBlockFn encode = getEncodeVertexBlock();
+
+#ifdef SIMD_SSSE3
+	assert(gDecodeBytesGroupInitialized && gEncodeBytesGroupInitialized);
+	(void)gDecodeBytesGroupInitialized;
+	(void)gEncodeBytesGroupInitialized;
+#endif
+
+	meshopt_Allocator allocator;
+
+	// starting from version 1, we record the offset of each block so that the decoder can seek to any block
+	size_t* block_offsets = version > 0 ? allocator.allocate<size_t>(vertex_block_count) : 0;
+
+	size_t vertex_offset = 0;
+
+	while (vertex_offset < vertex_count)
+	{
+		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+
+		// starting from version 1, all blocks are encoded relative to the first vertex which makes them independent
+		if (version > 0)
+		{
+			block_offsets[vertex_offset / vertex_block_size] = data - buffer;
+			memcpy(last_vertex, first_vertex, vertex_size);
+		}
+
+		data = encode(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
+		if (!data)
+			return 0;
+
+		vertex_offset += block_size;
+	}
+
+	if (version > 0)
+	{
+		if (size_t(data_end - data) < vertex_block_count * kVertexBlockOffsetSize)
+			return 0;
+
+		for (size_t i = 0; i < vertex_block_count; ++i)
+		{
+			writeBlockOffset(data, block_offsets[i]);
+			data += kVertexBlockOffsetSize;
+		}
+	}
+
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	if (size_t(data_end - data) < tail_size)
+		return 0;
+
+	// write first vertex to the end of the stream and pad it to 32 bytes; this is important to simplify bounds checks in decoder
+	if (vertex_size < kTailMaxSize)
+	{
+		memset(data, 0, kTailMaxSize - vertex_size);
+		data += kTailMaxSize - vertex_size;
+	}
+
+	memcpy(data, first_vertex, vertex_size);
+	data += vertex_size;
+
+	assert(data >= buffer + tail_size);
+	assert(data <= buffer + buffer_size);
+
+	return data - buffer;
+}
+
+size_t meshopt_encodeVertexBufferBound(size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+
+	size_t vertex_block_header_size = (vertex_block_size / kByteGroupSize + 3) / 4;
+	size_t vertex_block_data_size = vertex_block_size;
+
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	// note: the bound includes space for the first vertex and the block offset table that are written starting from version 1
+	return 1 + vertex_size + vertex_block_count * vertex_size * (vertex_block_header_size + vertex_block_data_size) + vertex_block_count * kVertexBlockOffsetSize + tail_size;
+}
+
+void meshopt_encodeVertexVersion(int version)
+{
+	assert(unsigned(version) <= 1);
+
+	meshopt::gEncodeVertexVersion = version;
+}
+
+int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size)
+{
+	return meshopt_decodeVertexBufferFiltered(destination, vertex_count, vertex_size, buffer, buffer_size, 0);
+}
+
+int meshopt_decodeVertexBufferFiltered(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size, meshopt_FilterCallback filter)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+
+	DecodeVertexBlockFn decode = getDecodeVertexBlock();
+
+#if defined(SIMD_SSSE3) || defined(SIMD_NEON) || defined(SIMD_WASM)
+	assert(gDecodeBytesGroupInitialized);
+	(void)gDecodeBytesGroupInitialized;
+#endif
+
+	unsigned char* vertex_data = static_cast<unsigned char*>(destination);
+
+	const unsigned char* data = buffer;
+	const unsigned char* data_end = buffer + buffer_size;
+
+	if (size_t(data_end - data) < 1 + vertex_size)
+		return -2;
+
+	unsigned char data_header = *data++;
+
+	if ((data_header & 0xf0) != kVertexHeader)
+		return -1;
+
+	int version = data_header & 0x0f;
+	if (version > 1)
+		return -1;
+
+	const unsigned char* first_vertex = readFirstVertex(data, data_end, version, vertex_size);
+
+	unsigned char last_vertex[256];
+	memcpy(last_vertex, first_vertex, vertex_size);
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+	size_t table_size = version > 0 ? vertex_block_count * kVertexBlockOffsetSize : 0;
+
+	if (size_t(data_end - data) < table_size + tail_size)
+		return -2;
+
+	const unsigned char* table = data_end - tail_size - table_size;
+
+	size_t vertex_offset = 0;
+
+	while (vertex_offset < vertex_count)
+	{
+		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+
+		// starting from version 1, all blocks are encoded relative to the first vertex and the offset table must match block locations
+		if (version > 0)
+		{
+			if (getBlockData(buffer, table, vertex_offset / vertex_block_size) != data)
+				return -3;
+
+			memcpy(last_vertex, first_vertex, vertex_size);
+		}
+
+		data = decode(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex, filter);
+		if (!data)
+			return -2;
+
+		vertex_offset += block_size;
+	}
+
+	if (size_t(data_end - data) != table_size + tail_size)
+		return -3;
+
+	return 0;
+}
+
+int meshopt_decodeVertexBufferParallel(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size, meshopt_DispatchCallback dispatch, void* context)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+	size_t job_count = (vertex_block_count + kVertexBlocksPerJob - 1) / kVertexBlocksPerJob;
+
+	// small buffers don't benefit from splitting the work so we skip the scan
+	if (job_count <= 1)
+		return meshopt_decodeVertexBuffer(destination, vertex_count, vertex_size, buffer, buffer_size);
+
+#if defined(SIMD_SSSE3) || defined(SIMD_NEON) || defined(SIMD_WASM)
+	assert(gDecodeBytesGroupInitialized);
+	(void)gDecodeBytesGroupInitialized;
+#endif
+
+	const unsigned char* data = buffer;
+	const unsigned char* data_end = buffer + buffer_size;
+
+	if (size_t(data_end - data) < 1 + vertex_size)
+		return -2;
+
+	unsigned char data_header = *data++;
+
+	if ((data_header & 0xf0) != kVertexHeader)
+		return -1;
+
+	int version = data_header & 0x0f;
+	if (version > 1)
+		return -1;
+
+	const unsigned char* first_vertex = readFirstVertex(data, data_end, version, vertex_size);
+
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+	size_t table_size = version > 0 ? vertex_block_count * kVertexBlockOffsetSize : 0;
+
+	if (size_t(data_end - data) < table_size + tail_size)
+		return -2;
+
+	const unsigned char* table = data_end - tail_size - table_size;
+
+	meshopt_Allocator allocator;
+
+	const unsigned char** job_data = allocator.allocate<const unsigned char*>(job_count);
+
+	if (version > 0)
+	{
+		// block offset table gives us the location of every block; jobs validate that the offsets match the actual block sizes
+		for (size_t i = 0; i < job_count; ++i)
+			if ((job_data[i] = getBlockData(buffer, table, i * kVertexBlocksPerJob)) == 0)
+				return -3;
+	}
+	else
+	{
+		// locate the first block of every job; this only reads group headers and sentinel bits, which is much faster than decoding
+		size_t vertex_offset = 0;
+
+		while (vertex_offset < vertex_count)
+		{
+			size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+
+			if (vertex_offset % (kVertexBlocksPerJob * vertex_block_size) == 0)
+				job_data[vertex_offset / (kVertexBlocksPerJob * vertex_block_size)] = data;
+
+			data = skipVertexBlock(data, data_end, block_size, vertex_size);
+			if (!data)
+				return -2;
+
+			vertex_offset += block_size;
+		}
+
+		if (size_t(data_end - data) != tail_size)
+			return -3;
+	}
+
+	unsigned char* job_base = allocator.allocate<unsigned char>(job_count * vertex_size);
+
+	unsigned char* job_failed = allocator.allocate<unsigned char>(job_count);
+	memset(job_failed, 0, job_count);
+
+	VertexDecodeJobs jobs = {};
+	jobs.decode = getDecodeVertexBlock();
+	jobs.vertex_data = static_cast<unsigned char*>(destination);
+	jobs.vertex_count = vertex_count;
+	jobs.vertex_size = vertex_size;
+	jobs.vertex_block_size = vertex_block_size;
+	jobs.buffer = buffer;
+	jobs.data_end = data_end;
+	jobs.first_vertex = first_vertex;
+	jobs.version = version;
+	jobs.table = table;
+	jobs.job_data = job_data;
+	jobs.job_base = job_base;
+	jobs.job_failed = job_failed;
+
+	dispatchJobs(dispatch, context, decodeVertexJob, &jobs, job_count);
+
+	for (size_t i = 0; i < job_count; ++i)
+		if (job_failed[i])
+			return -int(job_failed[i]);
+
+	// starting from version 1, blocks don't depend on each other so the jobs produce final results
+	if (version > 0)
+		return 0;
+
+	// jobs other than the first one were decoded relative to a zero vertex; the real base of each job is the last vertex of the previous job
+	memset(job_base, 0, vertex_size);
+
+	for (size_t i = 1; i < job_count; ++i)
+	{
+		const unsigned char* last_vertex = jobs.vertex_data + (i * kVertexBlocksPerJob * vertex_block_size - 1) * vertex_size;
+
+		memcpy(job_base + i * vertex_size, last_vertex, vertex_size);
+		addVertexBase(job_base + i * vertex_size, 1, vertex_size, job_base + (i - 1) * vertex_size);
+	}
+
+	dispatchJobs(dispatch, context, fixupVertexJob, &jobs, job_count);
+
+	return 0;
+}
+
+int meshopt_decodeVertexBufferRange(void* destination, size_t first_vertex, size_t count, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+	assert(first_vertex + count <= vertex_count);
+
+	DecodeVertexBlockFn decode = getDecodeVertexBlock();
+
+#if defined(SIMD_SSSE3) || defined(SIMD_NEON) || defined(SIMD_WASM)
+	assert(gDecodeBytesGroupInitialized);
+	(void)gDecodeBytesGroupInitialized;
+#endif
+
+	unsigned char* vertex_data = static_cast<unsigned char*>(destination);
+
+	const unsigned char* data = buffer;
+	const unsigned char* data_end = buffer + buffer_size;
+
+	if (size_t(data_end - data) < 1 + vertex_size)
+		return -2;
+
+	unsigned char data_header = *data++;
+
+	if ((data_header & 0xf0) != kVertexHeader)
+		return -1;
+
+	int version = data_header & 0x0f;
+	if (version > 1)
+		return -1;
+
+	if (count == 0)
+		return 0;
+
+	const unsigned char* base_vertex = readFirstVertex(data, data_end, version, vertex_size);
+
+	unsigned char last_vertex[256];
+	memcpy(last_vertex, base_vertex, vertex_size);
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+	size_t table_size = version > 0 ? vertex_block_count * kVertexBlockOffsetSize : 0;
+
+	if (size_t(data_end - data) < table_size + tail_size)
+		return -2;
+
+	size_t block_begin = first_vertex / vertex_block_size;
+	size_t block_end = (first_vertex + count + vertex_block_size - 1) / vertex_block_size;
+
+	// partial blocks are decoded into a scratch buffer first since decoding always produces the entire block
+	unsigned char scratch[kVertexBlockSizeBytes];
+
+	if (version > 0)
+	{
+		data = getBlockData(buffer, data_end - tail_size - table_size, block_begin);
+		if (!data)
+			return -2;
+	}
+	else
+	{
+		// blocks are chained in version 0, so we need to decode all blocks before the range to establish the base vertex
+		for (size_t i = 0; i < block_begin; ++i)
+		{
+			data = decode(data, data_end, scratch, vertex_block_size, vertex_size, last_vertex, 0);
+			if (!data)
+				return -2;
+		}
+	}
+
+	for (size_t i = block_begin; i < block_end; ++i)
+	{
+		size_t vertex_offset = i * vertex_block_size;
+		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+
+		// starting from version 1, all blocks are encoded relative to the first vertex
+		if (version > 0)
+			memcpy(last_vertex, base_vertex, vertex_size);
+
+		size_t range_begin = vertex_offset < first_vertex ? first_vertex : vertex_offset;
+		size_t range_end = vertex_offset + block_size < first_vertex + count ? vertex_offset + block_size : first_vertex + count;
+
+		if (range_begin == vertex_offset && range_end == vertex_offset + block_size)
+		{
+			data = decode(data, data_end, vertex_data + (vertex_offset - first_vertex) * vertex_size, block_size, vertex_size, last_vertex, 0);
+			if (!data)
+				return -2;
+		}
+		else
+		{
+			data = decode(data, data_end, scratch, block_size, vertex_size, last_vertex, 0);
+			if (!data)
+				return -2;
+
+			memcpy(vertex_data + (range_begin - first_vertex) * vertex_size, scratch + (range_begin - vertex_offset) * vertex_size, (range_end - range_begin) * vertex_size);
+		}
+	}
+
+	return 0;
+}
+
+meshopt_VertexDecoder* meshopt_createVertexDecoder(void* destination, size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+
+	meshopt_VertexDecoder* decoder = static_cast<meshopt_VertexDecoder*>(meshopt_Allocator::Storage::allocate(sizeof(meshopt_VertexDecoder)));
+	memset(decoder, 0, sizeof(meshopt_VertexDecoder));
+
+	decoder->destination = static_cast<unsigned char*>(destination);
+	decoder->vertex_count = vertex_count;
+	decoder->vertex_size = vertex_size;
+	decoder->version = -1;
+
+	return decoder;
+}
+
+int meshopt_feedVertexDecoder(meshopt_VertexDecoder* decoder, const unsigned char* data, size_t size)
+{
+	using namespace meshopt;
+
+	assert(decoder);
+
+#if defined(SIMD_SSSE3) || defined(SIMD_NEON) || defined(SIMD_WASM)
+	assert(gDecodeBytesGroupInitialized);
+	(void)gDecodeBytesGroupInitialized;
+#endif
+
+	while (size > 0 && decoder->status == 0)
+	{
+		// once all blocks are decoded, the remaining data doesn't need to be buffered
+		if (decoder->version >= 0 && decoder->vertex_decoded == decoder->vertex_count)
+		{
+			keepVertexDecoderTail(decoder, data, size);
+			break;
+		}
+
+		size_t copy = sizeof(decoder->pending) - decoder->pending_size;
+		copy = copy < size ? copy : size;
+
+		// the scratch space fits any valid block, so if it's full and the block is still incomplete, the input is malformed
+		if (copy == 0)
+		{
+			decoder->status = -2;
+			break;
+		}
+
+		memcpy(decoder->pending + decoder->pending_size, data, copy);
+		decoder->pending_size += copy;
+		data += copy;
+		size -= copy;
+
+		consumeVertexDecoder(decoder);
+	}
+
+	return decoder->status;
+}
+
+size_t meshopt_getVertexDecoderReady(const meshopt_VertexDecoder* decoder)
+{
+	assert(decoder);
+
+	return decoder->vertex_ready;
+}
+
+int meshopt_finishVertexDecoder(meshopt_VertexDecoder* decoder)
+{
+	using namespace meshopt;
+
+	assert(decoder);
+
+	if (decoder->status)
+		return decoder->status;
+
+	if (decoder->version < 0 || decoder->vertex_decoded < decoder->vertex_count)
+		return -2;
+
+	size_t vertex_size = decoder->vertex_size;
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (decoder->vertex_count + vertex_block_size - 1) / vertex_block_size;
+
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+	size_t table_size = decoder->version > 0 ? vertex_block_count * kVertexBlockOffsetSize : 0;
+
+	if (decoder->trailer_size < table_size + tail_size)
+		return -2;
+
+	if (decoder->trailer_size != table_size + tail_size)
+		return -3;
+
+	// version 0 blocks were decoded relative to zero, so the first vertex from the end of the stream needs to be added to all of them
+	if (decoder->version == 0 && decoder->vertex_ready < decoder->vertex_count)
+	{
+		assert(decoder->pending_size >= vertex_size);
+		const unsigned char* first_vertex = decoder->pending + decoder->pending_size - vertex_size;
+
+		addVertexBase(decoder->destination, decoder->vertex_count, vertex_size, first_vertex);
+	}
+
+	decoder->vertex_ready = decoder->vertex_count;
+
+	return 0;
+}
+
+void meshopt_destroyVertexDecoder(meshopt_VertexDecoder* decoder)
+{
+	if (!decoder)
+		return;
+
+	meshopt_Allocator::Storage::deallocate(decoder);
+}
+
+int meshopt_getSimdLevel()
+{
+	return meshopt::gSimdLevel;
+}
+
+#undef SIMD_TARGET_ATTRIBUTE
+#undef SIMD_SSE
 #undef SIMD_FALLBACK
 #undef SIMD_TARGET
+#undef SIMD_SSSE3
+#undef SIMD_FALLBACK_SSSE3
+#undef SIMD_TARGET_SSSE3
+#undef SIMD_NEON
+#undef SIMD_WASM
+#undef SIMD_AVX2
+#undef SIMD_AVX
+#undef SIMD_TARGET_AVX2
+#undef SIMD_TARGET_AVX512
@@ -4,38 +4,9 @@
 #include <math.h>
 #include <string.h>
 
-// The block below auto-detects SIMD ISA that can be used on the target platform
-#ifndef MESHOPTIMIZER_NO_SIMD
-
-// The SIMD implementation requires SSE2, which can be enabled unconditionally through compiler settings
-#if defined(__SSE2__)
-#define SIMD_SSE
-#endif
-
-// MSVC supports compiling SSE2 code regardless of compile options; we assume all 32-bit CPUs support SSE2
-#if !defined(SIMD_SSE) && defined(_MSC_VER) && !defined(__clang__) && (defined(_M_IX86) || defined(_M_X64))
-#define SIMD_SSE
-#endif
-
-// GCC/clang define these when NEON support is available
-#if defined(__ARM_NEON__) || defined(__ARM_NEON)
-#define SIMD_NEON
-#endif
-
-// On MSVC, we assume that ARM builds always target NEON-capable devices
-#if !defined(SIMD_NEON) && defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
-#define SIMD_NEON
-#endif
-
-// When targeting Wasm SIMD we can't use runtime cpuid checks so we unconditionally enable SIMD
-#if defined(__wasm_simd128__)
-#define SIMD_WASM
-#endif
-
-#endif // !MESHOPTIMIZER_NO_SIMD
+#include "simd.h"
 
 #ifdef SIMD_SSE
-#include <emmintrin.h>
 #include <stdint.h>
 #endif
 
@@ -43,18 +14,6 @@
 #include <intrin.h>
 #endif
 
-#ifdef SIMD_NEON
-#if defined(_MSC_VER) && defined(_M_ARM64)
-#include <arm64_neon.h>
-#else
-#include <arm_neon.h>
-#endif
-#endif
-
-#ifdef SIMD_WASM
-#include <wasm_simd128.h>
-#endif
-
 #ifdef SIMD_WASM
 #define wasmx_unpacklo_v16x8(a, b) wasm_v16x8_shuffle(a, b, 0, 8, 1, 9, 2, 10, 3, 11)
 #define wasmx_unpackhi_v16x8(a, b) wasm_v16x8_shuffle(a, b, 4, 12, 5, 13, 6, 14, 7, 15)
@@ -65,7 +24,7 @@
 namespace meshopt
 {
 
-#if !defined(SIMD_SSE) && !defined(SIMD_NEON) && !defined(SIMD_WASM)
+#if defined(SIMD_FALLBACK) || (!defined(SIMD_SSE) && !defined(SIMD_NEON) && !defined(SIMD_WASM))
 template <typename T>
 static void decodeFilterOct(T* data, size_t count)
 {
@@ -194,6 +153,7 @@ inline uint64_t rotateleft64(uint64_t v, int x)
 #endif
 
 #ifdef SIMD_SSE
+SIMD_TARGET
 static void decodeFilterOctSimd(signed char* data, size_t count)
 {
 	const __m128 sign = _mm_set1_ps(-0.f);
@@ -239,6 +199,7 @@ static void decodeFilterOctSimd(signed char* data, size_t count)
 	}
 }
 
+SIMD_TARGET
 static void decodeFilterOctSimd(short* data, size_t count)
 {
 	const __m128 sign = _mm_set1_ps(-0.f);
@@ -296,6 +257,7 @@ static void decodeFilterOctSimd(short* data, size_t count)
 	}
 }
 
+SIMD_TARGET
 static void decodeFilterQuatSimd(short* data, size_t count)
 {
 	const float scale = 1.f / sqrtf(2.f);
@@ -359,6 +321,7 @@ static void decodeFilterQuatSimd(short* data, size_t count)
 	}
 }
 
+SIMD_TARGET
 static void decodeFilterExpSimd(unsigned int* data, size_t count)
 {
 	for (size_t i = 0; i < count; i += 4)
@@ -797,7 +760,22 @@ void meshopt_decodeFilterOct(void* buffer, size_t vertex_count, size_t vertex_si
 
 	assert(vertex_size == 4 || vertex_size == 8);
 
-#if defined(SIMD_SSE) || defined(SIMD_NEON) || defined(SIMD_WASM)
+#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
+	if (meshopt_getSimdLevel() >= meshopt_SimdBaseline)
+	{
+		if (vertex_size == 4)
+			dispatchSimd(decodeFilterOctSimd, static_cast<signed char*>(buffer), vertex_count, 4);
+		else
+			dispatchSimd(decodeFilterOctSimd, static_cast<short*>(buffer), vertex_count, 4);
+	}
+	else
+	{
+		if (vertex_size == 4)
+			decodeFilterOct(static_cast<signed char*>(buffer), vertex_count);
+		else
+			decodeFilterOct(static_cast<short*>(buffer), vertex_count);
+	}
+#elif defined(SIMD_SSE) || defined(SIMD_NEON) || defined(SIMD_WASM)
 	if (vertex_size == 4)
 		dispatchSimd(decodeFilterOctSimd, static_cast<signed char*>(buffer), vertex_count, 4);
 	else
@@ -817,7 +795,12 @@ void meshopt_decodeFilterQuat(void* buffer, size_t vertex_count, size_t vertex_s
 	assert(vertex_size == 8);
 	(void)vertex_size;
 
-#if defined(SIMD_SSE) || defined(SIMD_NEON) || defined(SIMD_WASM)
+#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
+	if (meshopt_getSimdLevel() >= meshopt_SimdBaseline)
+		dispatchSimd(decodeFilterQuatSimd, static_cast<short*>(buffer), vertex_count, 4);
+	else
+		decodeFilterQuat(static_cast<short*>(buffer), vertex_count);
+#elif defined(SIMD_SSE) || defined(SIMD_NEON) || defined(SIMD_WASM)
 	dispatchSimd(decodeFilterQuatSimd, static_cast<short*>(buffer), vertex_count, 4);
 #else
 	decodeFilterQuat(static_cast<short*>(buffer), vertex_count);
@@ -830,13 +813,28 @@ void meshopt_decodeFilterExp(void* buffer, size_t vertex_count, size_t vertex_si
 
 	assert(vertex_size % 4 == 0);
 
-#if defined(SIMD_SSE) || defined(SIMD_NEON) || defined(SIMD_WASM)
+#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
+	if (meshopt_getSimdLevel() >= meshopt_SimdBaseline)
+		dispatchSimd(decodeFilterExpSimd, static_cast<unsigned int*>(buffer), vertex_count * (vertex_size / 4), 1);
+	else
+		decodeFilterExp(static_cast<unsigned int*>(buffer), vertex_count * (vertex_size / 4));
+#elif defined(SIMD_SSE) || defined(SIMD_NEON) || defined(SIMD_WASM)
 	dispatchSimd(decodeFilterExpSimd, static_cast<unsigned int*>(buffer), vertex_count * (vertex_size / 4), 1);
 #else
 	decodeFilterExp(static_cast<unsigned int*>(buffer), vertex_count * (vertex_size / 4));
 #endif
 }
 
+#undef SIMD_TARGET_ATTRIBUTE
 #undef SIMD_SSE
+#undef SIMD_FALLBACK
+#undef SIMD_TARGET
+#undef SIMD_SSSE3
+#undef SIMD_FALLBACK_SSSE3
+#undef SIMD_TARGET_SSSE3
 #undef SIMD_NEON
 #undef SIMD_WASM
+#undef SIMD_AVX2
+#undef SIMD_AVX
+#undef SIMD_TARGET_AVX2
+#undef SIMD_TARGET_AVX512
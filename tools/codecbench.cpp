@@ -43,6 +43,11 @@ struct Vertex
 	uint16_t data[16];
 };
 
+namespace meshopt
+{
+extern int gSimdLevel;
+}
+
 uint32_t murmur3(uint32_t h)
 {
 	h ^= h >> 16;
@@ -54,7 +59,7 @@ uint32_t murmur3(uint32_t h)
 	return h;
 }
 
-void benchCodecs(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, double& bestvd, double& bestid, bool verbose)
+void benchCodecs(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, double& bestvd, double& bestid, double& bestve, bool verbose)
 {
 	std::vector<Vertex> vb(vertices.size());
 	std::vector<unsigned int> ib(indices.size());
@@ -83,8 +88,16 @@ void benchCodecs(const std::vector<Vertex>& vertices, const std::vector<unsigned
 		if (verbose)
 			printf("pass %d: vertex data %d bytes, index data %d bytes\n", pass, int(vc.size()), int(ic.size()));
 
+		std::vector<unsigned char> vce(vc.capacity());
+
 		for (int attempt = 0; attempt < 10; ++attempt)
 		{
+			double te = timestamp();
+
+			size_t rs = meshopt_encodeVertexBuffer(&vce[0], vce.size(), &vb[0], vertices.size(), sizeof(Vertex));
+			assert(rs == vc.size());
+			(void)rs;
+
 			double t0 = timestamp();
 
 			int rv = meshopt_decodeVertexBuffer(&vb[0], vertices.size(), sizeof(Vertex), &vc[0], vc.size());
@@ -101,6 +114,10 @@ void benchCodecs(const std::vector<Vertex>& vertices, const std::vector<unsigned
 
 			double GB = 1024 * 1024 * 1024;
 
+			if (verbose)
+				printf("encode: vertex %.2f ms (%.2f GB/sec)\n",
+				       (t0 - te) * 1000, double(vertices.size() * sizeof(Vertex)) / GB / (t0 - te));
+
 			if (verbose)
 				printf("decode: vertex %.2f ms (%.2f GB/sec), index %.2f ms (%.2f GB/sec)\n",
 				       (t1 - t0) * 1000, double(vertices.size() * sizeof(Vertex)) / GB / (t1 - t0),
@@ -110,6 +127,7 @@ void benchCodecs(const std::vector<Vertex>& vertices, const std::vector<unsigned
 			{
 				bestvd = std::max(bestvd, double(vertices.size() * sizeof(Vertex)) / GB / (t1 - t0));
 				bestid = std::max(bestid, double(indices.size() * 4) / GB / (t2 - t1));
+				bestve = std::max(bestve, double(vertices.size() * sizeof(Vertex)) / GB / (t0 - te));
 			}
 		}
 	}
@@ -212,13 +230,30 @@ int main(int argc, char** argv)
 		}
 	}
 
-	double bestvd = 0, bestid = 0;
-	benchCodecs(vertices, indices, bestvd, bestid, verbose);
+	double bestvd = 0, bestid = 0, bestve = 0;
+	benchCodecs(vertices, indices, bestvd, bestid, bestve, verbose);
+
+	// vertex decoder picks AVX2/AVX512 kernels at runtime; rerun the decoder with SSSE3 level to measure the gain
+	int level = meshopt::gSimdLevel;
+	double bestvd128 = 0;
+
+	if (level > meshopt_SimdSSSE3)
+	{
+		meshopt::gSimdLevel = meshopt_SimdSSSE3;
+
+		double bestid128 = 0, bestve128 = 0;
+		benchCodecs(vertices, indices, bestvd128, bestid128, bestve128, verbose);
+
+		meshopt::gSimdLevel = level;
+	}
 
 	double besto8 = 0, besto12 = 0, bestq12 = 0, bestexp = 0;
 	benchFilters(8 * N * N, besto8, besto12, bestq12, bestexp, verbose);
 
-	printf("Algorithm   :\tvtx\tidx\toct8\toct12\tquat12\texp\n");
-	printf("Score (GB/s):\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\n",
-	       bestvd, bestid, besto8, besto12, bestq12, bestexp);
+	printf("Algorithm   :\tvtx\tidx\toct8\toct12\tquat12\texp\tvtxenc\n");
+	printf("Score (GB/s):\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\n",
+	       bestvd, bestid, besto8, besto12, bestq12, bestexp, bestve);
+
+	if (bestvd128 > 0)
+		printf("SIMD %d vtx  :\t%.2f GB/s vs %.2f GB/s SSSE3 (%.2fx)\n", level, bestvd, bestvd128, bestvd / bestvd128);
 }
@@ -16,9 +16,23 @@ void fuzzDecoder(const uint8_t* data, size_t size, size_t stride, int (*decode)(
 	free(destination);
 }
 
+int decodeMeshlet(void* destination, size_t count, size_t stride, const unsigned char* buffer, size_t buffer_size)
+{
+	// destination has enough space for count/2 vertex references followed by count/3 triangles
+	size_t vertex_count = count / 2;
+	size_t triangle_count = count / 3;
+
+	assert(stride == 4 && vertex_count * 4 + triangle_count * 3 <= count * stride);
+	(void)stride;
+
+	unsigned char* triangles = static_cast<unsigned char*>(destination) + vertex_count * 4;
+
+	return meshopt_decodeMeshlet(static_cast<unsigned int*>(destination), vertex_count, triangles, triangle_count, buffer, buffer_size);
+}
+
 namespace meshopt
 {
-extern unsigned int cpuid;
+extern int gSimdLevel;
 }
 
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
@@ -38,18 +52,23 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
 	fuzzDecoder(data, size, 24, meshopt_decodeVertexBuffer);
 	fuzzDecoder(data, size, 32, meshopt_decodeVertexBuffer);
 
-#if !(defined(__AVX__) || defined(__SSSE3__)) && (defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__))
-	// When SSSE3/AVX support isn't enabled unconditionally, we use a cpuid-based fallback
-	// It's useful to be able to test scalar code in this case, so we temporarily fake the feature bits
-	// and restore them later
-	unsigned int cpuid = meshopt::cpuid;
-	meshopt::cpuid = 0;
+	fuzzDecoder(data, size, 4, decodeMeshlet);
 
-	// Note that scalar code doesn't have odd edge conditions around 16b vertices so we could just test it for one stride
-	fuzzDecoder(data, size, 4, meshopt_decodeVertexBuffer);
+	// SIMD kernels are selected at runtime based on the SIMD level detected from cpuid
+	// It's useful to be able to test all kernels supported by the hardware, so we temporarily lower the level
+	// and restore it later
+	int level = meshopt::gSimdLevel;
+
+	for (int i = level - 1; i >= 0; --i)
+	{
+		meshopt::gSimdLevel = i;
+
+		fuzzDecoder(data, size, 4, meshopt_decodeVertexBuffer);
+		fuzzDecoder(data, size, 16, meshopt_decodeVertexBuffer);
+		fuzzDecoder(data, size, 4, decodeMeshlet);
+	}
 
-	meshopt::cpuid = cpuid;
-#endif
+	meshopt::gSimdLevel = level;
 
 	return 0;
 }
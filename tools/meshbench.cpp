@@ -0,0 +1,1192 @@
+#include "../src/meshoptimizer.h"
+#include "../extern/fast_obj.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+struct LARGE_INTEGER
+{
+	__int64 QuadPart;
+};
+extern "C" __declspec(dllimport) int __stdcall QueryPerformanceCounter(LARGE_INTEGER* lpPerformanceCount);
+extern "C" __declspec(dllimport) int __stdcall QueryPerformanceFrequency(LARGE_INTEGER* lpFrequency);
+
+double timestamp()
+{
+	LARGE_INTEGER freq, counter;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&counter);
+	return double(counter.QuadPart) / double(freq.QuadPart);
+}
+#else
+double timestamp()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return double(ts.tv_sec) + 1e-9 * double(ts.tv_nsec);
+}
+#endif
+
+struct Vertex
+{
+	float px, py, pz;
+	float nx, ny, nz;
+	float tx, ty;
+};
+
+struct Mesh
+{
+	std::string name;
+
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+};
+
+// allocation tracking; every block is prefixed with its size so that deallocation can update the live total
+static size_t gAllocatedBytes = 0;
+static size_t gPeakBytes = 0;
+
+static void* trackAllocate(size_t size)
+{
+	size_t* ptr = static_cast<size_t*>(malloc(size + 16));
+	if (!ptr)
+		return NULL;
+
+	*ptr = size;
+
+	gAllocatedBytes += size;
+	gPeakBytes = std::max(gPeakBytes, gAllocatedBytes);
+
+	return reinterpret_cast<char*>(ptr) + 16;
+}
+
+static void trackDeallocate(void* ptr)
+{
+	size_t* base = reinterpret_cast<size_t*>(static_cast<char*>(ptr) - 16);
+
+	gAllocatedBytes -= *base;
+
+	free(base);
+}
+
+static bool loadObj(Mesh& result, const char* path)
+{
+	fastObjMesh* obj = fast_obj_read(path);
+	if (!obj)
+		return false;
+
+	size_t total_indices = 0;
+
+	for (unsigned int i = 0; i < obj->face_count; ++i)
+		total_indices += 3 * (obj->face_vertices[i] - 2);
+
+	std::vector<Vertex> vertices(total_indices);
+
+	size_t vertex_offset = 0;
+	size_t index_offset = 0;
+
+	for (unsigned int i = 0; i < obj->face_count; ++i)
+	{
+		for (unsigned int j = 0; j < obj->face_vertices[i]; ++j)
+		{
+			fastObjIndex gi = obj->indices[index_offset + j];
+
+			Vertex v =
+			    {
+			        obj->positions[gi.p * 3 + 0],
+			        obj->positions[gi.p * 3 + 1],
+			        obj->positions[gi.p * 3 + 2],
+			        obj->normals[gi.n * 3 + 0],
+			        obj->normals[gi.n * 3 + 1],
+			        obj->normals[gi.n * 3 + 2],
+			        obj->texcoords[gi.t * 2 + 0],
+			        obj->texcoords[gi.t * 2 + 1],
+			    };
+
+			// triangulate polygon on the fly; offset-3 is always the first polygon vertex
+			if (j >= 3)
+			{
+				vertices[vertex_offset + 0] = vertices[vertex_offset - 3];
+				vertices[vertex_offset + 1] = vertices[vertex_offset - 1];
+				vertex_offset += 2;
+			}
+
+			vertices[vertex_offset] = v;
+			vertex_offset++;
+		}
+
+		index_offset += obj->face_vertices[i];
+	}
+
+	fast_obj_destroy(obj);
+
+	if (total_indices == 0)
+		return false;
+
+	std::vector<unsigned int> remap(total_indices);
+
+	size_t total_vertices = meshopt_generateVertexRemap(&remap[0], NULL, total_indices, &vertices[0], total_indices, sizeof(Vertex));
+
+	result.name = path;
+
+	result.indices.resize(total_indices);
+	meshopt_remapIndexBuffer(&result.indices[0], NULL, total_indices, &remap[0]);
+
+	result.vertices.resize(total_vertices);
+	meshopt_remapVertexBuffer(&result.vertices[0], &vertices[0], total_indices, sizeof(Vertex), &remap[0]);
+
+	return true;
+}
+
+// all inputs and scratch buffers are prepared once per mesh so that the timed region only contains the library call
+struct Context
+{
+	const Mesh* mesh;
+
+	std::vector<Vertex> unindexed;
+	std::vector<unsigned int> optimized; // vertex cache + fetch optimized indices
+	std::vector<Vertex> optimized_vertices;
+	std::vector<unsigned int> strip;
+
+	std::vector<unsigned int> ib;
+	std::vector<unsigned int> remap;
+	std::vector<Vertex> vb;
+	meshopt_Stream streams[3]; // position, normal and texture coordinate streams of the mesh vertices
+
+	std::vector<unsigned int> simplified; // result of meshopt_simplify for the Hausdorff distance
+	std::vector<size_t> lod_index_counts;
+	meshopt_SimplifierContext* simplifier;
+
+	std::vector<meshopt_Meshlet> meshlets;
+	size_t meshlet_count;
+	std::vector<unsigned int> meshlet_vertices;
+	std::vector<unsigned char> meshlet_triangles;
+	std::vector<meshopt_Bounds> bounds;
+
+	std::vector<meshopt_LodCluster> clusters;
+	std::vector<unsigned int> cluster_vertices;
+	std::vector<unsigned char> cluster_triangles;
+
+	std::vector<unsigned char> vbuf, ibuf, sbuf; // encoded vertex/index/index sequence data
+	std::vector<unsigned char> vbuf1, ibuf2, obuf; // encoded vertex data (version 1), index data (version 2) and octahedral filter data
+	std::vector<unsigned char> mbuf; // encoded meshlet data
+	std::vector<size_t> mbuf_offsets;
+	std::vector<unsigned char> scratch;
+	std::vector<unsigned short> filter_oct, filter_quat;
+	std::vector<unsigned int> filter_exp;
+	std::vector<unsigned short> filter_out;
+
+	std::vector<unsigned short> quantized;
+	std::vector<float> quantized_float;
+};
+
+enum Unit
+{
+	Unit_Triangles,
+	Unit_Vertices,
+	Unit_Bytes,
+};
+
+typedef void (*BenchFunction)(Context& ctx);
+
+struct Benchmark
+{
+	const char* name;
+	BenchFunction function;
+	Unit unit;
+};
+
+static size_t getWork(const Context& ctx, Unit unit)
+{
+	switch (unit)
+	{
+	case Unit_Triangles:
+		return ctx.mesh->indices.size() / 3;
+	case Unit_Vertices:
+		return ctx.mesh->vertices.size();
+	case Unit_Bytes:
+		return ctx.mesh->vertices.size() * sizeof(Vertex);
+	default:
+		return 0;
+	}
+}
+
+static const char* getUnitName(Unit unit)
+{
+	return unit == Unit_Bytes ? "MB/s" : unit == Unit_Vertices ? "Mvtx/s" : "Mtri/s";
+}
+
+static void prepareContext(Context& ctx, const Mesh& mesh)
+{
+	ctx.mesh = &mesh;
+
+	size_t index_count = mesh.indices.size();
+	size_t vertex_count = mesh.vertices.size();
+
+	ctx.unindexed.resize(index_count);
+	for (size_t i = 0; i < index_count; ++i)
+		ctx.unindexed[i] = mesh.vertices[mesh.indices[i]];
+
+	ctx.optimized.resize(index_count);
+	meshopt_optimizeVertexCache(&ctx.optimized[0], &mesh.indices[0], index_count, vertex_count);
+
+	ctx.optimized_vertices.resize(vertex_count);
+	meshopt_optimizeVertexFetch(&ctx.optimized_vertices[0], &ctx.optimized[0], index_count, &mesh.vertices[0], vertex_count, sizeof(Vertex));
+
+	ctx.strip.resize(meshopt_stripifyBound(index_count));
+	ctx.strip.resize(meshopt_stripify(&ctx.strip[0], &ctx.optimized[0], index_count, vertex_count, ~0u));
+
+	// tessellation index buffer needs 4 indices per source index; LOD chain stores 3 levels
+	ctx.ib.resize(std::max(std::max(meshopt_stripifyBound(index_count), meshopt_unstripifyBound(ctx.strip.size())), index_count * 4));
+	ctx.remap.resize(std::max(index_count, vertex_count));
+	ctx.vb.resize(vertex_count);
+
+	meshopt_Stream streams[3] = {
+	    {&mesh.vertices[0].px, sizeof(float) * 3, sizeof(Vertex)},
+	    {&mesh.vertices[0].nx, sizeof(float) * 3, sizeof(Vertex)},
+	    {&mesh.vertices[0].tx, sizeof(float) * 2, sizeof(Vertex)},
+	};
+	memcpy(ctx.streams, streams, sizeof(streams));
+
+	ctx.simplified.resize(index_count);
+	ctx.simplified.resize(meshopt_simplify(&ctx.simplified[0], &mesh.indices[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex), index_count / 3 / 4 * 3, 1e-2f, NULL));
+
+	ctx.lod_index_counts.resize(3);
+	ctx.simplifier = meshopt_createSimplifierContext(&mesh.indices[0], index_count, &mesh.vertices[0].px, vertex_count, sizeof(Vertex));
+
+	// spatial clusters use min_triangles = 32 and parallel clusters are split into partitions, both of which need more space in the worst case
+	size_t max_meshlets = std::max(meshopt_buildMeshletsBound(index_count, 64, 124), std::max(meshopt_buildMeshletsSpatialBound(index_count, 64, 32), meshopt_buildMeshletsParallelBound(index_count, 64, 124)));
+	ctx.meshlets.resize(max_meshlets);
+	ctx.meshlet_vertices.resize(max_meshlets * 64);
+	ctx.meshlet_triangles.resize(max_meshlets * 124 * 3);
+	ctx.meshlet_count = 0;
+	ctx.bounds.resize(max_meshlets);
+
+	ctx.mbuf.resize(max_meshlets * meshopt_encodeMeshletBound(64, 124));
+	ctx.mbuf_offsets.resize(max_meshlets + 1);
+
+	size_t max_clusters = meshopt_buildClusterLodBound(index_count, 64, 124);
+	ctx.clusters.resize(max_clusters);
+	ctx.cluster_vertices.resize(max_clusters * 64);
+	ctx.cluster_triangles.resize(max_clusters * 124 * 3);
+
+	ctx.vbuf.resize(meshopt_encodeVertexBufferBound(vertex_count, sizeof(Vertex)));
+	ctx.vbuf.resize(meshopt_encodeVertexBuffer(&ctx.vbuf[0], ctx.vbuf.size(), &ctx.optimized_vertices[0], vertex_count, sizeof(Vertex)));
+
+	ctx.ibuf.resize(meshopt_encodeIndexBufferBound(index_count, vertex_count));
+	ctx.ibuf.resize(meshopt_encodeIndexBuffer(&ctx.ibuf[0], ctx.ibuf.size(), &ctx.optimized[0], index_count));
+
+	ctx.sbuf.resize(meshopt_encodeIndexSequenceBound(ctx.strip.size(), vertex_count));
+	ctx.sbuf.resize(meshopt_encodeIndexSequence(&ctx.sbuf[0], ctx.sbuf.size(), &ctx.strip[0], ctx.strip.size()));
+
+	// range decoding and streaming need the seekable formats; the encoder versions are restored to the defaults afterwards
+	meshopt_encodeVertexVersion(1);
+	ctx.vbuf1.resize(meshopt_encodeVertexBufferBound(vertex_count, sizeof(Vertex)));
+	ctx.vbuf1.resize(meshopt_encodeVertexBuffer(&ctx.vbuf1[0], ctx.vbuf1.size(), &ctx.optimized_vertices[0], vertex_count, sizeof(Vertex)));
+	meshopt_encodeVertexVersion(0);
+
+	meshopt_encodeIndexVersion(2);
+	ctx.ibuf2.resize(meshopt_encodeIndexBufferBound(index_count, vertex_count));
+	ctx.ibuf2.resize(meshopt_encodeIndexBuffer(&ctx.ibuf2[0], ctx.ibuf2.size(), &ctx.optimized[0], index_count));
+	meshopt_encodeIndexVersion(0);
+
+	size_t vbound = meshopt_encodeVertexBufferBound(vertex_count, sizeof(Vertex));
+	size_t ibound = meshopt_encodeIndexBufferBound(index_count, vertex_count);
+	size_t sbound = meshopt_encodeIndexSequenceBound(ctx.strip.size(), vertex_count);
+
+	ctx.scratch.resize(std::max(vbound, std::max(ibound, sbound)));
+
+	// filter inputs use the same element count as the vertex buffer and bit patterns that don't depend on the mesh
+	ctx.filter_oct.resize(vertex_count * 4);
+	ctx.filter_quat.resize(vertex_count * 4);
+	ctx.filter_exp.resize(vertex_count * 2);
+
+	for (size_t i = 0; i < vertex_count * 4; ++i)
+	{
+		ctx.filter_oct[i] = (unsigned short)(i * 2654435761u >> 16);
+		ctx.filter_quat[i] = (unsigned short)((i * 2246822519u >> 16) & ~3u);
+	}
+
+	for (size_t i = 0; i < vertex_count * 2; ++i)
+		ctx.filter_exp[i] = (unsigned int)(i * 3266489917u) & 0xf0ffffffu;
+
+	ctx.obuf.resize(meshopt_encodeVertexBufferBound(vertex_count, 8));
+	ctx.obuf.resize(meshopt_encodeVertexBuffer(&ctx.obuf[0], ctx.obuf.size(), &ctx.filter_oct[0], vertex_count, 8));
+	ctx.filter_out.resize(vertex_count * 4);
+
+	ctx.quantized.resize(vertex_count * 8);
+	ctx.quantized_float.resize(vertex_count * 8);
+}
+
+static void benchGenerateVertexRemap(Context& ctx)
+{
+	meshopt_generateVertexRemap(&ctx.remap[0], NULL, ctx.unindexed.size(), &ctx.unindexed[0], ctx.unindexed.size(), sizeof(Vertex));
+}
+
+static void benchGenerateVertexRemapMulti(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_generateVertexRemapMulti(&ctx.remap[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), ctx.streams, 3);
+}
+
+static void benchRemapVertexBuffer(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+
+	// runs on the result of the last generateVertexRemap* call, which remaps an indexed mesh to itself
+	meshopt_remapVertexBuffer(&ctx.vb[0], &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex), &ctx.remap[0]);
+}
+
+static void benchRemapIndexBuffer(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+
+	// runs on the result of the last generateVertexRemap* call
+	meshopt_remapIndexBuffer(&ctx.ib[0], &mesh.indices[0], mesh.indices.size(), &ctx.remap[0]);
+}
+
+static void benchGenerateShadowIndexBuffer(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_generateShadowIndexBuffer(&ctx.ib[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(float) * 3, sizeof(Vertex));
+}
+
+static void benchGenerateShadowIndexBufferMulti(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_generateShadowIndexBufferMulti(&ctx.ib[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), ctx.streams, 1);
+}
+
+static void benchGenerateAdjacencyIndexBuffer(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_generateAdjacencyIndexBuffer(&ctx.ib[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+}
+
+static void benchGenerateTessellationIndexBuffer(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_generateTessellationIndexBuffer(&ctx.ib[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+}
+
+static void benchOptimizeVertexCache(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_optimizeVertexCache(&ctx.ib[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
+}
+
+static void benchOptimizeVertexCacheStrip(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_optimizeVertexCacheStrip(&ctx.ib[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
+}
+
+static void benchOptimizeVertexCacheFifo(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_optimizeVertexCacheFifo(&ctx.ib[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), 16);
+}
+
+static void benchOptimizeOverdraw(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_optimizeOverdraw(&ctx.ib[0], &ctx.optimized[0], ctx.optimized.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 1.05f);
+}
+
+static void benchOptimizeVertexFetch(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+
+	// the function remaps indices in place, so we need a fresh copy every time
+	memcpy(&ctx.ib[0], &mesh.indices[0], mesh.indices.size() * sizeof(unsigned int));
+	meshopt_optimizeVertexFetch(&ctx.vb[0], &ctx.ib[0], mesh.indices.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex));
+}
+
+static void benchOptimizeVertexFetchRemap(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_optimizeVertexFetchRemap(&ctx.remap[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
+}
+
+static void benchStripify(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_stripify(&ctx.ib[0], &ctx.optimized[0], ctx.optimized.size(), mesh.vertices.size(), ~0u);
+}
+
+static void benchUnstripify(Context& ctx)
+{
+	meshopt_unstripify(&ctx.ib[0], &ctx.strip[0], ctx.strip.size(), ~0u);
+}
+
+static void benchAnalyzeVertexCache(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_analyzeVertexCache(&mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), 16, 0, 0);
+}
+
+static void benchAnalyzeOverdraw(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_analyzeOverdraw(&mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+}
+
+static void benchAnalyzeVertexFetch(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_analyzeVertexFetch(&mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), sizeof(Vertex));
+}
+
+static void benchSpatialSortRemap(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_spatialSortRemap(&ctx.remap[0], &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+}
+
+static void benchSpatialSortTriangles(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_spatialSortTriangles(&ctx.ib[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+}
+
+static void benchSimplify(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_simplify(&ctx.ib[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), mesh.indices.size() / 3 / 4 * 3, 1e-2f, NULL);
+}
+
+static void benchSimplifyWithAttributes(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	const float weights[5] = {0.5f, 0.5f, 0.5f, 0.1f, 0.1f};
+
+	// normals and texture coordinates are stored contiguously in Vertex, so they form 5 attributes
+	meshopt_simplifyWithAttributes(&ctx.ib[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), &mesh.vertices[0].nx, sizeof(Vertex), weights, 5, NULL, mesh.indices.size() / 3 / 4 * 3, 1e-2f, NULL);
+}
+
+static void benchSimplifyLodChain(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	size_t index_count = mesh.indices.size();
+
+	const size_t targets[3] = {index_count / 3 / 2 * 3, index_count / 3 / 4 * 3, index_count / 3 / 8 * 3};
+	const float errors[3] = {1e-2f, 1e-2f, 1e-2f};
+
+	meshopt_simplifyLodChain(&ctx.ib[0], &ctx.lod_index_counts[0], &mesh.indices[0], index_count, &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), targets, errors, 3, NULL);
+}
+
+static void benchCreateSimplifierContext(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+
+	meshopt_SimplifierContext* context = meshopt_createSimplifierContext(&mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+	meshopt_destroySimplifierContext(context);
+}
+
+static void benchSimplifyWithContext(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+
+	// the context is created once per mesh, so this only measures the query
+	meshopt_simplifyWithContext(ctx.simplifier, &ctx.ib[0], mesh.indices.size() / 3 / 4 * 3, 1e-2f, NULL);
+}
+
+static void benchSimplifyOutOfCore(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+
+	// a quarter of the index and position data forces the mesh to be simplified in batches
+	size_t budget = (mesh.indices.size() * sizeof(unsigned int) + mesh.vertices.size() * sizeof(float) * 3) / 4;
+
+	meshopt_simplifyOutOfCore(&ctx.ib[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), mesh.indices.size() / 3 / 4 * 3, 1e-2f, NULL, budget);
+}
+
+static void benchSimplifySloppy(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_simplifySloppy(&ctx.ib[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), mesh.indices.size() / 3 / 4 * 3, 1e-2f, NULL);
+}
+
+static void benchSimplifySloppyParallel(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_simplifySloppyParallel(&ctx.ib[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), mesh.indices.size() / 3 / 4 * 3, 1e-2f, NULL, NULL, NULL);
+}
+
+static void benchSimplifyPoints(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_simplifyPoints(&ctx.remap[0], &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), mesh.vertices.size() / 4);
+}
+
+static void benchSimplifyScale(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_simplifyScale(&mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+}
+
+static void benchComputeHausdorffDistance(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+
+	// measures how far the simplified mesh prepared in prepareContext deviates from the source
+	meshopt_computeHausdorffDistance(&ctx.simplified[0], ctx.simplified.size(), &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+}
+
+static void benchBuildClusterLod(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_buildClusterLod(&ctx.clusters[0], &ctx.cluster_vertices[0], &ctx.cluster_triangles[0], ctx.clusters.size(), &ctx.optimized[0], ctx.optimized.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 64, 124);
+}
+
+static void benchBuildMeshletsParallel(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_buildMeshletsParallel(&ctx.meshlets[0], &ctx.meshlet_vertices[0], &ctx.meshlet_triangles[0], &ctx.optimized[0], ctx.optimized.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 64, 124, 0.5f, NULL, NULL);
+}
+
+static void benchBuildMeshlets(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	ctx.meshlet_count = meshopt_buildMeshlets(&ctx.meshlets[0], &ctx.meshlet_vertices[0], &ctx.meshlet_triangles[0], &ctx.optimized[0], ctx.optimized.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 64, 124, 0.5f);
+}
+
+static void benchBuildMeshletsScan(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_buildMeshletsScan(&ctx.meshlets[0], &ctx.meshlet_vertices[0], &ctx.meshlet_triangles[0], &ctx.optimized[0], ctx.optimized.size(), mesh.vertices.size(), 64, 124);
+}
+
+static void benchBuildMeshletsSpatial(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+	meshopt_buildMeshletsSpatial(&ctx.meshlets[0], &ctx.meshlet_vertices[0], &ctx.meshlet_triangles[0], NULL, &ctx.optimized[0], ctx.optimized.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 64, 32, 124);
+}
+
+static void benchComputeMeshletBounds(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+
+	// runs on the result of the last buildMeshlets call
+	for (size_t i = 0; i < ctx.meshlet_count; ++i)
+	{
+		const meshopt_Meshlet& m = ctx.meshlets[i];
+		meshopt_computeMeshletBounds(&ctx.meshlet_vertices[m.vertex_offset], &ctx.meshlet_triangles[m.triangle_offset], m.triangle_count, &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+	}
+}
+
+static void benchComputeClusterBounds(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+
+	// clusters are formed by consecutive runs of 124 triangles of the optimized index buffer
+	for (size_t i = 0; i < ctx.optimized.size(); i += 124 * 3)
+		meshopt_computeClusterBounds(&ctx.optimized[i], std::min(ctx.optimized.size() - i, size_t(124 * 3)), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+}
+
+static void benchComputeMeshletBoundsBatch(Context& ctx)
+{
+	const Mesh& mesh = *ctx.mesh;
+
+	// runs on the result of the last buildMeshlets call
+	meshopt_computeMeshletBoundsBatch(&ctx.bounds[0], &ctx.meshlets[0], ctx.meshlet_count, &ctx.meshlet_vertices[0], &ctx.meshlet_triangles[0], &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), NULL, NULL);
+}
+
+static void benchOptimizeMeshlets(Context& ctx)
+{
+	// runs on the result of the last buildMeshlets call; the result is the same after the first run
+	for (size_t i = 0; i < ctx.meshlet_count; ++i)
+	{
+		const meshopt_Meshlet& m = ctx.meshlets[i];
+		meshopt_optimizeMeshlet(&ctx.meshlet_vertices[m.vertex_offset], &ctx.meshlet_triangles[m.triangle_offset], m.triangle_count, m.vertex_count);
+	}
+}
+
+static void benchEncodeMeshlets(Context& ctx)
+{
+	// runs on the result of the last buildMeshlets call
+	size_t offset = 0;
+
+	for (size_t i = 0; i < ctx.meshlet_count; ++i)
+	{
+		const meshopt_Meshlet& m = ctx.meshlets[i];
+
+		ctx.mbuf_offsets[i] = offset;
+		offset += meshopt_encodeMeshlet(&ctx.mbuf[offset], ctx.mbuf.size() - offset, &ctx.meshlet_vertices[m.vertex_offset], m.vertex_count, &ctx.meshlet_triangles[m.triangle_offset], m.triangle_count);
+	}
+
+	ctx.mbuf_offsets[ctx.meshlet_count] = offset;
+}
+
+static void benchDecodeMeshlets(Context& ctx)
+{
+	unsigned int vertices[64];
+	unsigned char triangles[124 * 3];
+
+	for (size_t i = 0; i < ctx.meshlet_count; ++i)
+	{
+		const meshopt_Meshlet& m = ctx.meshlets[i];
+
+		int rc = meshopt_decodeMeshlet(vertices, m.vertex_count, triangles, m.triangle_count, &ctx.mbuf[ctx.mbuf_offsets[i]], ctx.mbuf_offsets[i + 1] - ctx.mbuf_offsets[i]);
+		assert(rc == 0);
+		(void)rc;
+	}
+}
+
+static void benchEncodeVertexBuffer(Context& ctx)
+{
+	meshopt_encodeVertexBuffer(&ctx.scratch[0], ctx.scratch.size(), &ctx.optimized_vertices[0], ctx.optimized_vertices.size(), sizeof(Vertex));
+}
+
+static void benchDecodeVertexBuffer(Context& ctx)
+{
+	int rc = meshopt_decodeVertexBuffer(&ctx.vb[0], ctx.vb.size(), sizeof(Vertex), &ctx.vbuf[0], ctx.vbuf.size());
+	assert(rc == 0);
+	(void)rc;
+}
+
+static void benchDecodeVertexBufferParallel(Context& ctx)
+{
+	int rc = meshopt_decodeVertexBufferParallel(&ctx.vb[0], ctx.vb.size(), sizeof(Vertex), &ctx.vbuf[0], ctx.vbuf.size(), NULL, NULL);
+	assert(rc == 0);
+	(void)rc;
+}
+
+static void benchDecodeVertexBufferRange(Context& ctx)
+{
+	size_t vertex_count = ctx.vb.size();
+
+	// decodes the second quarter of a version 1 buffer; throughput is reported for the entire buffer so that it's comparable with decodeVertexBuffer
+	int rc = meshopt_decodeVertexBufferRange(&ctx.vb[0], vertex_count / 4, vertex_count / 4, vertex_count, sizeof(Vertex), &ctx.vbuf1[0], ctx.vbuf1.size());
+	assert(rc == 0);
+	(void)rc;
+}
+
+static void benchDecodeVertexBufferFiltered(Context& ctx)
+{
+	int rc = meshopt_decodeVertexBufferFiltered(&ctx.filter_out[0], ctx.filter_out.size() / 4, 8, &ctx.obuf[0], ctx.obuf.size(), meshopt_decodeFilterOct);
+	assert(rc == 0);
+	(void)rc;
+}
+
+static void benchFeedVertexDecoder(Context& ctx)
+{
+	meshopt_VertexDecoder* decoder = meshopt_createVertexDecoder(&ctx.vb[0], ctx.vb.size(), sizeof(Vertex));
+
+	// feeds a version 1 buffer in 64 KB chunks, querying the ready prefix after each one like a network consumer would
+	size_t ready = 0;
+
+	for (size_t offset = 0; offset < ctx.vbuf1.size(); offset += 65536)
+	{
+		int rc = meshopt_feedVertexDecoder(decoder, &ctx.vbuf1[offset], std::min(ctx.vbuf1.size() - offset, size_t(65536)));
+		assert(rc == 0);
+		(void)rc;
+
+		ready = meshopt_getVertexDecoderReady(decoder);
+	}
+
+	int rc = meshopt_finishVertexDecoder(decoder);
+	assert(rc == 0 && ready <= ctx.vb.size());
+	(void)rc;
+	(void)ready;
+
+	meshopt_destroyVertexDecoder(decoder);
+}
+
+static void benchEncodeIndexBuffer(Context& ctx)
+{
+	meshopt_encodeIndexBuffer(&ctx.scratch[0], ctx.scratch.size(), &ctx.optimized[0], ctx.optimized.size());
+}
+
+static void benchDecodeIndexBuffer(Context& ctx)
+{
+	int rc = meshopt_decodeIndexBuffer(&ctx.ib[0], ctx.optimized.size(), 4, &ctx.ibuf[0], ctx.ibuf.size());
+	assert(rc == 0);
+	(void)rc;
+}
+
+static void benchEncodeIndexBufferParallel(Context& ctx)
+{
+	// only version 2 can be encoded in parallel
+	meshopt_encodeIndexVersion(2);
+	meshopt_encodeIndexBufferParallel(&ctx.scratch[0], ctx.scratch.size(), &ctx.optimized[0], ctx.optimized.size(), NULL, NULL);
+	meshopt_encodeIndexVersion(0);
+}
+
+static void benchDecodeIndexBufferParallel(Context& ctx)
+{
+	int rc = meshopt_decodeIndexBufferParallel(&ctx.ib[0], ctx.optimized.size(), 4, &ctx.ibuf2[0], ctx.ibuf2.size(), NULL, NULL);
+	assert(rc == 0);
+	(void)rc;
+}
+
+static void benchDecodeIndexBufferRange(Context& ctx)
+{
+	size_t index_count = ctx.optimized.size();
+
+	// decodes the second quarter of a version 2 buffer; throughput is reported for the entire buffer so that it's comparable with decodeIndexBuffer
+	int rc = meshopt_decodeIndexBufferRange(&ctx.ib[0], index_count / 3 / 4 * 3, index_count / 3 / 4 * 3, index_count, 4, &ctx.ibuf2[0], ctx.ibuf2.size());
+	assert(rc == 0);
+	(void)rc;
+}
+
+static void benchEncodeIndexSequence(Context& ctx)
+{
+	meshopt_encodeIndexSequence(&ctx.scratch[0], ctx.scratch.size(), &ctx.strip[0], ctx.strip.size());
+}
+
+static void benchDecodeIndexSequence(Context& ctx)
+{
+	int rc = meshopt_decodeIndexSequence(&ctx.ib[0], ctx.strip.size(), 4, &ctx.sbuf[0], ctx.sbuf.size());
+	assert(rc == 0);
+	(void)rc;
+}
+
+static void benchDecodeFilterOct(Context& ctx)
+{
+	meshopt_decodeFilterOct(&ctx.filter_oct[0], ctx.filter_oct.size() / 4, 8);
+}
+
+static void benchDecodeFilterQuat(Context& ctx)
+{
+	meshopt_decodeFilterQuat(&ctx.filter_quat[0], ctx.filter_quat.size() / 4, 8);
+}
+
+static void benchDecodeFilterExp(Context& ctx)
+{
+	meshopt_decodeFilterExp(&ctx.filter_exp[0], ctx.filter_exp.size() / 2, 8);
+}
+
+static void benchQuantizeUnorm(Context& ctx)
+{
+	const float* data = &ctx.mesh->vertices[0].px;
+
+	for (size_t i = 0; i < ctx.quantized.size(); ++i)
+		ctx.quantized[i] = (unsigned short)meshopt_quantizeUnorm(data[i], 16);
+}
+
+static void benchQuantizeSnorm(Context& ctx)
+{
+	const float* data = &ctx.mesh->vertices[0].px;
+
+	for (size_t i = 0; i < ctx.quantized.size(); ++i)
+		ctx.quantized[i] = (unsigned short)meshopt_quantizeSnorm(data[i], 16);
+}
+
+static void benchQuantizeHalf(Context& ctx)
+{
+	const float* data = &ctx.mesh->vertices[0].px;
+
+	for (size_t i = 0; i < ctx.quantized.size(); ++i)
+		ctx.quantized[i] = meshopt_quantizeHalf(data[i]);
+}
+
+static void benchQuantizeFloat(Context& ctx)
+{
+	const float* data = &ctx.mesh->vertices[0].px;
+
+	for (size_t i = 0; i < ctx.quantized_float.size(); ++i)
+		ctx.quantized_float[i] = meshopt_quantizeFloat(data[i], 12);
+}
+
+// every function that processes mesh data is covered; size bounds, encoder version selection, meshopt_setAllocator and meshopt_getSimdLevel are not
+// quantize* functions are applied to all 8 floats of each vertex regardless of their meaning; parallel variants run with NULL dispatch, so they measure the serial cost of the job split
+// note: the order matters; benchmarks that consume the results of earlier ones (remap*Buffer, computeMeshletBounds, optimize/encode/decodeMeshlets) need to come after them
+static const Benchmark kBenchmarks[] =
+    {
+        {"generateVertexRemap", benchGenerateVertexRemap, Unit_Triangles},
+        {"generateVertexRemapMulti", benchGenerateVertexRemapMulti, Unit_Triangles},
+        {"remapVertexBuffer", benchRemapVertexBuffer, Unit_Vertices},
+        {"remapIndexBuffer", benchRemapIndexBuffer, Unit_Triangles},
+        {"generateShadowIndexBuffer", benchGenerateShadowIndexBuffer, Unit_Triangles},
+        {"generateShadowIndexBufferMulti", benchGenerateShadowIndexBufferMulti, Unit_Triangles},
+        {"generateAdjacencyIndexBuffer", benchGenerateAdjacencyIndexBuffer, Unit_Triangles},
+        {"generateTessellationIndexBuffer", benchGenerateTessellationIndexBuffer, Unit_Triangles},
+        {"optimizeVertexCache", benchOptimizeVertexCache, Unit_Triangles},
+        {"optimizeVertexCacheStrip", benchOptimizeVertexCacheStrip, Unit_Triangles},
+        {"optimizeVertexCacheFifo", benchOptimizeVertexCacheFifo, Unit_Triangles},
+        {"optimizeOverdraw", benchOptimizeOverdraw, Unit_Triangles},
+        {"optimizeVertexFetch", benchOptimizeVertexFetch, Unit_Triangles},
+        {"optimizeVertexFetchRemap", benchOptimizeVertexFetchRemap, Unit_Triangles},
+        {"stripify", benchStripify, Unit_Triangles},
+        {"unstripify", benchUnstripify, Unit_Triangles},
+        {"analyzeVertexCache", benchAnalyzeVertexCache, Unit_Triangles},
+        {"analyzeOverdraw", benchAnalyzeOverdraw, Unit_Triangles},
+        {"analyzeVertexFetch", benchAnalyzeVertexFetch, Unit_Triangles},
+        {"spatialSortRemap", benchSpatialSortRemap, Unit_Vertices},
+        {"spatialSortTriangles", benchSpatialSortTriangles, Unit_Triangles},
+        {"simplify", benchSimplify, Unit_Triangles},
+        {"simplifyWithAttributes", benchSimplifyWithAttributes, Unit_Triangles},
+        {"simplifyLodChain", benchSimplifyLodChain, Unit_Triangles},
+        {"createSimplifierContext", benchCreateSimplifierContext, Unit_Triangles},
+        {"simplifyWithContext", benchSimplifyWithContext, Unit_Triangles},
+        {"simplifyOutOfCore", benchSimplifyOutOfCore, Unit_Triangles},
+        {"simplifySloppy", benchSimplifySloppy, Unit_Triangles},
+        {"simplifySloppyParallel", benchSimplifySloppyParallel, Unit_Triangles},
+        {"simplifyPoints", benchSimplifyPoints, Unit_Vertices},
+        {"simplifyScale", benchSimplifyScale, Unit_Vertices},
+        {"computeHausdorffDistance", benchComputeHausdorffDistance, Unit_Triangles},
+        {"buildClusterLod", benchBuildClusterLod, Unit_Triangles},
+        {"buildMeshletsScan", benchBuildMeshletsScan, Unit_Triangles},
+        {"buildMeshletsSpatial", benchBuildMeshletsSpatial, Unit_Triangles},
+        {"buildMeshletsParallel", benchBuildMeshletsParallel, Unit_Triangles},
+        {"buildMeshlets", benchBuildMeshlets, Unit_Triangles},
+        {"computeClusterBounds", benchComputeClusterBounds, Unit_Triangles},
+        {"computeMeshletBounds", benchComputeMeshletBounds, Unit_Triangles},
+        {"computeMeshletBoundsBatch", benchComputeMeshletBoundsBatch, Unit_Triangles},
+        {"optimizeMeshlets", benchOptimizeMeshlets, Unit_Triangles},
+        {"encodeMeshlets", benchEncodeMeshlets, Unit_Triangles},
+        {"decodeMeshlets", benchDecodeMeshlets, Unit_Triangles},
+        {"encodeVertexBuffer", benchEncodeVertexBuffer, Unit_Bytes},
+        {"decodeVertexBuffer", benchDecodeVertexBuffer, Unit_Bytes},
+        {"decodeVertexBufferParallel", benchDecodeVertexBufferParallel, Unit_Bytes},
+        {"decodeVertexBufferRange", benchDecodeVertexBufferRange, Unit_Bytes},
+        {"decodeVertexBufferFiltered", benchDecodeVertexBufferFiltered, Unit_Vertices},
+        {"feedVertexDecoder", benchFeedVertexDecoder, Unit_Bytes},
+        {"encodeIndexBuffer", benchEncodeIndexBuffer, Unit_Triangles},
+        {"decodeIndexBuffer", benchDecodeIndexBuffer, Unit_Triangles},
+        {"encodeIndexBufferParallel", benchEncodeIndexBufferParallel, Unit_Triangles},
+        {"decodeIndexBufferParallel", benchDecodeIndexBufferParallel, Unit_Triangles},
+        {"decodeIndexBufferRange", benchDecodeIndexBufferRange, Unit_Triangles},
+        {"encodeIndexSequence", benchEncodeIndexSequence, Unit_Triangles},
+        {"decodeIndexSequence", benchDecodeIndexSequence, Unit_Triangles},
+        {"decodeFilterOct", benchDecodeFilterOct, Unit_Vertices},
+        {"decodeFilterQuat", benchDecodeFilterQuat, Unit_Vertices},
+        {"decodeFilterExp", benchDecodeFilterExp, Unit_Vertices},
+        {"quantizeUnorm", benchQuantizeUnorm, Unit_Vertices},
+        {"quantizeSnorm", benchQuantizeSnorm, Unit_Vertices},
+        {"quantizeHalf", benchQuantizeHalf, Unit_Vertices},
+        {"quantizeFloat", benchQuantizeFloat, Unit_Vertices},
+};
+
+struct Result
+{
+	std::string mesh;
+	std::string name;
+
+	double min, median, p99; // milliseconds
+	double throughput;
+	std::string unit;
+	size_t peak; // bytes
+};
+
+static Result runBenchmark(Context& ctx, const Benchmark& bench, int iterations)
+{
+	std::vector<double> times(iterations);
+
+	// allocations that outlive a single call (e.g. the simplifier context) are live during all benchmarks and are excluded from the peak
+	size_t baseline = gAllocatedBytes;
+	gPeakBytes = baseline;
+
+	// warm up caches and lazily initialized tables before measuring
+	bench.function(ctx);
+
+	for (int i = 0; i < iterations; ++i)
+	{
+		double t0 = timestamp();
+		bench.function(ctx);
+		double t1 = timestamp();
+
+		times[i] = (t1 - t0) * 1000;
+	}
+
+	std::sort(times.begin(), times.end());
+
+	Result result;
+	result.mesh = ctx.mesh->name;
+	result.name = bench.name;
+	result.min = times[0];
+	result.median = (iterations % 2) ? times[iterations / 2] : (times[iterations / 2 - 1] + times[iterations / 2]) / 2;
+	result.p99 = times[size_t(ceil(iterations * 0.99)) - 1];
+
+	double work = double(getWork(ctx, bench.unit));
+	double scale = bench.unit == Unit_Bytes ? 1024 * 1024 : 1e6;
+
+	result.throughput = result.median > 0 ? work / scale / (result.median / 1000) : 0;
+	result.unit = getUnitName(bench.unit);
+	result.peak = gPeakBytes - baseline;
+
+	return result;
+}
+
+static void writeString(FILE* file, const std::string& str)
+{
+	fputc('"', file);
+
+	for (size_t i = 0; i < str.size(); ++i)
+	{
+		if (str[i] == '"' || str[i] == '\\')
+			fputc('\\', file);
+		fputc(str[i], file);
+	}
+
+	fputc('"', file);
+}
+
+static void writeResults(FILE* file, const std::vector<Result>& results, int iterations)
+{
+	fprintf(file, "{\n");
+	fprintf(file, "\t\"version\": %d,\n", MESHOPTIMIZER_VERSION);
+	fprintf(file, "\t\"simd\": %d,\n", meshopt_getSimdLevel());
+	fprintf(file, "\t\"iterations\": %d,\n", iterations);
+	fprintf(file, "\t\"results\": [\n");
+
+	// one result per line keeps the output diffable and lets compare mode parse it without a full JSON parser
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const Result& r = results[i];
+
+		fprintf(file, "\t\t{\"mesh\": ");
+		writeString(file, r.mesh);
+		fprintf(file, ", \"name\": ");
+		writeString(file, r.name);
+		fprintf(file, ", \"min\": %.4f, \"median\": %.4f, \"p99\": %.4f, \"throughput\": %.2f, \"unit\": \"%s\", \"peak\": %lld}%s\n",
+		        r.min, r.median, r.p99, r.throughput, r.unit.c_str(), (long long)r.peak, i + 1 < results.size() ? "," : "");
+	}
+
+	fprintf(file, "\t]\n");
+	fprintf(file, "}\n");
+}
+
+static bool readString(std::string& result, const char* line, const char* key)
+{
+	const char* pos = strstr(line, key);
+	if (!pos)
+		return false;
+
+	pos += strlen(key);
+
+	while (*pos == ' ' || *pos == ':')
+		pos++;
+
+	if (*pos != '"')
+		return false;
+
+	result.clear();
+
+	for (pos++; *pos && *pos != '"'; ++pos)
+	{
+		if (*pos == '\\' && pos[1])
+			pos++;
+		result += *pos;
+	}
+
+	return *pos == '"';
+}
+
+static bool readNumber(double& result, const char* line, const char* key)
+{
+	const char* pos = strstr(line, key);
+	if (!pos)
+		return false;
+
+	pos += strlen(key);
+
+	while (*pos == ' ' || *pos == ':')
+		pos++;
+
+	char* end = NULL;
+	result = strtod(pos, &end);
+
+	return end != pos;
+}
+
+static bool readResults(std::vector<Result>& results, const char* path)
+{
+	FILE* file = fopen(path, "r");
+	if (!file)
+		return false;
+
+	char line[4096];
+
+	while (fgets(line, sizeof(line), file))
+	{
+		Result r;
+		double peak = 0;
+
+		if (!readString(r.mesh, line, "\"mesh\"") || !readString(r.name, line, "\"name\""))
+			continue;
+
+		if (!readNumber(r.min, line, "\"min\"") || !readNumber(r.median, line, "\"median\"") || !readNumber(r.p99, line, "\"p99\"") ||
+		    !readNumber(r.throughput, line, "\"throughput\"") || !readNumber(peak, line, "\"peak\""))
+			continue;
+
+		readString(r.unit, line, "\"unit\"");
+		r.peak = size_t(peak);
+
+		results.push_back(r);
+	}
+
+	fclose(file);
+	return true;
+}
+
+static int compareResults(const char* base_path, const char* test_path, double threshold)
+{
+	std::vector<Result> base, test;
+
+	if (!readResults(base, base_path))
+	{
+		fprintf(stderr, "Error loading %s\n", base_path);
+		return 2;
+	}
+
+	if (!readResults(test, test_path))
+	{
+		fprintf(stderr, "Error loading %s\n", test_path);
+		return 2;
+	}
+
+	int regressions = 0;
+
+	printf("%-30s %-32s %10s %10s %8s %12s %12s\n", "mesh", "name", "base min", "test min", "delta", "base peak", "test peak");
+
+	for (size_t i = 0; i < test.size(); ++i)
+	{
+		const Result& t = test[i];
+		const Result* b = NULL;
+
+		for (size_t j = 0; j < base.size() && !b; ++j)
+			if (base[j].mesh == t.mesh && base[j].name == t.name)
+				b = &base[j];
+
+		if (!b)
+		{
+			printf("%-30s %-32s %10s %10.4f %8s\n", t.mesh.c_str(), t.name.c_str(), "-", t.min, "new");
+			continue;
+		}
+
+		// minimum times are compared since they are least affected by scheduling noise; memory use is deterministic so any growth is reported
+		double delta = b->min > 0 ? (t.min - b->min) / b->min * 100 : 0;
+
+		bool slower = delta > threshold;
+		bool larger = t.peak > b->peak;
+
+		printf("%-30s %-32s %10.4f %10.4f %+7.1f%% %12lld %12lld%s\n",
+		       t.mesh.c_str(), t.name.c_str(), b->min, t.min, delta, (long long)b->peak, (long long)t.peak,
+		       slower && larger ? " SLOWER, MORE MEMORY" : slower ? " SLOWER" : larger ? " MORE MEMORY" : "");
+
+		regressions += slower || larger;
+	}
+
+	printf("%d regression(s) over %.1f%% threshold\n", regressions, threshold);
+
+	return regressions ? 1 : 0;
+}
+
+static void usage(const char* name)
+{
+	fprintf(stderr, "Usage: %s [options] <mesh.obj>...\n", name);
+	fprintf(stderr, "       %s -compare <base.json> <test.json> [-threshold <percent>]\n", name);
+	fprintf(stderr, "\nOptions:\n");
+	fprintf(stderr, "\t-n N: run each benchmark N times (default: 20)\n");
+	fprintf(stderr, "\t-o file: write JSON results to file instead of stdout\n");
+	fprintf(stderr, "\t-f name: only run benchmarks with names containing the given string\n");
+	fprintf(stderr, "\t-threshold P: report minimum time increases over P percent as regressions (default: 10)\n");
+}
+
+int main(int argc, char** argv)
+{
+	int iterations = 20;
+	double threshold = 10;
+	const char* output = NULL;
+	const char* filter = NULL;
+	const char* compare[2] = {};
+	std::vector<const char*> paths;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+
+		if (strcmp(arg, "-n") == 0 && i + 1 < argc)
+			iterations = atoi(argv[++i]);
+		else if (strcmp(arg, "-o") == 0 && i + 1 < argc)
+			output = argv[++i];
+		else if (strcmp(arg, "-f") == 0 && i + 1 < argc)
+			filter = argv[++i];
+		else if (strcmp(arg, "-threshold") == 0 && i + 1 < argc)
+			threshold = atof(argv[++i]);
+		else if (strcmp(arg, "-compare") == 0 && i + 2 < argc)
+		{
+			compare[0] = argv[++i];
+			compare[1] = argv[++i];
+		}
+		else if (arg[0] == '-')
+		{
+			usage(argv[0]);
+			return 2;
+		}
+		else
+			paths.push_back(arg);
+	}
+
+	if (compare[0])
+		return compareResults(compare[0], compare[1], threshold);
+
+	if (paths.empty() || iterations <= 0)
+	{
+		usage(argv[0]);
+		return 2;
+	}
+
+	meshopt_setAllocator(trackAllocate, trackDeallocate);
+
+	std::vector<Result> results;
+
+	for (size_t i = 0; i < paths.size(); ++i)
+	{
+		Mesh mesh;
+
+		if (!loadObj(mesh, paths[i]))
+		{
+			fprintf(stderr, "Error loading %s: file not found or has no triangles\n", paths[i]);
+			return 2;
+		}
+
+		fprintf(stderr, "%s: %d triangles, %d vertices\n", paths[i], int(mesh.indices.size() / 3), int(mesh.vertices.size()));
+
+		Context ctx;
+		prepareContext(ctx, mesh);
+
+		for (size_t j = 0; j < sizeof(kBenchmarks) / sizeof(kBenchmarks[0]); ++j)
+		{
+			const Benchmark& bench = kBenchmarks[j];
+
+			if (filter && !strstr(bench.name, filter))
+				continue;
+
+			Result r = runBenchmark(ctx, bench, iterations);
+
+			fprintf(stderr, "\t%-32s min %8.3f ms, median %8.3f ms, p99 %8.3f ms, %9.2f %s, peak %d KB\n",
+			        r.name.c_str(), r.min, r.median, r.p99, r.throughput, r.unit.c_str(), int(r.peak / 1024));
+
+			results.push_back(r);
+		}
+
+		meshopt_destroySimplifierContext(ctx.simplifier);
+	}
+
+	FILE* file = output ? fopen(output, "w") : stdout;
+	if (!file)
+	{
+		fprintf(stderr, "Error saving %s\n", output);
+		return 2;
+	}
+
+	writeResults(file, results, iterations);
+
+	if (output)
+		fclose(file);
+
+	return 0;
+}